@@ -9,13 +9,20 @@
 // Arguments:
 // - cchRowWidth - the length of the default text attribute
 // - attr - the default text attribute
+// - attrStorage - the storage of the text buffer the row belongs to, which holds its attributes
 // Return Value:
 // - constructed object
-ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr) noexcept
+ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr, TextAttributeStorage& attrStorage) noexcept :
+    _attrStorage{ &attrStorage },
+    _hyperlinkRefCounts{ nullptr }
 {
     try
     {
-        _list.emplace_back(TextAttributeRun(cchRowWidth, attr));
+        _list.emplace_back(cchRowWidth, _attrStorage->Store(attr));
+        if (attr.IsHyperlink())
+        {
+            _hyperlinks.push_back(attr.GetHyperlinkId());
+        }
     }
     catch (...)
     {
@@ -24,6 +31,78 @@ ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr) noexcept
     _cchRowWidth = cchRowWidth;
 }
 
+ATTR_ROW::~ATTR_ROW()
+{
+    _ReleaseHyperlinks();
+}
+
+// Routine Description:
+// - copy constructor. The copy doesn't belong to any text buffer, so it
+//   holds no references to the hyperlinks it contains. It still refers to
+//   the attribute storage of the original, so it mustn't outlive it.
+ATTR_ROW::ATTR_ROW(const ATTR_ROW& other) :
+    _list{ other._list },
+    _cchRowWidth{ other._cchRowWidth },
+    _attrStorage{ other._attrStorage },
+    _hyperlinks{ other._hyperlinks },
+    _hyperlinkRefCounts{ nullptr }
+{
+}
+
+// Routine Description:
+// - copy assignment. This row keeps belonging to the text buffer it belonged to.
+//   If the other row belongs to another buffer, its attributes are stored in ours.
+ATTR_ROW& ATTR_ROW::operator=(const ATTR_ROW& other)
+{
+    if (other._attrStorage == _attrStorage)
+    {
+        _list = other._list;
+    }
+    else
+    {
+        decltype(_list) list;
+        list.reserve(other._list.size());
+        for (const auto& run : other._list)
+        {
+            list.emplace_back(run.GetLength(), _attrStorage->Store(other._attrStorage->Get(run.GetKey())));
+        }
+        _list.swap(list);
+    }
+    _cchRowWidth = other._cchRowWidth;
+    _UpdateHyperlinks({ _list.data(), _list.size() });
+    return *this;
+}
+
+// Routine Description:
+// - move constructor. The hyperlink references move along with the runs.
+ATTR_ROW::ATTR_ROW(ATTR_ROW&& other) noexcept :
+    _list{ std::move(other._list) },
+    _cchRowWidth{ other._cchRowWidth },
+    _attrStorage{ other._attrStorage },
+    _hyperlinks{ std::move(other._hyperlinks) },
+    _hyperlinkRefCounts{ std::exchange(other._hyperlinkRefCounts, nullptr) }
+{
+    other._hyperlinks.clear();
+}
+
+// Routine Description:
+// - move assignment. The hyperlink references and the attribute storage
+//   the runs refer to move along with the runs.
+ATTR_ROW& ATTR_ROW::operator=(ATTR_ROW&& other) noexcept
+{
+    if (this != &other)
+    {
+        _ReleaseHyperlinks();
+        _list = std::move(other._list);
+        _cchRowWidth = other._cchRowWidth;
+        _attrStorage = other._attrStorage;
+        _hyperlinks = std::move(other._hyperlinks);
+        _hyperlinkRefCounts = std::exchange(other._hyperlinkRefCounts, nullptr);
+        other._hyperlinks.clear();
+    }
+    return *this;
+}
+
 // Routine Description:
 // - Sets all properties of the ATTR_ROW to default values
 // Arguments:
@@ -31,7 +110,8 @@ ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr) noexcept
 void ATTR_ROW::Reset(const TextAttribute attr)
 {
     _list.clear();
-    _list.emplace_back(TextAttributeRun(_cchRowWidth, attr));
+    _list.emplace_back(_cchRowWidth, _attrStorage->Store(attr));
+    _UpdateHyperlinks({ _list.data(), _list.size() });
 }
 
 // Routine Description:
@@ -84,6 +164,9 @@ void ATTR_ROW::Resize(const size_t newWidth)
         // NOTE: Under some circumstances here, we have leftover run segments in memory or blank run segments
         // in memory. We're not going to waste time redimensioning the array in the heap. We're just noting that the useful
         // portions of it have changed.
+
+        // Some hyperlinks might have been cut off.
+        _UpdateHyperlinks({});
     }
 }
 
@@ -114,7 +197,7 @@ TextAttribute ATTR_ROW::GetAttrByColumn(const size_t column,
 {
     THROW_HR_IF(E_INVALIDARG, column >= _cchRowWidth);
     const auto runPos = FindAttrIndex(column, pApplies);
-    return _list.at(runPos).GetAttributes();
+    return _attrStorage->Get(_list.at(runPos).GetKey());
 }
 
 // Routine Description:
@@ -182,20 +265,153 @@ size_t ATTR_ROW::FindAttrIndex(const size_t index, size_t* const pApplies) const
 }
 
 // Routine Description:
-// - Finds the hyperlink IDs present in this row and returns them
+// - Returns the hyperlink IDs present in this row
 // Return value:
-// - The hyperlink IDs present in this row
-std::vector<uint16_t> ATTR_ROW::GetHyperlinks()
+// - The hyperlink IDs present in this row, each of them once
+std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
 {
-    std::vector<uint16_t> ids;
+    return { _hyperlinks.begin(), _hyperlinks.end() };
+}
+
+// Routine Description:
+// - Sets the reference counts this row maintains for the hyperlinks it contains.
+//   This row's hyperlinks are released from the previous counts, if any, and
+//   added to the new ones.
+// Arguments:
+// - refCounts - the reference counts of the text buffer this row belongs to,
+//               or nullptr if this row shouldn't reference its hyperlinks.
+void ATTR_ROW::SetHyperlinkRefCounts(HyperlinkRefCounts* const refCounts)
+{
+    if (refCounts)
+    {
+        _AddHyperlinks(*refCounts, _hyperlinks);
+    }
+    _ReleaseHyperlinks();
+    _hyperlinkRefCounts = refCounts;
+}
+
+// Routine Description:
+// - Marks the keys of the attributes this row uses, so that the attribute
+//   storage knows not to release them when it's collected.
+// Arguments:
+// - liveKeys - for each key handed out by the attribute storage, whether it is in use.
+void ATTR_ROW::MarkLiveAttributes(std::vector<bool>& liveKeys) const
+{
+    for (const auto& run : _list)
+    {
+        liveKeys.at(run.GetKey()) = true;
+    }
+}
+
+// Routine Description:
+// - Refreshes the list of hyperlinks in this row after the runs changed,
+//   adding and releasing references for the hyperlinks that came and went.
+// Arguments:
+// - newRuns - the runs that were written into the row. Runs that were only
+//   cut short or dropped don't need to be passed.
+void ATTR_ROW::_UpdateHyperlinks(const gsl::span<const TextAttributeKeyRun> newRuns)
+{
+    // A hyperlink can only have come in with the new runs and only have gone if
+    // there was one before. Most rows have none, and then there's nothing to do.
+    if (_hyperlinks.empty() && std::none_of(newRuns.begin(), newRuns.end(), [&](const auto& run) {
+            return _attrStorage->Get(run.GetKey()).IsHyperlink();
+        }))
+    {
+        return;
+    }
+
+    decltype(_hyperlinks) ids;
     for (const auto& run : _list)
     {
-        if (run.GetAttributes().IsHyperlink())
+        const auto& attr = _attrStorage->Get(run.GetKey());
+        if (attr.IsHyperlink())
         {
-            ids.emplace_back(run.GetAttributes().GetHyperlinkId());
+            ids.push_back(attr.GetHyperlinkId());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    if (ids == _hyperlinks)
+    {
+        return;
+    }
+
+    if (_hyperlinkRefCounts)
+    {
+        decltype(ids) added;
+        for (const auto id : ids)
+        {
+            if (!std::binary_search(_hyperlinks.begin(), _hyperlinks.end(), id))
+            {
+                added.push_back(id);
+            }
+        }
+        _AddHyperlinks(*_hyperlinkRefCounts, added);
+
+        for (const auto id : _hyperlinks)
+        {
+            if (!std::binary_search(ids.begin(), ids.end(), id))
+            {
+                _ReleaseHyperlink(*_hyperlinkRefCounts, id);
+            }
+        }
+    }
+    _hyperlinks.swap(ids);
+}
+
+// Routine Description:
+// - Adds a reference to each of the given hyperlinks. Either all of them are added,
+//   or, if adding one fails, none of them are, so that no reference is left behind
+//   that nothing is going to release.
+// Arguments:
+// - refCounts - the reference counts to add to
+// - ids - the hyperlink IDs to add a reference to
+void ATTR_ROW::_AddHyperlinks(HyperlinkRefCounts& refCounts, const gsl::span<const uint16_t> ids)
+{
+    size_t count = 0;
+    auto undo = wil::scope_exit([&]() noexcept {
+        for (size_t i = 0; i < count; ++i)
+        {
+            _ReleaseHyperlink(refCounts, til::at(ids, i));
+        }
+    });
+
+    for (const auto id : ids)
+    {
+        ++refCounts[id];
+        ++count;
+    }
+
+    undo.release();
+}
+
+// Routine Description:
+// - Drops a reference to the given hyperlink. Once no row refers to
+//   the hyperlink anymore, it's removed from the reference counts.
+// Arguments:
+// - refCounts - the reference counts to release the hyperlink from
+// - id - the hyperlink ID to release
+void ATTR_ROW::_ReleaseHyperlink(HyperlinkRefCounts& refCounts, const uint16_t id) noexcept
+{
+    const auto it = refCounts.find(id);
+    if (it != refCounts.end() && --it->second == 0)
+    {
+        refCounts.erase(it);
+    }
+}
+
+// Routine Description:
+// - Drops this row's references to all of its hyperlinks.
+void ATTR_ROW::_ReleaseHyperlinks() noexcept
+{
+    if (_hyperlinkRefCounts)
+    {
+        for (const auto id : _hyperlinks)
+        {
+            _ReleaseHyperlink(*_hyperlinkRefCounts, id);
         }
     }
-    return ids;
 }
 
 // Routine Description:
@@ -221,15 +437,79 @@ bool ATTR_ROW::SetAttrToEnd(const UINT iStart, const TextAttribute attr)
 // - replaceWith - the new value for the matching runs' attributes.
 // Return Value:
 // - <none>
-void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith) noexcept
+void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith)
 {
+    // If the attribute isn't stored, no run can be using it.
+    const auto toBeReplacedKey = _attrStorage->Find(toBeReplacedAttr);
+    if (!toBeReplacedKey)
+    {
+        return;
+    }
+
+    const auto replaceWithKey = _attrStorage->Store(replaceWith);
     for (auto& run : _list)
     {
-        if (run.GetAttributes() == toBeReplacedAttr)
+        if (run.GetKey() == *toBeReplacedKey)
+        {
+            run.SetKey(replaceWithKey);
+        }
+    }
+
+    const TextAttributeKeyRun replacement{ 1, replaceWithKey };
+    _UpdateHyperlinks({ &replacement, 1 });
+}
+
+// Routine Description:
+// - Copies the attributes of a span of columns from the given row into this one.
+//   The spans may overlap if the source is this row.
+// Arguments:
+// - source - the row to copy the attributes from. May be this row.
+// - sourceIndex - the first column to copy
+// - targetIndex - the column to copy the attribute of the first column to
+// - count - the number of columns to copy
+// Return Value:
+// - <none>
+// Note: will throw exception if either span is out of bounds
+void ATTR_ROW::CopyAttrs(const ATTR_ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    THROW_HR_IF(E_INVALIDARG, sourceIndex > source._cchRowWidth || count > source._cchRowWidth - sourceIndex);
+    THROW_HR_IF(E_INVALIDARG, targetIndex > _cchRowWidth || count > _cchRowWidth - targetIndex);
+
+    // Collect the runs covering the source columns before inserting any of them,
+    // since they may be overwritten when both spans are in this row.
+    boost::container::small_vector<TextAttributeKeyRun, 2> runs;
+    size_t applies = 0;
+    auto run = source._list.cbegin() + source.FindAttrIndex(sourceIndex, &applies);
+    auto remaining = count;
+    while (true)
+    {
+        const auto length = std::min(applies, remaining);
+
+        // Rows of the same text buffer share their storage, so the keys can be copied as they are.
+        auto key = run->GetKey();
+        if (source._attrStorage != _attrStorage)
+        {
+            key = _attrStorage->Store(source._attrStorage->Get(key));
+        }
+        runs.emplace_back(length, key);
+
+        remaining -= length;
+        if (remaining == 0)
         {
-            run.SetAttributes(replaceWith);
+            break;
         }
+
+        ++run;
+        applies = run->GetLength();
     }
+
+    THROW_IF_FAILED(_InsertAttrRuns({ runs.data(), runs.size() }, targetIndex, targetIndex + count - 1, _cchRowWidth));
+    _UpdateHyperlinks({ runs.data(), runs.size() });
 }
 
 // Routine Description:
@@ -250,6 +530,29 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                                                const size_t iStart,
                                                const size_t iEnd,
                                                const size_t cBufferWidth)
+try
+{
+    // Store the attributes up front, so that merging the runs below only has to compare their keys.
+    boost::container::small_vector<TextAttributeKeyRun, 2> newRuns;
+    newRuns.reserve(newAttrs.size());
+    for (const auto& run : newAttrs)
+    {
+        newRuns.emplace_back(run.GetLength(), _attrStorage->Store(run.GetAttributes()));
+    }
+
+    RETURN_IF_FAILED(_InsertAttrRuns({ newRuns.data(), newRuns.size() }, iStart, iEnd, cBufferWidth));
+    _UpdateHyperlinks({ newRuns.data(), newRuns.size() });
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Implements InsertAttrRuns for runs whose attributes have already been
+//   stored, without updating the hyperlink references.
+[[nodiscard]] HRESULT ATTR_ROW::_InsertAttrRuns(const gsl::span<const TextAttributeKeyRun> newAttrs,
+                                                const size_t iStart,
+                                                const size_t iEnd,
+                                                const size_t cBufferWidth)
 {
     // Definitions:
     // Existing Run = The run length encoded color array we're already storing in memory before this was called.
@@ -273,11 +576,11 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
     if (newAttrs.size() == 1)
     {
         // Get the new color attribute we're trying to apply
-        const TextAttribute NewAttr = til::at(newAttrs, 0).GetAttributes();
+        const auto NewAttr = til::at(newAttrs, 0).GetKey();
 
         // If the existing run was only 1 element...
         // ...and the new color is the same as the old, we don't have to do anything and can exit quick.
-        if (_list.size() == 1 && _list.at(0).GetAttributes() == NewAttr)
+        if (_list.size() == 1 && _list.at(0).GetKey() == NewAttr)
         {
             return S_OK;
         }
@@ -305,7 +608,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                     //
                     // 'B' is the new color and '^' represents where iStart is. We don't have to
                     // do anything.
-                    if (curr->GetAttributes() == NewAttr)
+                    if (curr->GetKey() == NewAttr)
                     {
                         return S_OK;
                     }
@@ -320,7 +623,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                     // Here 'D' is the new color.
                     if (curr->GetLength() == 1)
                     {
-                        curr->SetAttributes(NewAttr);
+                        curr->SetKey(NewAttr);
                         return S_OK;
                     }
 
@@ -336,7 +639,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                         // AAAAAABBBBBBCCC
                         //
                         // Here 'A' is the new color.
-                        if (NewAttr == prev->GetAttributes())
+                        if (NewAttr == prev->GetKey())
                         {
                             prev->IncrementLength();
                             curr->DecrementLength();
@@ -363,7 +666,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                         //
                         // Here 'B' is the new color.
                         const auto next = std::next(curr, 1);
-                        if (NewAttr == next->GetAttributes())
+                        if (NewAttr == next->GetKey())
                         {
                             curr->DecrementLength();
                             next->IncrementLength();
@@ -468,7 +771,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
         // Now we're still on that "last cell copied" into the new run.
         // If the color of that existing copied cell matches the color of the first segment
         // of the run we're about to insert, we can just increment the length to extend the coverage.
-        if (newRun.back().GetAttributes() == pInsertRunPos->GetAttributes())
+        if (newRun.back().GetKey() == pInsertRunPos->GetKey())
         {
             length += pInsertRunPos->GetLength();
 
@@ -523,7 +826,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
             // This case is slightly off from the example above. This case is for if the B2 above was actually Y2.
             // That Y2 from the existing run is the same color as the Y2 we just filled a few columns left in the final run
             // so we can just adjust the final run's column count instead of adding another segment here.
-            if (newRun.back().GetAttributes() == pExistingRunPos->GetAttributes())
+            if (newRun.back().GetKey() == pExistingRunPos->GetKey())
             {
                 size_t length = newRun.back().GetLength();
                 length += (iExistingRunCoverage - (iEnd + 1));
@@ -538,7 +841,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
                 newRun.emplace_back();
 
                 // Copy the existing run's color information to the new run
-                newRun.back().SetAttributes(pExistingRunPos->GetAttributes());
+                newRun.back().SetKey(pExistingRunPos->GetKey());
 
                 // Adjust the length of that copied color to cover only the reduced number of columns needed
                 // now that some have been replaced by the insert run.
@@ -560,7 +863,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
         // New Run desired when done = R3 -> B7
         // Existing run pointer is on B2.
         // We want to merge the 2 from the B2 into the B5 so we get B7.
-        else if (newRun.back().GetAttributes() == pExistingRunPos->GetAttributes())
+        else if (newRun.back().GetKey() == pExistingRunPos->GetKey())
         {
             // Add the value from the existing run into the current new run position.
             size_t length = newRun.back().GetLength();
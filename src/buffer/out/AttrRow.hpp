@@ -21,23 +21,27 @@ Revision History:
 #pragma once
 
 #include "TextAttributeRun.hpp"
+#include "TextAttributeStorage.hpp"
 #include "AttrRowIterator.hpp"
 
+// The number of rows that refer to each hyperlink ID.
+using HyperlinkRefCounts = std::unordered_map<uint16_t, size_t>;
+
 class ATTR_ROW final
 {
 public:
     using const_iterator = typename AttrRowIterator;
 
-    ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr)
+    ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr, TextAttributeStorage& attrStorage)
     noexcept;
 
-    ~ATTR_ROW() = default;
+    ~ATTR_ROW();
 
-    ATTR_ROW(const ATTR_ROW&) = default;
-    ATTR_ROW& operator=(const ATTR_ROW&) = default;
-    ATTR_ROW(ATTR_ROW&&)
-    noexcept = default;
-    ATTR_ROW& operator=(ATTR_ROW&&) noexcept = default;
+    ATTR_ROW(const ATTR_ROW& other);
+    ATTR_ROW& operator=(const ATTR_ROW& other);
+    ATTR_ROW(ATTR_ROW&& other)
+    noexcept;
+    ATTR_ROW& operator=(ATTR_ROW&& other) noexcept;
 
     TextAttribute GetAttrByColumn(const size_t column) const;
     TextAttribute GetAttrByColumn(const size_t column,
@@ -48,12 +52,16 @@ public:
     size_t FindAttrIndex(const size_t index,
                          size_t* const pApplies) const;
 
-    std::vector<uint16_t> GetHyperlinks();
+    std::vector<uint16_t> GetHyperlinks() const;
+    void SetHyperlinkRefCounts(HyperlinkRefCounts* const refCounts);
+
+    void MarkLiveAttributes(std::vector<bool>& liveKeys) const;
 
     bool SetAttrToEnd(const UINT iStart, const TextAttribute attr);
-    void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith) noexcept;
+    void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith);
 
     void Resize(const size_t newWidth);
+    void CopyAttrs(const ATTR_ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count);
 
     [[nodiscard]] HRESULT InsertAttrRuns(const gsl::span<const TextAttributeRun> newAttrs,
                                          const size_t iStart,
@@ -75,9 +83,27 @@ public:
 private:
     void Reset(const TextAttribute attr);
 
-    boost::container::small_vector<TextAttributeRun, 1> _list;
+    [[nodiscard]] HRESULT _InsertAttrRuns(const gsl::span<const TextAttributeKeyRun> newAttrs,
+                                          const size_t iStart,
+                                          const size_t iEnd,
+                                          const size_t cBufferWidth);
+
+    void _UpdateHyperlinks(const gsl::span<const TextAttributeKeyRun> newRuns);
+    static void _AddHyperlinks(HyperlinkRefCounts& refCounts, const gsl::span<const uint16_t> ids);
+    static void _ReleaseHyperlink(HyperlinkRefCounts& refCounts, const uint16_t id) noexcept;
+    void _ReleaseHyperlinks() noexcept;
+
+    boost::container::small_vector<TextAttributeKeyRun, 1> _list;
     size_t _cchRowWidth;
 
+    // The storage of the text buffer this row belongs to, which the keys in _list refer to.
+    TextAttributeStorage* _attrStorage;
+
+    // The sorted, unique hyperlink IDs used by the runs in _list. If the row
+    // belongs to a text buffer, each of them holds a reference in its counts.
+    boost::container::small_vector<uint16_t, 2> _hyperlinks;
+    HyperlinkRefCounts* _hyperlinkRefCounts;
+
 #ifdef UNIT_TESTING
     friend class AttrRowTests;
     friend class CommonState;
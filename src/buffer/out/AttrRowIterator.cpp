@@ -64,13 +64,13 @@ AttrRowIterator& AttrRowIterator::operator-=(const ptrdiff_t& movement)
 const TextAttribute* AttrRowIterator::operator->() const
 {
     THROW_HR_IF(E_BOUNDS, _exceeded);
-    return &_run->GetAttributes();
+    return &_pAttrRow->_attrStorage->Get(_run->GetKey());
 }
 
 const TextAttribute& AttrRowIterator::operator*() const
 {
     THROW_HR_IF(E_BOUNDS, _exceeded);
-    return _run->GetAttributes();
+    return _pAttrRow->_attrStorage->Get(_run->GetKey());
 }
 
 // Routine Description:
@@ -69,9 +69,9 @@ public:
     const TextAttribute& operator*() const;
 
 private:
-    boost::container::small_vector_base<TextAttributeRun>::const_iterator _run;
+    boost::container::small_vector_base<TextAttributeKeyRun>::const_iterator _run;
     const ATTR_ROW* _pAttrRow;
-    size_t _currentAttributeIndex; // index of TextAttribute within the current TextAttributeRun
+    size_t _currentAttributeIndex; // index of TextAttribute within the current TextAttributeKeyRun
     bool _exceeded;
 
     void _increment(size_t count) noexcept;
@@ -10,19 +10,15 @@
 // Routine Description:
 // - constructor
 // Arguments:
-// - rowWidth - the size (in wchar_t) of the char and attribute rows
+// - buffer - the cells of this row, owned by the parent's TextBuffer
 // - pParent - the parent ROW
 // Return Value:
 // - instantiated object
-// Note: will through if unable to allocate char/attribute buffers
-#pragma warning(push)
-#pragma warning(disable : 26447) // small_vector's constructor says it can throw but it should not given how we use it.  This suppresses this error for the AuditMode build.
-CharRow::CharRow(size_t rowWidth, ROW* const pParent) noexcept :
-    _data(rowWidth, value_type()),
+CharRow::CharRow(gsl::span<value_type> buffer, ROW* const pParent) noexcept :
+    _data{ buffer },
     _pParent{ FAIL_FAST_IF_NULL(pParent) }
 {
 }
-#pragma warning(pop)
 
 // Routine Description:
 // - gets the size of the row, in glyph cells
@@ -50,41 +46,90 @@ void CharRow::Reset() noexcept
 }
 
 // Routine Description:
-// - resizes the width of the CharRowBase
+// - moves the row onto a new piece of cell storage, which may be of a different width.
+//   Cells that fit into the new storage are copied over, any additional ones are reset.
+// Arguments:
+// - newBuffer - the new cells of this row
+// Return Value:
+// - <none>
+void CharRow::Resize(gsl::span<value_type> newBuffer) noexcept
+{
+    const auto copied = std::min(_data.size(), newBuffer.size());
+    const auto newEnd = std::copy_n(cbegin(), copied, newBuffer.begin());
+    std::fill(newEnd, newBuffer.end(), value_type{});
+    _data = newBuffer;
+}
+
+// Routine Description:
+// - copies a span of cells from the given row into this one in a single block move.
+//   The spans may overlap if the source is this row.
 // Arguments:
-// - newSize - the new width of the character and attributes rows
+// - source - the row to copy the cells from. May be this row.
+// - sourceIndex - the column of the first cell to copy
+// - targetIndex - the column to copy the first cell to
+// - count - the number of cells to copy
 // Return Value:
-// - S_OK on success, otherwise relevant error code
-[[nodiscard]] HRESULT CharRow::Resize(const size_t newSize) noexcept
+// - <none>
+// Note: will throw exception if either span is out of bounds
+void CharRow::CopyCells(const CharRow& source, const size_t sourceIndex, const size_t targetIndex, const size_t count)
 {
-    try
+    THROW_HR_IF(E_INVALIDARG, sourceIndex > source.size() || count > source.size() - sourceIndex);
+    THROW_HR_IF(E_INVALIDARG, targetIndex > size() || count > size() - targetIndex);
+
+    const auto sourceCells = source._data.subspan(sourceIndex, count);
+    const auto targetCells = _data.subspan(targetIndex, count);
+
+    // Copy in the direction that reads every cell before it gets overwritten.
+    if (targetCells.data() <= sourceCells.data())
     {
-        const value_type insertVals;
-        _data.resize(newSize, insertVals);
+        std::copy(sourceCells.begin(), sourceCells.end(), targetCells.begin());
+    }
+    else
+    {
+        std::copy_backward(sourceCells.begin(), sourceCells.end(), targetCells.end());
     }
-    CATCH_RETURN();
-
-    return S_OK;
 }
 
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. _data is a span, so the arithmetic stays within its bounds.
 typename CharRow::iterator CharRow::begin() noexcept
 {
-    return _data.begin();
+    return _data.data();
 }
 
 typename CharRow::const_iterator CharRow::cbegin() const noexcept
 {
-    return _data.cbegin();
+    return _data.data();
 }
 
 typename CharRow::iterator CharRow::end() noexcept
 {
-    return _data.end();
+    return _data.data() + _data.size();
 }
 
 typename CharRow::const_iterator CharRow::cend() const noexcept
 {
-    return _data.cend();
+    return _data.data() + _data.size();
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - gets the cell at the specified column
+// Arguments:
+// - column - the column to get the cell for
+// Return Value:
+// - the cell
+// Note: will throw exception if column is out of bounds
+typename CharRow::value_type& CharRow::_CellAt(const size_t column)
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    return gsl::at(_data, column);
+}
+
+const typename CharRow::value_type& CharRow::_CellAt(const size_t column) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    return gsl::at(_data, column);
 }
 
 // Routine Description:
@@ -95,12 +140,12 @@ typename CharRow::const_iterator CharRow::cend() const noexcept
 // - The calculated left boundary of the internal string.
 size_t CharRow::MeasureLeft() const noexcept
 {
-    const_iterator it = _data.cbegin();
-    while (it != _data.cend() && it->IsSpace())
+    const_iterator it = cbegin();
+    while (it != cend() && it->IsSpace())
     {
         ++it;
     }
-    return it - _data.cbegin();
+    return it - cbegin();
 }
 
 // Routine Description:
@@ -111,17 +156,18 @@ size_t CharRow::MeasureLeft() const noexcept
 // - The calculated right boundary of the internal string.
 size_t CharRow::MeasureRight() const
 {
-    const_reverse_iterator it = _data.crbegin();
-    while (it != _data.crend() && it->IsSpace())
+    const auto rend = const_reverse_iterator{ cbegin() };
+    auto it = const_reverse_iterator{ cend() };
+    while (it != rend && it->IsSpace())
     {
         ++it;
     }
-    return _data.crend() - it;
+    return rend - it;
 }
 
 void CharRow::ClearCell(const size_t column)
 {
-    _data.at(column).Reset();
+    _CellAt(column).Reset();
 }
 
 // Routine Description:
@@ -151,7 +197,7 @@ bool CharRow::ContainsText() const noexcept
 // Note: will throw exception if column is out of bounds
 const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 {
-    return _data.at(column).DbcsAttr();
+    return _CellAt(column).DbcsAttr();
 }
 
 // Routine Description:
@@ -163,7 +209,7 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 // Note: will throw exception if column is out of bounds
 DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 {
-    return _data.at(column).DbcsAttr();
+    return _CellAt(column).DbcsAttr();
 }
 
 // Routine Description:
@@ -175,7 +221,7 @@ DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const size_t column)
 {
-    _data.at(column).EraseChars();
+    _CellAt(column).EraseChars();
 }
 
 // Routine Description:
@@ -260,17 +306,6 @@ const UnicodeStorage& CharRow::GetUnicodeStorage() const noexcept
     return _pParent->GetUnicodeStorage();
 }
 
-// Routine Description:
-// - calculates the key used by the given column of the char row to store glyph data in UnicodeStorage
-// Arguments:
-// - column - the column to generate the key for
-// Return Value:
-// - the COORD key for data access from UnicodeStorage for the column
-COORD CharRow::GetStorageKey(const size_t column) const noexcept
-{
-    return { gsl::narrow<SHORT>(column), _pParent->GetId() };
-}
-
 // Routine Description:
 // - Updates the pointer to the parent row (which might change if we shuffle the rows around)
 // Arguments:
@@ -49,15 +49,16 @@ class CharRow final
 public:
     using glyph_type = typename wchar_t;
     using value_type = typename CharRowCell;
-    using iterator = typename boost::container::small_vector_base<value_type>::iterator;
-    using const_iterator = typename boost::container::small_vector_base<value_type>::const_iterator;
-    using const_reverse_iterator = typename boost::container::small_vector_base<value_type>::const_reverse_iterator;
+    using iterator = typename value_type*;
+    using const_iterator = typename const value_type*;
+    using const_reverse_iterator = typename std::reverse_iterator<const_iterator>;
     using reference = typename CharRowCellReference;
 
-    CharRow(size_t rowWidth, ROW* const pParent) noexcept;
+    CharRow(gsl::span<value_type> buffer, ROW* const pParent) noexcept;
 
     size_t size() const noexcept;
-    [[nodiscard]] HRESULT Resize(const size_t newSize) noexcept;
+    void Resize(gsl::span<value_type> newBuffer) noexcept;
+    void CopyCells(const CharRow& source, const size_t sourceIndex, const size_t targetIndex, const size_t count);
     size_t MeasureLeft() const noexcept;
     size_t MeasureRight() const;
     bool ContainsText() const noexcept;
@@ -82,7 +83,6 @@ public:
 
     UnicodeStorage& GetUnicodeStorage() noexcept;
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    COORD GetStorageKey(const size_t column) const noexcept;
 
     void UpdateParent(ROW* const pParent);
 
@@ -94,9 +94,13 @@ private:
     void ClearCell(const size_t column);
     std::wstring GetText() const;
 
+    value_type& _CellAt(const size_t column);
+    const value_type& _CellAt(const size_t column) const;
+
 protected:
-    // storage for glyph data and dbcs attributes
-    boost::container::small_vector<value_type, 120> _data;
+    // glyph data and dbcs attributes. This is a view into the cell slab
+    // owned by the TextBuffer, which holds the cells of all of its rows.
+    gsl::span<value_type> _data;
 
     // ROW that this CharRow belongs to
     ROW* _pParent;
@@ -17,13 +17,18 @@ void CharRowCellReference::operator=(const std::wstring_view chars)
         _cellData().Char() = chars.front();
         _cellData().DbcsAttr().SetGlyphStored(false);
     }
-    else
+    else if (const auto key = _parent.GetUnicodeStorage().StoreGlyph(chars))
     {
-        auto& storage = _parent.GetUnicodeStorage();
-        const auto key = _parent.GetStorageKey(_index);
-        storage.StoreGlyph(key, { chars.cbegin(), chars.cend() });
+        // The cell holds the key to the glyph instead of a character.
+        _cellData().Char() = *key;
         _cellData().DbcsAttr().SetGlyphStored(true);
     }
+    else
+    {
+        // The storage ran out of keys. Show a replacement character instead.
+        _cellData().Char() = UNICODE_REPLACEMENT;
+        _cellData().DbcsAttr().SetGlyphStored(false);
+    }
 }
 
 // Routine Description:
@@ -41,7 +46,7 @@ CharRowCellReference::operator std::wstring_view() const
 // - ref to the CharRowCell
 CharRowCell& CharRowCellReference::_cellData()
 {
-    return _parent._data.at(_index);
+    return _parent._CellAt(_index);
 }
 
 // Routine Description:
@@ -50,7 +55,7 @@ CharRowCell& CharRowCellReference::_cellData()
 // - ref to the CharRowCell
 const CharRowCell& CharRowCellReference::_cellData() const
 {
-    return _parent._data.at(_index);
+    return _parent._CellAt(_index);
 }
 
 // Routine Description:
@@ -61,7 +66,7 @@ std::wstring_view CharRowCellReference::_glyphData() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        const auto& text = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
+        const auto& text = _parent.GetUnicodeStorage().GetText(_cellData().Char());
 
         return { text.data(), text.size() };
     }
@@ -79,7 +84,7 @@ CharRowCellReference::const_iterator CharRowCellReference::begin() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        return _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index)).data();
+        return _parent.GetUnicodeStorage().GetText(_cellData().Char()).data();
     }
     else
     {
@@ -98,7 +103,7 @@ CharRowCellReference::const_iterator CharRowCellReference::end() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        const auto& chars = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
+        const auto& chars = _parent.GetUnicodeStorage().GetText(_cellData().Char());
         return chars.data() + chars.size();
     }
     else
@@ -125,8 +130,8 @@ bool operator==(const CharRowCellReference& ref, const std::vector<wchar_t>& gly
     }
     else
     {
-        const auto& chars = ref._parent.GetUnicodeStorage().GetText(ref._parent.GetStorageKey(ref._index));
-        return chars == glyph;
+        const auto& chars = ref._parent.GetUnicodeStorage().GetText(ref._cellData().Char());
+        return std::wstring_view{ chars } == std::wstring_view{ glyph.data(), glyph.size() };
     }
 }
 
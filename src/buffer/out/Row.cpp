@@ -7,20 +7,24 @@
 #include "textBuffer.hpp"
 #include "../types/inc/convert.hpp"
 
+// The last generation handed out to a row. 0 is never used as a generation.
+static std::atomic<uint64_t> s_lastGeneration{ 0 };
+
 // Routine Description:
 // - constructor
 // Arguments:
 // - rowId - the row index in the text buffer
-// - rowWidth - the width of the row, cell elements
+// - charBuffer - the cells of this row, within the text buffer's cell storage. Determines the width of the row.
 // - fillAttribute - the default text attribute
 // - pParent - the text buffer that this row belongs to
 // Return Value:
 // - constructed object
-ROW::ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent) noexcept :
+ROW::ROW(const SHORT rowId, gsl::span<CharRowCell> charBuffer, const TextAttribute fillAttribute, TextBuffer* const pParent) noexcept :
     _id{ rowId },
-    _rowWidth{ rowWidth },
-    _charRow{ rowWidth, this },
-    _attrRow{ rowWidth, fillAttribute },
+    _rowWidth{ gsl::narrow_cast<unsigned short>(charBuffer.size()) },
+    _charRow{ charBuffer, this },
+    _attrRow{ gsl::narrow_cast<UINT>(charBuffer.size()), fillAttribute, pParent->GetAttributeStorage() },
+    _generation{ s_lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1 },
     _lineRendition{ LineRendition::SingleWidth },
     _wrapForced{ false },
     _doubleBytePadded{ false },
@@ -36,6 +40,7 @@ ROW::ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute f
 // - <none>
 bool ROW::Reset(const TextAttribute Attr)
 {
+    _NewGeneration();
     _lineRendition = LineRendition::SingleWidth;
     _wrapForced = false;
     _doubleBytePadded = false;
@@ -54,22 +59,19 @@ bool ROW::Reset(const TextAttribute Attr)
 
 // Routine Description:
 // - resizes ROW to new width
+// - Resizing the attributes is the only part of it that can fail, so it's left to the caller.
+//   That way a text buffer can resize the attributes of all of its rows before it moves any of them.
 // Arguments:
-// - width - the new width, in cells
+// - charBuffer - the new cells of this row, within the text buffer's cell storage. Determines the new width.
+// - attrRow - the attributes of this row, already resized to the new width
 // Return Value:
-// - S_OK if successful, otherwise relevant error
-[[nodiscard]] HRESULT ROW::Resize(const unsigned short width)
+// - <none>
+void ROW::Resize(gsl::span<CharRowCell> charBuffer, ATTR_ROW&& attrRow) noexcept
 {
-    RETURN_IF_FAILED(_charRow.Resize(width));
-    try
-    {
-        _attrRow.Resize(width);
-    }
-    CATCH_RETURN();
-
-    _rowWidth = width;
-
-    return S_OK;
+    _NewGeneration();
+    _attrRow = std::move(attrRow);
+    _charRow.Resize(charBuffer);
+    _rowWidth = gsl::narrow_cast<unsigned short>(charBuffer.size());
 }
 
 // Routine Description:
@@ -81,9 +83,23 @@ bool ROW::Reset(const TextAttribute Attr)
 void ROW::ClearColumn(const size_t column)
 {
     THROW_HR_IF(E_INVALIDARG, column >= _charRow.size());
+    _NewGeneration();
     _charRow.ClearCell(column);
 }
 
+// Routine Description:
+// - marks the contents of the row as changed, by giving it a generation no other row has had before.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void ROW::_NewGeneration() noexcept
+{
+    // Rows are only ever modified under the lock of their text buffer, but
+    // there may be several buffers being written to on different threads.
+    _generation = s_lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 UnicodeStorage& ROW::GetUnicodeStorage() noexcept
 {
     return _pParent->GetUnicodeStorage();
@@ -107,6 +123,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 {
     THROW_HR_IF(E_INVALIDARG, index >= _charRow.size());
     THROW_HR_IF(E_INVALIDARG, limitRight.value_or(0) >= _charRow.size());
+    _NewGeneration();
     size_t currentIndex = index;
 
     // If we're given a right-side column limit, use it. Otherwise, the write limit is the final column index available in the char row.
@@ -208,3 +225,39 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - copies a span of cells, with their text and attributes, from the given row into this one.
+//   This is a block move, so the spans may overlap if the source is this row.
+// Arguments:
+// - source - the row to copy the cells from. May be this row.
+// - sourceIndex - the column of the first cell to copy
+// - targetIndex - the column to copy the first cell to
+// - count - the number of cells to copy
+// Return Value:
+// - <none>
+// Note: will throw exception if either span is out of bounds
+void ROW::CopyCells(const ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    _NewGeneration();
+    _charRow.CopyCells(source._charRow, sourceIndex, targetIndex, count);
+    _attrRow.CopyAttrs(source._attrRow, sourceIndex, targetIndex, count);
+
+    // Just like WriteCells, don't leave half of a double-width character hanging off either edge of the row.
+    if (targetIndex == 0 && _charRow.DbcsAttrAt(0).IsTrailing())
+    {
+        _charRow.ClearCell(0);
+    }
+
+    const auto lastColumn = _charRow.size() - 1;
+    if (targetIndex + count - 1 == lastColumn && _charRow.DbcsAttrAt(lastColumn).IsLeading())
+    {
+        _charRow.ClearCell(lastColumn);
+        SetDoubleBytePadded(true);
+    }
+}
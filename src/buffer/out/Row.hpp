@@ -32,7 +32,7 @@ class TextBuffer;
 class ROW final
 {
 public:
-    ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent)
+    ROW(const SHORT rowId, gsl::span<CharRowCell> charBuffer, const TextAttribute fillAttribute, TextBuffer* const pParent)
     noexcept;
 
     size_t size() const noexcept { return _rowWidth; }
@@ -43,11 +43,22 @@ public:
     void SetDoubleBytePadded(const bool doubleBytePadded) noexcept { _doubleBytePadded = doubleBytePadded; }
     bool WasDoubleBytePadded() const noexcept { return _doubleBytePadded; }
 
+    // Handing out mutable access to the text or the attributes counts as a change to the row.
     const CharRow& GetCharRow() const noexcept { return _charRow; }
-    CharRow& GetCharRow() noexcept { return _charRow; }
+    CharRow& GetCharRow() noexcept
+    {
+        _NewGeneration();
+        return _charRow;
+    }
 
     const ATTR_ROW& GetAttrRow() const noexcept { return _attrRow; }
-    ATTR_ROW& GetAttrRow() noexcept { return _attrRow; }
+    ATTR_ROW& GetAttrRow() noexcept
+    {
+        _NewGeneration();
+        return _attrRow;
+    }
+
+    uint64_t GetGeneration() const noexcept { return _generation; }
 
     LineRendition GetLineRendition() const noexcept { return _lineRendition; }
     void SetLineRendition(const LineRendition lineRendition) noexcept { _lineRendition = lineRendition; }
@@ -56,7 +67,7 @@ public:
     void SetId(const SHORT id) noexcept { _id = id; }
 
     bool Reset(const TextAttribute Attr);
-    [[nodiscard]] HRESULT Resize(const unsigned short width);
+    void Resize(gsl::span<CharRowCell> charBuffer, ATTR_ROW&& attrRow) noexcept;
 
     void ClearColumn(const size_t column);
     std::wstring GetText() const { return _charRow.GetText(); }
@@ -65,6 +76,7 @@ public:
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
 
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap = std::nullopt, std::optional<size_t> limitRight = std::nullopt);
+    void CopyCells(const ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count);
 
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
@@ -72,8 +84,15 @@ public:
 #endif
 
 private:
+    void _NewGeneration() noexcept;
+
     CharRow _charRow;
     ATTR_ROW _attrRow;
+    // Changes whenever the text or the attributes of the row may have changed. Generations are
+    // unique across all rows, so consumers like the renderer can use them to tell whether
+    // anything they derived from a row is still up to date. A copy keeps the generation of
+    // its original, since they hold the same contents until either of them changes.
+    uint64_t _generation;
     LineRendition _lineRendition;
     SHORT _id;
     unsigned short _rowWidth;
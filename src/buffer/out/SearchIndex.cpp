@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "SearchIndex.hpp"
+
+#include "Row.hpp"
+
+SearchIndex::SearchIndex() noexcept :
+    _mutex{},
+    _rows{},
+    _use{ 0 }
+{
+}
+
+// Routine Description:
+// - locks the index for a search. GetRow() and Trim() may only be called while holding the lock,
+//   and the text GetRow() returns may only be used while holding it.
+// Return Value:
+// - the lock on the index
+[[nodiscard]] std::unique_lock<std::mutex> SearchIndex::Lock()
+{
+    return std::unique_lock{ _mutex };
+}
+
+// Routine Description:
+// - the text of the row, one glyph per cell
+std::wstring_view SearchIndex::RowText::Text() const noexcept
+{
+    return _text;
+}
+
+// Routine Description:
+// - finds where the given cell starts within the text of the row
+// Arguments:
+// - column - the cell to look up. The width of the row yields the length of the text.
+// Return Value:
+// - the offset of the cell within Text()
+size_t SearchIndex::RowText::CellOffset(const size_t column) const noexcept
+{
+    return _cellOffsets.empty() ? column : til::at(_cellOffsets, column);
+}
+
+// Routine Description:
+// - fetches the text of the given row, flattening it only if it changed since it was last fetched
+// Arguments:
+// - row - the row to fetch the text of
+// Return Value:
+// - the text of the row. It remains valid until the next call to Trim().
+const SearchIndex::RowText& SearchIndex::GetRow(const ROW& row)
+{
+    auto& rowText = _rows[row.GetGeneration()];
+    if (rowText._lastUse == 0)
+    {
+        auto removeRow = wil::scope_exit([&]() noexcept { _rows.erase(row.GetGeneration()); });
+
+        const auto& charRow = row.GetCharRow();
+        auto aligned = true;
+        rowText._text.reserve(row.size());
+        for (size_t x = 0; x < row.size(); ++x)
+        {
+            const std::wstring_view glyph = charRow.GlyphAt(x);
+            if (aligned && glyph.size() != 1)
+            {
+                // The text doesn't line up with the cells anymore from here on.
+                aligned = false;
+                rowText._cellOffsets.reserve(row.size() + 1);
+                for (size_t i = 0; i < x; ++i)
+                {
+                    rowText._cellOffsets.push_back(i);
+                }
+            }
+            if (!aligned)
+            {
+                rowText._cellOffsets.push_back(rowText._text.size());
+            }
+            rowText._text.append(glyph);
+        }
+        if (!aligned)
+        {
+            rowText._cellOffsets.push_back(rowText._text.size());
+        }
+
+        removeRow.release();
+    }
+
+    rowText._lastUse = _use + 1;
+    return rowText;
+}
+
+// Routine Description:
+// - releases the text of the rows that weren't fetched since the last call.
+// - Searches call this once they're done, so that the index holds no more than
+//   the rows the last search looked at.
+void SearchIndex::Trim() noexcept
+{
+    ++_use;
+    for (auto it = _rows.begin(); it != _rows.end();)
+    {
+        if (it->second._lastUse == _use)
+        {
+            ++it;
+        }
+        else
+        {
+            it = _rows.erase(it);
+        }
+    }
+}
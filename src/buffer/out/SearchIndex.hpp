@@ -0,0 +1,58 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SearchIndex.hpp
+
+Abstract:
+- the text of the rows of a text buffer, flattened the way Search scans it
+- rows are keyed by their generation, which stays with a row while the buffer circles
+  or scrolls and changes whenever the row is written to. A search thus only has to
+  flatten the rows that changed since the previous one.
+- rows no search looked at since the last Trim() are released by it.
+- the index is shared by every search of a terminal, which may run on different
+  threads under a shared console lock (e.g. UIA and the search box). Searches
+  hold Lock() while they use it.
+--*/
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class ROW;
+
+class SearchIndex final
+{
+public:
+    class RowText final
+    {
+    public:
+        std::wstring_view Text() const noexcept;
+        size_t CellOffset(const size_t column) const noexcept;
+
+    private:
+        // One glyph per cell. Wide glyphs are repeated for both of their cells.
+        std::wstring _text;
+        // Where each cell starts within _text, plus the length of _text at the end.
+        // Empty if every cell of the row holds a single character.
+        std::vector<size_t> _cellOffsets;
+        uint64_t _lastUse = 0;
+
+        friend class SearchIndex;
+    };
+
+    SearchIndex() noexcept;
+
+    [[nodiscard]] std::unique_lock<std::mutex> Lock();
+
+    const RowText& GetRow(const ROW& row);
+    void Trim() noexcept;
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<uint64_t, RowText> _rows;
+    uint64_t _use;
+};
@@ -90,6 +90,7 @@ public:
     friend constexpr bool operator!=(const TextAttribute& attr, const WORD& legacyAttr) noexcept;
     friend constexpr bool operator==(const WORD& legacyAttr, const TextAttribute& attr) noexcept;
     friend constexpr bool operator!=(const WORD& legacyAttr, const TextAttribute& attr) noexcept;
+    friend struct std::hash<TextAttribute>;
 
     bool IsLegacy() const noexcept;
     bool IsBold() const noexcept;
@@ -219,6 +220,38 @@ constexpr bool operator!=(const TextAttribute& a, const TextAttribute& b) noexce
     return !(a == b);
 }
 
+namespace std
+{
+    template<>
+    struct hash<TextAttribute>
+    {
+        // Routine Description:
+        // - hashes a TextAttribute by folding all of its members into a size_t, FNV-1a style.
+        // Arguments:
+        // - attr - the attribute to hash
+        // Return Value:
+        // - the hashed attribute
+        size_t operator()(const TextAttribute& attr) const noexcept
+        {
+            const hash<TextColor> hashColor;
+            const size_t values[] = {
+                attr._wAttrLegacy,
+                hashColor(attr._foreground),
+                hashColor(attr._background),
+                static_cast<BYTE>(attr._extendedAttrs),
+                attr._hyperlinkId,
+            };
+
+            size_t result = 2166136261u;
+            for (const auto value : values)
+            {
+                result = (result ^ value) * 16777619u;
+            }
+            return result;
+        }
+    };
+}
+
 #ifdef UNIT_TESTING
 
 #define LOG_ATTR(attr) (Log::Comment(NoThrowString().Format( \
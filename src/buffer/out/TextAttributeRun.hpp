@@ -48,3 +48,29 @@ private:
     friend class AttrRowTests;
 #endif
 };
+
+// The form in which an ATTR_ROW stores its runs: the attribute itself lives
+// in the TextAttributeStorage of the text buffer and the run only holds its key.
+// Rows are never wider than SHORT_MAX, so the length fits in 16 bits.
+class TextAttributeKeyRun final
+{
+public:
+    TextAttributeKeyRun() = default;
+    TextAttributeKeyRun(const size_t cchLength, const uint32_t key) noexcept :
+        _cchLength(gsl::narrow<uint16_t>(cchLength)),
+        _key(key)
+    {
+    }
+
+    size_t GetLength() const noexcept { return _cchLength; }
+    void SetLength(const size_t cchLength) noexcept { _cchLength = gsl::narrow<uint16_t>(cchLength); }
+    void IncrementLength() noexcept { _cchLength++; }
+    void DecrementLength() noexcept { _cchLength--; }
+
+    uint32_t GetKey() const noexcept { return _key; }
+    void SetKey(const uint32_t key) noexcept { _key = key; }
+
+private:
+    uint16_t _cchLength{ 0 };
+    uint32_t _key{ 0 };
+};
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeStorage.hpp"
+
+// The number of attributes we let accumulate before the first collection.
+static constexpr size_t MinimumCollectionThreshold = 1024;
+
+TextAttributeStorage::TextAttributeStorage() :
+    _attrs{},
+    _keys{},
+    _freeKeys{},
+    _collectionThreshold{ MinimumCollectionThreshold }
+{
+    _attrs.emplace_back();
+    _keys.emplace(_attrs.back(), DefaultKey);
+}
+
+// Routine Description:
+// - fetches the attribute associated with key
+// Arguments:
+// - key - a key previously returned by Store(), which hasn't been collected since
+// Return Value:
+// - the attribute associated with key
+const TextAttribute& TextAttributeStorage::Get(const key_type key) const noexcept
+{
+    return til::at(_attrs, key);
+}
+
+// Routine Description:
+// - stores an attribute, unless the same attribute has already been stored before.
+// Arguments:
+// - attr - the attribute to store
+// Return Value:
+// - the key the attribute can be retrieved with.
+TextAttributeStorage::key_type TextAttributeStorage::Store(const TextAttribute& attr)
+{
+    if (const auto it = _keys.find(attr); it != _keys.end())
+    {
+        return it->second;
+    }
+
+    key_type key;
+    if (!_freeKeys.empty())
+    {
+        key = _freeKeys.back();
+        _attrs.at(key) = attr;
+        _freeKeys.pop_back();
+    }
+    else
+    {
+        key = gsl::narrow<key_type>(_attrs.size());
+        _attrs.emplace_back(attr);
+    }
+
+    _keys.emplace(attr, key);
+    return key;
+}
+
+// Routine Description:
+// - looks up the key of an attribute, without storing it.
+// Arguments:
+// - attr - the attribute to look for
+// Return Value:
+// - the key of the attribute, or nullopt if it isn't stored.
+std::optional<TextAttributeStorage::key_type> TextAttributeStorage::Find(const TextAttribute& attr) const
+{
+    if (const auto it = _keys.find(attr); it != _keys.end())
+    {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+// Routine Description:
+// - gets the number of attributes currently stored
+size_t TextAttributeStorage::size() const noexcept
+{
+    return _attrs.size() - _freeKeys.size();
+}
+
+// Routine Description:
+// - gets the number of keys handed out so far, used or not. All keys are smaller than this.
+size_t TextAttributeStorage::capacity() const noexcept
+{
+    return _attrs.size();
+}
+
+// Routine Description:
+// - checks whether enough attributes have been added since the last collection to warrant another one.
+// Return Value:
+// - true if the owner should call Collect().
+bool TextAttributeStorage::NeedsCollection() const noexcept
+{
+    return size() >= _collectionThreshold;
+}
+
+// Routine Description:
+// - releases every attribute that isn't in use anymore. The default attributes are always kept.
+// - The next collection is scheduled for when the number of stored attributes
+//   has doubled, so the cost of collecting stays proportional to the
+//   number of attributes stored. That holds even if this collection freed
+//   nothing: a buffer full of distinct attributes isn't walked again on every write.
+// Arguments:
+// - liveKeys - for each key, whether it is still referred to by the buffer.
+void TextAttributeStorage::Collect(const std::vector<bool>& liveKeys)
+{
+    // Freed keys are reused last in, first out. Collecting from the top down
+    // hands out the smallest keys first, which keeps the storage compact.
+    _freeKeys.clear();
+    for (auto key = _attrs.size(); key-- > DefaultKey + 1;)
+    {
+        if (key < liveKeys.size() && liveKeys.at(key))
+        {
+            continue;
+        }
+
+        // A free slot may still hold an attribute that has been stored again under another key since.
+        const auto it = _keys.find(til::at(_attrs, key));
+        if (it != _keys.end() && it->second == key)
+        {
+            _keys.erase(it);
+        }
+
+        // Unused keys at the end can be dropped altogether.
+        if (key == _attrs.size() - 1)
+        {
+            _attrs.pop_back();
+        }
+        else
+        {
+            _freeKeys.push_back(gsl::narrow_cast<key_type>(key));
+        }
+    }
+
+    _collectionThreshold = std::max(size() * 2, MinimumCollectionThreshold);
+}
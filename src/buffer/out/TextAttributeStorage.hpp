@@ -0,0 +1,59 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeStorage.hpp
+
+Abstract:
+- storage for the text attributes used by the rows of a text buffer
+- attributes are interned: each distinct attribute is stored once and is referred to by
+  a 32-bit key, which the runs of an ATTR_ROW hold in place of the attribute itself.
+  This keeps the runs small and lets them be compared with a single integer compare.
+  Keys are wide enough for every cell of the largest buffer to have its own attribute,
+  so storing an attribute never fails.
+- unused attributes are only released by Collect(), given the set of keys still in use.
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+class TextAttributeStorage final
+{
+public:
+    using key_type = uint32_t;
+
+    // The key of the default attributes, which are always stored.
+    static constexpr key_type DefaultKey = 0;
+
+    TextAttributeStorage();
+
+    const TextAttribute& Get(const key_type key) const noexcept;
+
+    key_type Store(const TextAttribute& attr);
+    std::optional<key_type> Find(const TextAttribute& attr) const;
+
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
+
+    bool NeedsCollection() const noexcept;
+    void Collect(const std::vector<bool>& liveKeys);
+
+private:
+    // Attributes indexed by their key. Unused slots are listed in _freeKeys.
+    // A deque never moves its elements, so references handed out by Get()
+    // remain valid while other attributes are stored.
+    std::deque<TextAttribute> _attrs;
+    std::unordered_map<TextAttribute, key_type> _keys;
+    std::vector<key_type> _freeKeys;
+    size_t _collectionThreshold;
+
+#ifdef UNIT_TESTING
+    friend class TextAttributeStorageTests;
+#endif
+};
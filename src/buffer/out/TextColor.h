@@ -76,6 +76,7 @@ public:
 
     friend constexpr bool operator==(const TextColor& a, const TextColor& b) noexcept;
     friend constexpr bool operator!=(const TextColor& a, const TextColor& b) noexcept;
+    friend struct std::hash<TextColor>;
 
     bool CanBeBrightened() const noexcept;
     bool IsLegacy() const noexcept;
@@ -132,6 +133,28 @@ bool constexpr operator!=(const TextColor& a, const TextColor& b) noexcept
     return !(a == b);
 }
 
+namespace std
+{
+    template<>
+    struct hash<TextColor>
+    {
+        // Routine Description:
+        // - hashes a TextColor by storing its type and its color components
+        //   (or its index) consecutively in the lower bits of a size_t.
+        // Arguments:
+        // - color - the color to hash
+        // Return Value:
+        // - the hashed color
+        constexpr size_t operator()(const TextColor& color) const noexcept
+        {
+            return size_t{ static_cast<BYTE>(color._meta) } << 24 |
+                   size_t{ color._red } << 16 |
+                   size_t{ color._green } << 8 |
+                   size_t{ color._blue };
+        }
+    };
+}
+
 #ifdef UNIT_TESTING
 
 namespace WEX
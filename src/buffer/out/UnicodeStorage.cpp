@@ -4,8 +4,18 @@
 #include "precomp.h"
 #include "UnicodeStorage.hpp"
 
+// The number of new glyphs we let accumulate before the first collection.
+static constexpr size_t MinimumCollectionThreshold = 1024;
+
+// Keys have to fit into the character field of a CharRowCell.
+static constexpr size_t MaximumGlyphCount = size_t{ std::numeric_limits<UnicodeStorage::key_type>::max() } + 1;
+
 UnicodeStorage::UnicodeStorage() noexcept :
-    _map{}
+    _glyphs{},
+    _keys{},
+    _freeKeys{},
+    _storesSinceCollection{ 0 },
+    _collectionThreshold{ MinimumCollectionThreshold }
 {
 }
 
@@ -18,81 +28,102 @@ UnicodeStorage::UnicodeStorage() noexcept :
 // Note: will throw exception if key is not stored yet
 const UnicodeStorage::mapped_type& UnicodeStorage::GetText(const key_type key) const
 {
-    return _map.at(key);
+    return _glyphs.at(key);
 }
 
 // Routine Description:
-// - stores glyph data associated with key.
+// - stores glyph data, unless the same glyph has already been stored before.
 // Arguments:
-// - key - the key into the storage
 // - glyph - the glyph data to store
-void UnicodeStorage::StoreGlyph(const key_type key, const mapped_type& glyph)
+// Return Value:
+// - the key the glyph can be retrieved with, or nullopt if the storage is full.
+std::optional<UnicodeStorage::key_type> UnicodeStorage::StoreGlyph(const std::wstring_view glyph)
 {
-    _map.insert_or_assign(key, glyph);
+    if (const auto it = _keys.find(glyph); it != _keys.end())
+    {
+        return it->second;
+    }
+
+    // Glyphs that didn't fit count too: a full storage needs collecting as much as a growing one.
+    ++_storesSinceCollection;
+
+    key_type key;
+    if (!_freeKeys.empty())
+    {
+        key = _freeKeys.back();
+        _glyphs.at(key) = glyph;
+        _freeKeys.pop_back();
+    }
+    else if (_glyphs.size() < MaximumGlyphCount)
+    {
+        key = gsl::narrow_cast<key_type>(_glyphs.size());
+        _glyphs.emplace_back(glyph);
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    _keys.emplace(_glyphs.at(key), key);
+    return key;
 }
 
 // Routine Description:
-// - erases key and its associated data from the storage
-// Arguments:
-// - key - the key to remove
-void UnicodeStorage::Erase(const key_type key) noexcept
+// - gets the number of glyphs currently stored
+size_t UnicodeStorage::size() const noexcept
 {
-    _map.erase(key);
+    return _glyphs.size() - _freeKeys.size();
 }
 
 // Routine Description:
-// - Remaps all of the stored items to new coordinate positions
-//   based on a bulk rearrangement of row IDs and potential row width resize.
-// Arguments:
-// - rowMap - A map of the old row IDs to the new row IDs.
-// - width - The width of the new row. Remove any items that are beyond the row width.
-//         - Use nullopt if we're not resizing the width of the row, just renumbering the rows.
-void UnicodeStorage::Remap(const std::unordered_map<SHORT, SHORT>& rowMap, const std::optional<SHORT> width)
+// - gets the number of keys handed out so far, used or not. All keys are smaller than this.
+size_t UnicodeStorage::capacity() const noexcept
 {
-    // Make a temporary map to hold all the new row positioning
-    std::unordered_map<key_type, mapped_type> newMap;
-
-    // Walk through every stored item.
-    for (const auto& pair : _map)
-    {
-        // Extract the old coordinate position
-        const auto oldCoord = pair.first;
-
-        // Only try to short-circuit based on width if we were told it changed
-        // by being given a new width value.
-        if (width.has_value())
-        {
-            // Get the column ID
-            const auto oldColId = oldCoord.X;
-
-            // If the column index is at/beyond the row width, don't bother copying it to the new map.
-            if (oldColId >= width.value())
-            {
-                continue;
-            }
-        }
-
-        // Get the row ID from the position as that's what we need to remap
-        const auto oldRowId = oldCoord.Y;
+    return _glyphs.size();
+}
 
-        // Use the mapping given to convert the old row ID to the new row ID
-        const auto mapIter = rowMap.find(oldRowId);
+// Routine Description:
+// - checks whether enough new glyphs have been stored since the last collection to warrant another one.
+// Return Value:
+// - true if the owner should call Collect().
+bool UnicodeStorage::NeedsCollection() const noexcept
+{
+    return _storesSinceCollection >= _collectionThreshold;
+}
 
-        // If there's no mapping to a new row, don't bother copying it to the new map. The row is gone.
-        if (mapIter == rowMap.end())
+// Routine Description:
+// - releases every glyph that isn't in use anymore.
+// - The next collection is scheduled for when as many new glyphs have been
+//   stored as are left after this one, so the cost of collecting stays
+//   proportional to the number of glyphs stored. Counting the glyphs that
+//   were stored rather than looking at size() means this holds even when the
+//   storage is full: a buffer full of distinct glyphs isn't walked again on every write.
+// Arguments:
+// - liveKeys - for each key, whether it is still referred to by the buffer.
+void UnicodeStorage::Collect(const std::vector<bool>& liveKeys)
+{
+    for (size_t key = 0; key < _glyphs.size(); ++key)
+    {
+        auto& glyph = til::at(_glyphs, key);
+        if (!glyph.empty() && (key >= liveKeys.size() || !liveKeys.at(key)))
         {
-            continue;
+            _keys.erase(glyph);
+            mapped_type{}.swap(glyph);
+            _freeKeys.push_back(gsl::narrow_cast<key_type>(key));
         }
-
-        const auto newRowId = mapIter->second;
-
-        // Generate a new coordinate with the same X as the old one, but a new Y value.
-        const auto newCoord = COORD{ oldCoord.X, newRowId };
-
-        // Put the adjusted coordinate into the map with the original value.
-        newMap.emplace(newCoord, pair.second);
     }
 
-    // Swap into the stored map, free the temporary when we exit.
-    _map.swap(newMap);
+    _storesSinceCollection = 0;
+    _collectionThreshold = std::max(size(), MinimumCollectionThreshold);
+}
+
+// Routine Description:
+// - releases all glyphs at once, for when the buffer is known to be empty.
+void UnicodeStorage::Clear() noexcept
+{
+    _keys.clear();
+    _glyphs.clear();
+    _freeKeys.clear();
+    _storesSinceCollection = 0;
+    _collectionThreshold = MinimumCollectionThreshold;
 }
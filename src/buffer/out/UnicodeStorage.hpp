@@ -7,6 +7,10 @@ Module Name:
 
 Abstract:
 - dynamic storage location for glyphs that can't normally fit in the output buffer
+- glyphs are interned: each distinct glyph is stored once and is referred to by a
+  16-bit key, which the CharRowCell holds in place of its character. Since the key
+  travels with the cell, rows can be rotated or moved around without rekeying.
+- unused glyphs are only released by Collect(), given the set of keys still in use.
 
 Author(s):
 - Austin Diviness (AustDi) 02-May-2018
@@ -14,51 +18,37 @@ Author(s):
 
 #pragma once
 
+#include <deque>
 #include <vector>
 #include <unordered_map>
-#include <climits>
-
-// std::unordered_map needs help to know how to hash a COORD
-namespace std
-{
-    template<>
-    struct hash<COORD>
-    {
-        // Routine Description:
-        // - hashes a coord. coord will be hashed by storing the x and y values consecutively in the lower
-        // bits of a size_t.
-        // Arguments:
-        // - coord - the coord to hash
-        // Return Value:
-        // - the hashed coord
-        constexpr size_t operator()(const COORD& coord) const noexcept
-        {
-            size_t retVal = coord.Y;
-            const size_t xCoord = coord.X;
-            retVal |= xCoord << (sizeof(coord.Y) * CHAR_BIT);
-            return retVal;
-        }
-    };
-}
 
 class UnicodeStorage final
 {
 public:
-    using key_type = typename COORD;
-    using mapped_type = typename std::vector<wchar_t>;
+    using key_type = typename wchar_t;
+    using mapped_type = typename std::wstring;
 
     UnicodeStorage() noexcept;
 
     const mapped_type& GetText(const key_type key) const;
 
-    void StoreGlyph(const key_type key, const mapped_type& glyph);
+    std::optional<key_type> StoreGlyph(const std::wstring_view glyph);
 
-    void Erase(const key_type key) noexcept;
+    size_t size() const noexcept;
+    size_t capacity() const noexcept;
 
-    void Remap(const std::unordered_map<SHORT, SHORT>& rowMap, const std::optional<SHORT> width);
+    bool NeedsCollection() const noexcept;
+    void Collect(const std::vector<bool>& liveKeys);
+    void Clear() noexcept;
 
 private:
-    std::unordered_map<key_type, mapped_type> _map;
+    // Glyphs indexed by their key. Unused slots hold an empty string.
+    // A deque never moves its elements, so _keys can safely refer to them.
+    std::deque<mapped_type> _glyphs;
+    std::unordered_map<std::wstring_view, key_type> _keys;
+    std::vector<key_type> _freeKeys;
+    size_t _storesSinceCollection;
+    size_t _collectionThreshold;
 
 #ifdef UNIT_TESTING
     friend class UnicodeStorageTests;
@@ -75,24 +75,74 @@ bool Search::FindNext()
         return false;
     }
 
-    do
+    // All matches in the buffer are known up front, so instead of walking the
+    // buffer cell by cell we look them up in the same order the walk would
+    // have visited them: the current position first, then on towards the end
+    // of the text in our direction, wrapping around until we're back at the anchor.
+    FindAll();
+
+    const auto next = _CoordToIndex(_coordNext);
+    const auto anchor = _CoordToIndex(_coordAnchor);
+    const auto end = _CoordToIndex(_uiaData.GetTextBufferEndPosition());
+
+    auto match = _FindMatchInRange(next, next);
+    if (_direction == Direction::Forward)
     {
-        if (_FindNeedleInHaystackAt(_coordNext, _coordSelStart, _coordSelEnd))
+        if (!match)
         {
-            _UpdateNextPosition();
-            _reachedEnd = _coordNext == _coordAnchor;
-            return true;
+            match = _FindMatchInRange(next + 1, next < anchor ? std::min(anchor - 1, end) : end);
         }
-        else
+        if (!match && next >= anchor)
+        {
+            match = _FindMatchInRange(0, std::min(anchor - 1, end));
+        }
+    }
+    else
+    {
+        if (!match)
         {
-            _UpdateNextPosition();
+            match = _FindMatchInRange(next > anchor ? anchor + 1 : 0, std::min(next - 1, end));
         }
+        if (!match && next <= anchor)
+        {
+            match = _FindMatchInRange(anchor + 1, end);
+        }
+    }
 
-    } while (_coordNext != _coordAnchor);
+    if (match)
+    {
+        _coordSelStart = match->first;
+        _coordSelEnd = match->second;
+        _coordNext = match->first;
+        _UpdateNextPosition();
+        _reachedEnd = _coordNext == _coordAnchor;
+        return true;
+    }
 
+    _coordSelStart = { 0 };
+    _coordSelEnd = { 0 };
+    _coordNext = _coordAnchor;
     return false;
 }
 
+// Routine Description
+// - Locates every instance of the search term within the screen buffer.
+// - The buffer is only scanned on the first call. Subsequent calls (and FindNext)
+//   reuse the result, so create a new Search object to pick up new output. The new
+//   object only has to flatten the rows that changed, as the buffer keeps their text.
+// Arguments:
+// - <none> - Uses internal state from constructor
+// Return Value:
+// - The [start, end] coord positions of every match, ordered by their start position.
+const std::vector<std::pair<COORD, COORD>>& Search::FindAll()
+{
+    if (!_matches)
+    {
+        _matches = _FindAllInHaystack();
+    }
+    return *_matches;
+}
+
 // Routine Description:
 // - Takes the found word and selects it in the screen buffer
 void Search::Select() const
@@ -178,72 +228,200 @@ COORD Search::s_GetInitialAnchor(IUiaData& uiaData, const Direction direction)
 }
 
 // Routine Description:
-// - Attempts to compare the search term (the needle) to the screen buffer (the haystack)
-//   at the given coordinate position of the screen buffer.
-// - Performs one comparison. Call again with new positions to check other spots.
+// - Scans the screen buffer (the haystack) for every occurrence of the search term (the needle).
+// - Each row is searched in a single Boyer-Moore-Horspool pass over its text, instead of
+//   comparing the needle against the buffer at every coordinate. The text of the rows
+//   is kept in the SearchIndex of the terminal, so only rows that changed since the
+//   previous search have to be flattened again.
+// - Matches that run on from one row into the next are found in a separate pass over
+//   just the cells around the end of the row.
 // Arguments:
-// - pos - The position in the haystack (screen buffer) to compare
-// - start - If we found it, this is filled with the coordinate of the first character of the needle.
-// - end - If we found it, this is filled with the coordinate of the last character of the needle.
+// - <none> - Uses internal state from constructor
 // Return Value:
-// - True if we found it. False if not.
-bool Search::_FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end) const
+// - The [start, end] coord positions of every match, ordered by their start position.
+std::vector<std::pair<COORD, COORD>> Search::_FindAllInHaystack() const
 {
-    start = { 0 };
-    end = { 0 };
+    std::vector<std::pair<COORD, COORD>> matches;
+    if (_needle.empty())
+    {
+        return matches;
+    }
 
-    COORD bufferPos = pos;
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    auto& index = _uiaData.GetSearchIndex();
+    const auto indexLock = index.Lock();
+    const auto bufferSize = textBuffer.GetSize();
+    const auto width = gsl::narrow_cast<size_t>(bufferSize.Width());
+    const auto needleCellCount = _needle.size();
+
+    // Matches may start anywhere up to the end of the text (or the anchor, which
+    // FindNext always looks at first), but can run on into the rows below it.
+    const auto lastStart = gsl::narrow_cast<size_t>(std::max(_CoordToIndex(_uiaData.GetTextBufferEndPosition()), _CoordToIndex(_coordAnchor)));
+    const auto lastRow = std::min(gsl::narrow_cast<size_t>(bufferSize.BottomInclusive()), (lastStart + needleCellCount) / width);
+    const auto cellCount = (lastRow + 1) * width;
+
+    // The needle is flattened the same way as the rows. We also keep the offset at
+    // which each of its cells starts (plus the total length at the end), so that we
+    // can tell whether a match lines up with the cells in the buffer.
+    std::wstring needle;
+    std::vector<size_t> needleCells;
+    needleCells.reserve(needleCellCount + 1);
+    for (const auto& cell : _needle)
+    {
+        needleCells.push_back(needle.size());
+        needle.append(cell.data(), cell.size());
+    }
+    needleCells.push_back(needle.size());
+
+    // The index holds the text as it is in the buffer, so the sensitivity is applied while comparing.
+    const auto hash = [this](const wchar_t wch) noexcept {
+        return std::hash<wchar_t>{}(_ApplySensitivity(wch));
+    };
+    const auto equal = [this](const wchar_t lhs, const wchar_t rhs) noexcept {
+        return _ApplySensitivity(lhs) == _ApplySensitivity(rhs);
+    };
+    const std::boyer_moore_horspool_searcher searcher{ needle.cbegin(), needle.cend(), hash, equal };
+
+    // Appends the start of every match in text to matchStarts, as long as it lies in [minStart, maxStart].
+    // The text holds the cells from textCell on. cellOffset tells where each of those cells
+    // starts within the text, counting from textCell, and textCellCount how many there are.
+    std::vector<size_t> matchStarts;
+    const auto findInText = [&](const std::wstring_view text, const size_t textCell, const size_t textCellCount, const auto& cellOffset, const size_t minStart, const size_t maxStart) {
+        for (auto it = text.cbegin();;)
+        {
+            const auto found = searcher(it, text.cend()).first;
+            if (found == text.cend())
+            {
+                break;
+            }
+
+            // Continue right after the start of this match, as matches may overlap.
+            it = found + 1;
+
+            // Find the cell the match starts at, if it starts at the beginning of one.
+            const auto offset = gsl::narrow_cast<size_t>(found - text.cbegin());
+            size_t cell = 0;
+            for (auto count = textCellCount; count > 0;)
+            {
+                const auto half = count / 2;
+                if (cellOffset(cell + half) < offset)
+                {
+                    cell += half + 1;
+                    count -= half + 1;
+                }
+                else
+                {
+                    count = half;
+                }
+            }
+            if (cell + needleCellCount > textCellCount || textCell + cell > maxStart)
+            {
+                break;
+            }
+
+            // Every cell of the needle has to match a whole cell of the buffer.
+            auto aligned = textCell + cell >= minStart;
+            for (size_t i = 0; aligned && i < needleCells.size(); ++i)
+            {
+                aligned = cellOffset(cell + i) == offset + needleCells.at(i);
+            }
+
+            if (aligned)
+            {
+                matchStarts.push_back(textCell + cell);
+            }
+        }
+    };
 
-    for (const auto& needleCell : _needle)
+    std::wstring seam;
+    std::vector<size_t> seamCells;
+    for (size_t y = 0; y <= lastRow && y * width <= lastStart; ++y)
     {
-        // Haystack is the buffer. Needle is the string we were given.
-        const auto hayIter = _uiaData.GetTextBuffer().GetTextDataAt(bufferPos);
-        const auto hayChars = *hayIter;
-        const auto needleChars = std::wstring_view(needleCell.data(), needleCell.size());
+        const auto rowStart = y * width;
+        const auto nextRowStart = rowStart + width;
 
-        // If we didn't match at any point of the needle, return false.
-        if (!_CompareChars(hayChars, needleChars))
+        // The matches within the row.
+        const auto& rowText = index.GetRow(textBuffer.GetRowByOffset(y));
+        findInText(rowText.Text(), rowStart, width, [&](const size_t cell) noexcept { return rowText.CellOffset(cell); }, rowStart, lastStart);
+
+        // The matches which start in this row, but end in one of the next. These
+        // start within the last (needle length - 1) cells of the row, so that's
+        // all we need to look at, along with the same number of cells after it.
+        if (needleCellCount > 1 && nextRowStart < cellCount)
         {
-            return false;
+            const auto seamStart = nextRowStart - std::min(width, needleCellCount - 1);
+            const auto seamEnd = std::min(cellCount, nextRowStart + needleCellCount - 1);
+
+            seam.clear();
+            seamCells.clear();
+            for (auto cell = seamStart; cell < seamEnd;)
+            {
+                const auto& seamRowText = index.GetRow(textBuffer.GetRowByOffset(cell / width));
+                for (const auto seamRowEnd = std::min(seamEnd, (cell / width + 1) * width); cell < seamRowEnd; ++cell)
+                {
+                    const auto first = seamRowText.CellOffset(cell % width);
+                    const auto last = seamRowText.CellOffset(cell % width + 1);
+                    seamCells.push_back(seam.size());
+                    seam.append(seamRowText.Text().substr(first, last - first));
+                }
+            }
+            seamCells.push_back(seam.size());
+
+            findInText(seam, seamStart, seamEnd - seamStart, [&](const size_t cell) { return seamCells.at(cell); }, seamStart, std::min(lastStart, nextRowStart - 1));
         }
-
-        _IncrementCoord(bufferPos);
     }
 
-    _DecrementCoord(bufferPos);
+    // Only keep the text of the rows we've looked at this time around.
+    index.Trim();
 
-    // If we made it the whole way through the needle, then it was in the haystack.
-    // Fill out the span that we found the result at and return true.
-    start = pos;
-    end = bufferPos;
+    matches.reserve(matchStarts.size());
+    for (const auto start : matchStarts)
+    {
+        const auto last = start + needleCellCount - 1;
+        matches.emplace_back(COORD{ gsl::narrow<SHORT>(start % width), gsl::narrow<SHORT>(start / width) },
+                             COORD{ gsl::narrow<SHORT>(last % width), gsl::narrow<SHORT>(last / width) });
+    }
 
-    return true;
+    return matches;
 }
 
 // Routine Description:
-// - Provides an abstraction for comparing two spans of text.
-// - Internally handles case sensitivity based on object construction.
+// - Picks the match to move to out of those starting within the given range of positions.
 // Arguments:
-// - one - String view representing the first string of text
-// - two - String view representing the second string of text
+// - first - The linear index of the first position in the range
+// - last - The linear index of the last position in the range (inclusive)
 // Return Value:
-// - True if they are the same. False otherwise.
-bool Search::_CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept
+// - The match closest to the beginning of the range when searching forward, or the one
+//   closest to its end when searching backward. nullptr if there is no match in the range.
+const std::pair<COORD, COORD>* Search::_FindMatchInRange(const ptrdiff_t first, const ptrdiff_t last) const
 {
-    if (one.size() != two.size())
+    if (!_matches || first > last)
     {
-        return false;
+        return nullptr;
     }
 
-    for (size_t i = 0; i < one.size(); i++)
+    const auto startsBefore = [this](const auto& match, const ptrdiff_t index) noexcept {
+        return _CoordToIndex(match.first) < index;
+    };
+    const auto begin = std::lower_bound(_matches->cbegin(), _matches->cend(), first, startsBefore);
+    const auto end = std::lower_bound(begin, _matches->cend(), last + 1, startsBefore);
+    if (begin == end)
     {
-        if (_ApplySensitivity(one.at(i)) != _ApplySensitivity(two.at(i)))
-        {
-            return false;
-        }
+        return nullptr;
     }
 
-    return true;
+    return _direction == Direction::Forward ? &*begin : &*(end - 1);
+}
+
+// Routine Description:
+// - Helper to convert a coordinate into its linear position in the associated screen buffer
+// Arguments
+// - coord - The coordinate to convert
+// Return Value:
+// - The number of cells preceding the coordinate in the buffer.
+ptrdiff_t Search::_CoordToIndex(const COORD coord) const noexcept
+{
+    return static_cast<ptrdiff_t>(coord.Y) * _uiaData.GetTextBuffer().GetSize().Width() + coord.X;
 }
 
 // Routine Description:
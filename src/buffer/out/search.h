@@ -52,6 +52,7 @@ public:
            const COORD anchor);
 
     bool FindNext();
+    const std::vector<std::pair<COORD, COORD>>& FindAll();
     void Select() const;
     void Color(const TextAttribute attr) const;
 
@@ -59,8 +60,9 @@ public:
 
 private:
     wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
-    bool _FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end) const;
-    bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept;
+    std::vector<std::pair<COORD, COORD>> _FindAllInHaystack() const;
+    const std::pair<COORD, COORD>* _FindMatchInRange(const ptrdiff_t first, const ptrdiff_t last) const;
+    ptrdiff_t _CoordToIndex(const COORD coord) const noexcept;
     void _UpdateNextPosition();
 
     void _IncrementCoord(COORD& coord) const noexcept;
@@ -74,6 +76,7 @@ private:
     COORD _coordNext = { 0 };
     COORD _coordSelStart = { 0 };
     COORD _coordSelEnd = { 0 };
+    std::optional<std::vector<std::pair<COORD, COORD>>> _matches;
 
     const COORD _coordAnchor;
     const std::vector<std::vector<wchar_t>> _needle;
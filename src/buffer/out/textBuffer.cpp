@@ -9,6 +9,7 @@
 #include "../types/inc/utils.hpp"
 #include "../types/inc/convert.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/PerformanceCounters.hpp"
 
 #pragma hdrstop
 
@@ -34,18 +35,29 @@ TextBuffer::TextBuffer(const COORD screenBufferSize,
     _firstRow{ 0 },
     _currentAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
+    _charBuffer{},
     _storage{},
+    _rowMap{},
     _unicodeStorage{},
     _renderTarget{ renderTarget },
+    _performanceCounters{ nullptr },
     _size{},
     _currentHyperlinkId{ 1 },
     _currentPatternId{ 0 }
 {
-    // initialize ROWs
-    _storage.reserve(static_cast<size_t>(screenBufferSize.Y));
-    for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
+    // initialize ROWs. All of their cells live in a single allocation.
+    const auto width = static_cast<size_t>(screenBufferSize.X);
+    const auto height = static_cast<size_t>(screenBufferSize.Y);
+    _charBuffer.resize(width * height);
+    const auto cells = gsl::make_span(_charBuffer);
+
+    _storage.reserve(height);
+    _rowMap.reserve(height);
+    for (size_t i = 0; i < height; ++i)
     {
-        _storage.emplace_back(static_cast<SHORT>(i), screenBufferSize.X, _currentAttributes, this);
+        _storage.emplace_back(static_cast<SHORT>(i), cells.subspan(i * width, width), _currentAttributes, this);
+        _storage.back().GetAttrRow().SetHyperlinkRefCounts(&_hyperlinkRefCounts);
+        _rowMap.emplace_back(static_cast<SHORT>(i));
     }
 
     _UpdateSize();
@@ -86,8 +98,9 @@ const ROW& TextBuffer::GetRowByOffset(const size_t index) const
     const size_t totalRows = TotalRowCount();
 
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
+    // The row map then tells where the row at that position actually sits in storage.
     const size_t offsetIndex = (_firstRow + index) % totalRows;
-    return _storage.at(offsetIndex);
+    return _storage.at(_rowMap.at(offsetIndex));
 }
 
 // Routine Description:
@@ -102,8 +115,9 @@ ROW& TextBuffer::GetRowByOffset(const size_t index)
     const size_t totalRows = TotalRowCount();
 
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
+    // The row map then tells where the row at that position actually sits in storage.
     const size_t offsetIndex = (_firstRow + index) % totalRows;
-    return _storage.at(offsetIndex);
+    return _storage.at(_rowMap.at(offsetIndex));
 }
 
 // Routine Description:
@@ -379,6 +393,9 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
         return givenIt;
     }
 
+    // Release unused glyphs and attributes every once in a while, before the write stores new ones.
+    _CollectStorageIfNeeded();
+
     //  Get the row and write the cells
     ROW& row = GetRowByOffset(target.Y);
     const auto newIt = row.WriteCells(givenIt, target.X, wrap, limitRight);
@@ -391,6 +408,29 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Copies a span of cells within a row to another position in the buffer, in one block move
+//   instead of writing them one by one. The target may be in another row, or overlap the source.
+// Arguments:
+// - source - Coordinate of the first cell to copy
+// - target - Coordinate to copy the first cell to
+// - width - The number of cells to copy. Both spans must fit in their rows.
+// Return Value:
+// - <none>
+void TextBuffer::CopyCells(const COORD source, const COORD target, const SHORT width)
+{
+    if (width <= 0)
+    {
+        return;
+    }
+
+    const ROW& sourceRow = GetRowByOffset(source.Y);
+    ROW& targetRow = GetRowByOffset(target.Y);
+    targetRow.CopyCells(sourceRow, gsl::narrow<size_t>(source.X), gsl::narrow<size_t>(target.X), gsl::narrow<size_t>(width));
+
+    _NotifyPaint(Viewport::FromDimensions(target, { width, 1 }));
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -422,6 +462,7 @@ bool TextBuffer::InsertCharacter(const std::wstring_view chars,
 
         try
         {
+            _CollectStorageIfNeeded();
             charRow.GlyphAt(iCol) = chars;
             charRow.DbcsAttrAt(iCol) = dbcsAttribute;
         }
@@ -557,9 +598,16 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
     // FirstRow is at any given point in time the array index in the circular buffer that corresponds
     // to the logical position 0 in the window (cursor coordinates and all other coordinates).
     _renderTarget.TriggerCircling();
+    if (_performanceCounters)
+    {
+        _performanceCounters->Add(PerformanceCounter::RowsCirculated);
+    }
 
-    // Prune hyperlinks to delete obsolete references
-    _PruneHyperlinks();
+    // Remember the hyperlinks of the old first row, so that we can prune the ones that become obsolete below
+    const auto hyperlinks = _GetFirstRow().GetAttrRow().GetHyperlinks();
+
+    // Release unused high unicode glyphs and attributes every once in a while
+    _CollectStorageIfNeeded();
 
     // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     auto fillAttributes = _currentAttributes;
@@ -569,7 +617,11 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         // the current background color, but with no meta attributes set.
         fillAttributes.SetStandardErase();
     }
-    const bool fSuccess = _storage.at(_firstRow).Reset(fillAttributes);
+    const bool fSuccess = _GetFirstRow().Reset(fillAttributes);
+
+    // Prune hyperlinks to delete obsolete references
+    _PruneHyperlinks(hyperlinks);
+
     if (fSuccess)
     {
         // Now proceed to increment.
@@ -689,97 +741,55 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         return;
     }
 
-    // OK. We're about to play games by moving rows around within the deque to
-    // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
-    {
-        // Rotate the buffer to put the first row at the front.
-        std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
-
-        // The first row is now at the top.
-        _firstRow = 0;
-    }
-
-    // Rotate just the subsection specified
-    if (delta < 0)
-    {
-        // The layout is like this:
-        // delta is -2, size is 3, firstRow is 5
-        // We want 3 rows from 5 (5, 6, and 7) to move up 2 spots.
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3 A. begin + firstRow + delta (because delta is negative)
-        // | 4
-        // | 5 B. begin + firstRow
-        // | 6
-        // | 7
-        // | 8 C. begin + firstRow + size
-        // | 9
-        // | 10
-        // | 11
-        // - end
-        // We want B to slide up to A (the negative delta) and everything from [B,C) to slide up with it.
-        // So the final layout will be
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 5
-        // | 6
-        // | 7
-        // | 3
-        // | 4
-        // | 8
-        // | 9
-        // | 10
-        // | 11
-        // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+    if (_performanceCounters)
+    {
+        _performanceCounters->Add(PerformanceCounter::RowsScrolled, size);
     }
-    else
+
+    // OK. We're about to play games by moving rows around to scroll a massive region
+    // in a faster way than copying things. The rows themselves stay where they are in
+    // storage. We only rotate their entries in the row map, and only within the region.
+    //
+    // If delta is -2, size is 3 and firstRow is 5, we want the 3 rows from 5 (5, 6, and 7)
+    // to move up 2 spots, and the 2 rows they move over (3 and 4) to slide in below them:
+    //   before: 0 1 2 3 4 [5 6 7] 8 9 10 11
+    //   after:  0 1 2 [5 6 7] 3 4 8 9 10 11
+    // If delta is 2 instead, we want them to move down 2 spots, over rows 8 and 9:
+    //   before: 0 1 2 3 4 [5 6 7] 8 9 10 11
+    //   after:  0 1 2 3 4 8 9 [5 6 7] 10 11
+    // Either way, that's a rotation of the rows from the top to the bottom of everything that moves.
+    const auto top = gsl::narrow_cast<size_t>(delta < 0 ? firstRow + delta : firstRow);
+    const auto middle = gsl::narrow_cast<size_t>(delta < 0 ? firstRow : firstRow + size);
+    const auto bottom = gsl::narrow_cast<size_t>(delta < 0 ? firstRow + size : firstRow + size + delta);
+
+    // The rows are stored circularly, so these are offsets from the first row, just like
+    // the ones given to GetRowByOffset. This turns them into positions in the row map.
+    const size_t totalRows = TotalRowCount();
+    const auto position = [&](const size_t offset) noexcept {
+        return (_firstRow + offset) % totalRows;
+    };
+
+    // The region may wrap around the end of the row map, so it's rotated in place by
+    // reversing its two parts and then the whole of it, rather than with std::rotate.
+    const auto reverse = [&](size_t first, size_t last) {
+        while (first + 1 < last)
+        {
+            --last;
+            std::swap(_rowMap.at(position(first)), _rowMap.at(position(last)));
+            ++first;
+        }
+    };
+    reverse(top, middle);
+    reverse(middle, bottom);
+    reverse(top, bottom);
+
+    // Renumber the IDs of the rows that have moved. No other row has.
+    // The UnicodeStorage keys are held by the cells themselves, so they moved along with the rows.
+    for (auto offset = top; offset < bottom; ++offset)
     {
-        // The layout is like this:
-        // delta is 2, size is 3, firstRow is 5
-        // We want 3 rows from 5 (5, 6, and 7) to move down 2 spots.
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3
-        // | 4
-        // | 5 A. begin + firstRow
-        // | 6
-        // | 7
-        // | 8 B. begin + firstRow + size
-        // | 9
-        // | 10 C. begin + firstRow + size + delta
-        // | 11
-        // - end
-        // We want B-1 to slide down to C-1 (the positive delta) and everything from [A, B) to slide down with it.
-        // So the final layout will be
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3
-        // | 4
-        // | 8
-        // | 9
-        // | 5
-        // | 6
-        // | 7
-        // | 10
-        // | 11
-        // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
-    }
-
-    // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
-    // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+        const auto rowPosition = position(offset);
+        _storage.at(_rowMap.at(rowPosition)).SetId(gsl::narrow_cast<SHORT>(rowPosition));
+    }
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -885,6 +895,11 @@ void TextBuffer::Reset()
     {
         row.Reset(attr);
     }
+
+    // None of the cells refer to any high unicode glyphs anymore,
+    // and the rows only refer to a single attribute.
+    _unicodeStorage.Clear();
+    _CollectAttributeStorage();
 }
 
 // Routine Description:
@@ -909,6 +924,9 @@ void TextBuffer::Reset()
         }
         const SHORT TopRowIndex = (GetFirstRowIndex() + TopRow) % currentSize.Y;
 
+        // put the rows back in the order of their positions, so we can rearrange them below
+        _ApplyRowMap();
+
         // rotate rows until the top row is at index 0
         for (int i = 0; i < TopRowIndex; i++)
         {
@@ -924,16 +942,59 @@ void TextBuffer::Reset()
         {
             _storage.pop_back();
         }
-        // add rows if we're growing
-        while (_storage.size() < static_cast<size_t>(newSize.Y))
+
+        // All rows share one piece of cell storage, so allocate a new one for the new dimensions.
+        const auto newWidth = static_cast<size_t>(newSize.X);
+        std::vector<CharRowCell> newCharBuffer(newWidth * newSize.Y);
+        const auto newCells = gsl::make_span(newCharBuffer);
+        _storage.reserve(newSize.Y);
+
+        // Everything that can fail is done on the side, before the first row is moved over into the new cells.
+        // The attributes of the rows we keep are resized as copies, which hold their own hyperlink references.
+        std::vector<ATTR_ROW> newAttrRows;
+        newAttrRows.reserve(_storage.size());
+        for (const auto& row : _storage)
+        {
+            auto& attrRow = newAttrRows.emplace_back(row.GetAttrRow());
+            attrRow.Resize(newWidth);
+            attrRow.SetHyperlinkRefCounts(&_hyperlinkRefCounts);
+        }
+        // The rows we add if we're growing only ever point into the new cells.
+        std::vector<ROW> newRows;
+        newRows.reserve(newSize.Y - _storage.size());
+        for (auto i = _storage.size(); i < static_cast<size_t>(newSize.Y); ++i)
+        {
+            auto& row = newRows.emplace_back(static_cast<short>(i), newCells.subspan(i * newWidth, newWidth), attributes, this);
+            row.GetAttrRow().SetHyperlinkRefCounts(&_hyperlinkRefCounts);
+        }
+
+        // realloc in the X direction
+        for (size_t i = 0; i < _storage.size(); ++i)
+        {
+            _storage.at(i).Resize(newCells.subspan(i * newWidth, newWidth), std::move(newAttrRows.at(i)));
+        }
+        // add rows if we're growing. The storage has room for them already.
+        for (auto& row : newRows)
+        {
+            _storage.emplace_back(std::move(row));
+        }
+
+        // Moving the vector keeps its allocation, so the rows remain valid views into it.
+        _charBuffer = std::move(newCharBuffer);
+
+        // Every row is at its own position again.
+        _rowMap.resize(_storage.size());
+        for (size_t i = 0; i < _rowMap.size(); ++i)
         {
-            _storage.emplace_back(static_cast<short>(_storage.size()), newSize.X, attributes, this);
+            _rowMap.at(i) = gsl::narrow_cast<SHORT>(i);
         }
 
         // Now that we've tampered with the row placement, refresh all the row IDs.
-        // Also take advantage of the row ID refresh loop to resize the rows in the X dimension
-        // and cleanup the UnicodeStorage characters that might fall outside the resized buffer.
-        _RefreshRowIDs(newSize.X);
+        _RefreshRowIDs();
+
+        // Release the high unicode glyphs and attributes of the rows and columns we just cut off.
+        _CollectUnicodeStorage();
+        _CollectAttributeStorage();
 
         // Update the cached size value
         _UpdateSize();
@@ -953,40 +1014,95 @@ UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
     return _unicodeStorage;
 }
 
+TextAttributeStorage& TextBuffer::GetAttributeStorage() noexcept
+{
+    return _attrStorage;
+}
+
 // Routine Description:
 // - Method to help refresh all the Row IDs after manipulating the row
 //   by shuffling pointers around.
 // - This will also update parent pointers that are stored in depth within the buffer
 //   (e.g. it will update CharRow parents pointing at Rows that might have been moved around)
-// - Optionally takes a new row width if we're resizing to perform a resize operation and cleanup
-//   any high unicode (UnicodeStorage) runs while we're already looping through the rows.
-// Arguments:
-// - newRowWidth - Optional new value for the row width.
-void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
+void TextBuffer::_RefreshRowIDs()
 {
-    std::unordered_map<SHORT, SHORT> rowMap;
     SHORT i = 0;
     for (auto& it : _storage)
     {
-        // Build a map so we can update Unicode Storage
-        rowMap.emplace(it.GetId(), i);
-
         // Update the IDs
         it.SetId(i++);
 
         // Also update the char row parent pointers as they can get shuffled up in the rotates.
         it.GetCharRow().UpdateParent(&it);
+    }
+}
+
+// Routine Description:
+// - Moves the rows within storage into the order of the row map, so that every row sits at its own position.
+// - This moves every row of the buffer, so it's only done before the rows are rearranged anyways.
+void TextBuffer::_ApplyRowMap()
+{
+    std::vector<ROW> rows;
+    rows.reserve(_storage.size());
+    for (const auto index : _rowMap)
+    {
+        rows.emplace_back(std::move(_storage.at(index)));
+    }
+    _storage = std::move(rows);
 
-        // Resize the rows in the X dimension if we have a new width
-        if (newRowWidth.has_value())
+    for (size_t i = 0; i < _rowMap.size(); ++i)
+    {
+        _rowMap.at(i) = gsl::narrow_cast<SHORT>(i);
+    }
+
+    _RefreshRowIDs();
+}
+
+// Routine Description:
+// - Releases unused glyphs and attributes once their storages grew past the point
+//   where they ask for it. Every write calls this, so that buffers which never
+//   circle (like the alt buffer) don't run out of keys.
+void TextBuffer::_CollectStorageIfNeeded()
+{
+    if (_unicodeStorage.NeedsCollection())
+    {
+        _CollectUnicodeStorage();
+    }
+    if (_attrStorage.NeedsCollection())
+    {
+        _CollectAttributeStorage();
+    }
+}
+
+// Routine Description:
+// - Releases the glyphs in the UnicodeStorage that no cell refers to anymore.
+// - This walks every cell of the buffer, so it's only done when the storage
+//   asks for it or when a large part of the buffer was discarded anyways.
+void TextBuffer::_CollectUnicodeStorage()
+{
+    std::vector<bool> liveKeys(_unicodeStorage.capacity());
+    for (const auto& cell : _charBuffer)
+    {
+        if (cell.DbcsAttr().IsGlyphStored())
         {
-            // Realloc in the X direction
-            THROW_IF_FAILED(it.Resize(newRowWidth.value()));
+            liveKeys.at(cell.Char()) = true;
         }
     }
+    _unicodeStorage.Collect(liveKeys);
+}
 
-    // Give the new mapping to Unicode Storage
-    _unicodeStorage.Remap(rowMap, newRowWidth);
+// Routine Description:
+// - Releases the attributes in the TextAttributeStorage that no row refers to anymore.
+// - Like _CollectUnicodeStorage, this walks every row of the buffer, so it's only
+//   done when the storage asks for it or when many rows were reset anyways.
+void TextBuffer::_CollectAttributeStorage()
+{
+    std::vector<bool> liveKeys(_attrStorage.capacity());
+    for (const auto& row : _storage)
+    {
+        row.GetAttrRow().MarkLiveAttributes(liveKeys);
+    }
+    _attrStorage.Collect(liveKeys);
 }
 
 void TextBuffer::_NotifyPaint(const Viewport& viewport) const
@@ -1023,7 +1139,7 @@ ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
     }
 
     THROW_HR_IF(E_FAIL, Row.GetId() == _firstRow);
-    return _storage.at(prevRowIndex);
+    return _storage.at(_rowMap.at(prevRowIndex));
 }
 
 // Method Description:
@@ -1037,6 +1153,18 @@ Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget() noexcep
     return _renderTarget;
 }
 
+// Method Description:
+// - Sets the counters the buffer should count circling and scrolling into.
+// Arguments:
+// - counters - the counters of the terminal that owns this buffer. May be null,
+//              in which case nothing is counted.
+// Return Value:
+// - <none>
+void TextBuffer::SetPerformanceCounters(PerformanceCounters* const counters) noexcept
+{
+    _performanceCounters = counters;
+}
+
 // Method Description:
 // - get delimiter class for buffer cell position
 // - used for double click selection and uia word navigation
@@ -1295,48 +1423,20 @@ const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::w
     return result;
 }
 
-void TextBuffer::_PruneHyperlinks()
+// Routine Description:
+// - Removes the given hyperlinks from our map, if no row refers to them anymore.
+//   This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around.
+// Arguments:
+// - hyperlinks - the hyperlinks of the row that was just erased
+void TextBuffer::_PruneHyperlinks(const std::vector<uint16_t>& hyperlinks)
 {
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
-    // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = _storage.at(_firstRow).GetAttrRow().GetHyperlinks();
-
-    if (!hyperlinks.empty())
+    // The rows keep count of how many of them refer to each hyperlink,
+    // so there's no need to search the rest of the buffer for them.
+    for (const auto id : hyperlinks)
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
-
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (size_t i = 1; i != total; ++i)
-        {
-            const auto nextRowRefs = GetRowByOffset(i).GetAttrRow().GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
-        }
-
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
+        if (_hyperlinkRefCounts.find(id) == _hyperlinkRefCounts.end())
         {
-            RemoveHyperlinkFromMap(hyperlinkReference);
+            RemoveHyperlinkFromMap(id);
         }
     }
 }
@@ -2174,29 +2274,78 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
             }
         }
 
-        // Loop through every character in the current row (up to
-        // the "right" boundary, which is one past the final valid
-        // character)
-        for (short iOldCol = 0; iOldCol < iRight; iOldCol++)
+        // Copy the current row (up to the "right" boundary, which is
+        // one past the final valid character) a slice at a time, each
+        // slice being as much as fits into the current row of the new
+        // buffer. This lays out the text exactly like inserting it one
+        // character at a time would, without paying for it per cell.
+        short iOldCol = 0;
+        bool fJustPadded = false;
+        while (iOldCol < iRight && SUCCEEDED(hr))
         {
-            if (iOldCol == cOldCursorPos.X && iOldRow == cOldCursorPos.Y)
-            {
-                cNewCursorPos = newCursor.GetPosition();
-                fFoundCursorPos = true;
-            }
-
             try
             {
-                // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
-                const auto glyph = row.GetCharRow().GlyphAt(iOldCol);
-                const auto dbcsAttr = row.GetCharRow().DbcsAttrAt(iOldCol);
-                const auto textAttr = row.GetAttrRow().GetAttrByColumn(iOldCol);
+                const auto newPos = newCursor.GetPosition();
+                const auto newLineWidth = newBuffer.GetLineWidth(newPos.Y);
+                const auto count = std::min<short>(iRight - iOldCol, newLineWidth - newPos.X);
 
-                if (!newBuffer.InsertCharacter(glyph, dbcsAttr, textAttr))
+                if (!fFoundCursorPos && iOldRow == cOldCursorPos.Y && cOldCursorPos.X >= iOldCol && cOldCursorPos.X < iOldCol + count)
                 {
-                    hr = E_OUTOFMEMORY;
-                    break;
+                    cNewCursorPos = { gsl::narrow_cast<SHORT>(newPos.X + cOldCursorPos.X - iOldCol), newPos.Y };
+                    fFoundCursorPos = true;
+                }
+
+                // A leading half of a double byte character doesn't fit into
+                // the final column. It's left out of this slice and instead
+                // the row gets padded, so that it starts the next one (where
+                // it goes in regardless, should that be the final column too).
+                const auto padded = !fJustPadded && charRow.DbcsAttrAt(iOldCol + count - 1).IsLeading() && newPos.X + count == newLineWidth;
+                const auto copied = gsl::narrow_cast<short>(padded ? count - 1 : count);
+
+                auto& newRow = newBuffer.GetRowByOffset(newPos.Y);
+                if (copied > 0)
+                {
+                    auto& newCharRow = newRow.GetCharRow();
+                    for (short i = 0; i < copied; ++i)
+                    {
+                        const std::wstring_view glyph = charRow.GlyphAt(iOldCol + i);
+                        newCharRow.GlyphAt(newPos.X + i) = glyph;
+                        newCharRow.DbcsAttrAt(newPos.X + i) = charRow.DbcsAttrAt(iOldCol + i);
+                    }
+
+                    // Like inserting one character at a time, the attribute
+                    // of the final character applies to the rest of the row.
+                    std::vector<TextAttributeRun> runs;
+                    for (auto col = gsl::narrow_cast<size_t>(iOldCol); col < gsl::narrow_cast<size_t>(iOldCol + copied);)
+                    {
+                        size_t applies = 0;
+                        const auto attr = row.GetAttrRow().GetAttrByColumn(col, &applies);
+                        applies = std::min(applies, gsl::narrow_cast<size_t>(iOldCol + copied) - col);
+                        runs.emplace_back(applies, attr);
+                        col += applies;
+                    }
+                    const auto newRowWidth = newRow.size();
+                    runs.back().SetLength(runs.back().GetLength() + newRowWidth - (newPos.X + copied));
+                    RETURN_IF_FAILED(newRow.GetAttrRow().InsertAttrRuns(runs, newPos.X, newRowWidth - 1, newRowWidth));
+
+                    newCursor.SetXPosition(newPos.X + copied - 1);
+                    if (!newBuffer.IncrementCursor())
+                    {
+                        hr = E_OUTOFMEMORY;
+                    }
+                }
+
+                if (padded && SUCCEEDED(hr))
+                {
+                    newRow.SetDoubleBytePadded(true);
+                    if (!newBuffer.IncrementCursor())
+                    {
+                        hr = E_OUTOFMEMORY;
+                    }
                 }
+
+                iOldCol += copied;
+                fJustPadded = padded;
             }
             CATCH_RETURN();
         }
@@ -2473,7 +2622,10 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(_currentPatternId, std::wregex{ regexString.cbegin(), regexString.cend() });
+
+    // The cached matches don't know about the new pattern yet.
+    _patternCache.clear();
     return _currentPatternId;
 }
 
@@ -2485,6 +2637,7 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 {
     _idsAndPatterns = OtherBuffer._idsAndPatterns;
     _currentPatternId = OtherBuffer._currentPatternId;
+    _patternCache = OtherBuffer._patternCache;
 }
 
 // Method Description:
@@ -2498,60 +2651,107 @@ PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) c
 {
     PointTree::interval_vector intervals;
 
-    std::wstring concatAll;
     const auto rowSize = GetRowByOffset(0).size();
-    concatAll.reserve(rowSize * (lastRow - firstRow + 1));
 
-    // to deal with text that spans multiple lines, we will first concatenate
-    // all the text into one string and find the patterns in that string
+    // The matches of every line we look at this time around. Lines that
+    // scrolled out of the region are dropped from the cache this way.
+    decltype(_patternCache) cache;
+
+    // The text of the current line, and for each of its characters the column
+    // it occupies, counted from the start of the line. The line's total width
+    // in columns is appended at the end, to convert exclusive end positions.
+    std::wstring text;
+    std::vector<size_t> columns;
+    text.reserve(rowSize);
+    columns.reserve(rowSize + 1);
+
+    // To deal with text that spans multiple lines, the rows are collected
+    // into logical lines first. Text only continues into the next row if the
+    // row was wrapped. The patterns are then matched against each line.
+    auto lineStart = firstRow;
     for (auto i = firstRow; i <= lastRow; ++i)
     {
-        auto& row = GetRowByOffset(i);
-        concatAll += row.GetText();
-    }
-
-    // for each pattern we know of, iterate through the string
-    for (const auto& idAndPattern : _idsAndPatterns)
-    {
-        std::wregex regexObj{ idAndPattern.second };
-
-        // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
-        auto words_end = std::wsregex_iterator();
+        const auto& row = GetRowByOffset(i);
+        const auto& charRow = row.GetCharRow();
+        const auto rowOffset = (i - lineStart) * rowSize;
+        for (size_t col = 0; col < charRow.size(); ++col)
+        {
+            if (!charRow.DbcsAttrAt(col).IsTrailing())
+            {
+                for (const auto wch : charRow.GlyphAt(col))
+                {
+                    text.push_back(wch);
+                    columns.push_back(rowOffset + col);
+                }
+            }
+        }
 
-        size_t lenUpToThis = 0;
-        for (auto i = words_begin; i != words_end; ++i)
+        if (row.WasWrapForced() && i < lastRow)
         {
-            // record the locations -
-            // when we find a match, the prefix is text that is between this
-            // match and the previous match, so we use the size of the prefix
-            // along with the size of the match to determine the locations
-            size_t prefixSize = 0;
+            continue;
+        }
+        columns.push_back(rowOffset + rowSize);
 
-            for (const auto ch : i->prefix().str())
+        // Only run the regexes over text we haven't seen last time.
+        auto cached = cache.find(text);
+        if (cached == cache.end())
+        {
+            if (auto node = _patternCache.extract(text))
             {
-                prefixSize += IsGlyphFullWidth(ch) ? 2 : 1;
+                cached = cache.insert(std::move(node)).position;
             }
-            const auto start = lenUpToThis + prefixSize;
-            size_t matchSize = 0;
-            for (const auto ch : i->str())
+            else
             {
-                matchSize += IsGlyphFullWidth(ch) ? 2 : 1;
+                cached = cache.emplace(text, _FindPatterns(text)).first;
             }
-            const auto end = start + matchSize;
-            lenUpToThis = end;
+        }
+
+        for (const auto& match : cached->second)
+        {
+            const auto start = columns.at(match.start);
+            const auto end = columns.at(match.end);
+            const auto lineTop = lineStart - firstRow;
 
-            const til::point startCoord{ gsl::narrow<SHORT>(start % rowSize), gsl::narrow<SHORT>(start / rowSize) };
-            const til::point endCoord{ gsl::narrow<SHORT>(end % rowSize), gsl::narrow<SHORT>(end / rowSize) };
+            const til::point startCoord{ gsl::narrow<SHORT>(start % rowSize), gsl::narrow<SHORT>(lineTop + start / rowSize) };
+            const til::point endCoord{ gsl::narrow<SHORT>(end % rowSize), gsl::narrow<SHORT>(lineTop + end / rowSize) };
 
             // store the intervals
             // NOTE: these intervals are relative to the VIEWPORT not the buffer
             // Keeping these relative to the viewport for now because its the renderer
             // that actually uses these locations and the renderer works relative to
             // the viewport
-            intervals.push_back(PointTree::interval(startCoord, endCoord, idAndPattern.first));
+            intervals.push_back(PointTree::interval(startCoord, endCoord, match.id));
         }
+
+        text.clear();
+        columns.clear();
+        lineStart = i + 1;
     }
+
+    _patternCache = std::move(cache);
+
     PointTree result(std::move(intervals));
     return result;
 }
+
+// Method Description:
+// - Matches all the patterns we know of against one line of text
+// Arguments:
+// - text - The text of the line
+// Return value:
+// - The matches found, as ranges of indices into the text
+std::vector<TextBuffer::PatternMatch> TextBuffer::_FindPatterns(const std::wstring_view text) const
+{
+    std::vector<PatternMatch> matches;
+    for (const auto& [id, regex] : _idsAndPatterns)
+    {
+        const auto begin = std::wcregex_iterator(text.data(), text.data() + text.size(), regex);
+        const auto end = std::wcregex_iterator();
+        for (auto it = begin; it != end; ++it)
+        {
+            const auto start = gsl::narrow_cast<size_t>(it->position());
+            matches.push_back({ id, start, start + gsl::narrow_cast<size_t>(it->length()) });
+        }
+    }
+    return matches;
+}
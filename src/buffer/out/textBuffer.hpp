@@ -54,6 +54,7 @@ filling in the last row, and updating the screen.
 #include "cursor.h"
 #include "Row.hpp"
 #include "TextAttribute.hpp"
+#include "TextAttributeStorage.hpp"
 #include "UnicodeStorage.hpp"
 #include "../types/inc/Viewport.hpp"
 
@@ -62,6 +63,11 @@ filling in the last row, and updating the screen.
 
 #include "../renderer/inc/IRenderTarget.hpp"
 
+namespace Microsoft::Console::Types
+{
+    class PerformanceCounters;
+}
+
 class TextBuffer final
 {
 public:
@@ -97,6 +103,8 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<size_t> limitRight = std::nullopt);
 
+    void CopyCells(const COORD source, const COORD target, const SHORT width);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -139,8 +147,12 @@ public:
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
     UnicodeStorage& GetUnicodeStorage() noexcept;
 
+    TextAttributeStorage& GetAttributeStorage() noexcept;
+
     Microsoft::Console::Render::IRenderTarget& GetRenderTarget() noexcept;
 
+    void SetPerformanceCounters(Microsoft::Console::Types::PerformanceCounters* const counters) noexcept;
+
     const COORD GetWordStart(const COORD target, const std::wstring_view wordDelimiters, bool accessibilityMode = false) const;
     const COORD GetWordEnd(const COORD target, const std::wstring_view wordDelimiters, bool accessibilityMode = false) const;
     bool MoveToNextWord(COORD& pos, const std::wstring_view wordDelimiters, COORD lastCharPos) const;
@@ -202,7 +214,16 @@ public:
 private:
     void _UpdateSize();
     Microsoft::Console::Types::Viewport _size;
+    // the number of rows referring to each hyperlink. Declared before _storage, which keeps it up to date.
+    HyperlinkRefCounts _hyperlinkRefCounts;
+    // the attributes of all rows, which refer to them by key. Declared before _storage, which refers to it.
+    TextAttributeStorage _attrStorage;
+    // the cells of all rows, in a single allocation. Each ROW's CharRow is a view into it.
+    std::vector<CharRowCell> _charBuffer;
     std::vector<ROW> _storage;
+    // the position of each row within the circular buffer, mapped to where that row sits in _storage.
+    // Scrolling a region of rows only shuffles their entries in here, rather than moving the rows themselves.
+    std::vector<SHORT> _rowMap;
     Cursor _cursor;
 
     SHORT _firstRow; // indexes top row (not necessarily 0)
@@ -216,9 +237,15 @@ private:
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId;
 
-    void _RefreshRowIDs(std::optional<SHORT> newRowWidth);
+    void _RefreshRowIDs();
+    void _ApplyRowMap();
+    void _CollectStorageIfNeeded();
+    void _CollectUnicodeStorage();
+    void _CollectAttributeStorage();
 
     Microsoft::Console::Render::IRenderTarget& _renderTarget;
+    // The counters of the terminal this buffer belongs to, if it keeps any.
+    Microsoft::Console::Types::PerformanceCounters* _performanceCounters;
 
     void _SetFirstRowIndex(const SHORT FirstRowIndex) noexcept;
 
@@ -244,11 +271,24 @@ private:
     const COORD _GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters, const COORD lastCharPos) const;
     const COORD _GetWordEndForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
 
-    void _PruneHyperlinks();
+    void _PruneHyperlinks(const std::vector<uint16_t>& hyperlinks);
 
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    struct PatternMatch
+    {
+        size_t id;
+        size_t start;
+        size_t end;
+    };
+
+    std::vector<PatternMatch> _FindPatterns(const std::wstring_view text) const;
+
+    std::unordered_map<size_t, std::wregex> _idsAndPatterns;
     size_t _currentPatternId;
 
+    // The pattern matches of each line GetPatterns looked at last time, keyed by
+    // the text of the line, so unchanged lines don't need to be searched again.
+    mutable std::unordered_map<std::wstring, std::vector<PatternMatch>> _patternCache;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
@@ -58,6 +58,7 @@ namespace WEX
 
 class AttrRowTests
 {
+    TextAttributeStorage _attrStorage;
     ATTR_ROW* pSingle;
     ATTR_ROW* pChain;
 
@@ -75,9 +76,30 @@ class AttrRowTests
 
     TEST_CLASS(AttrRowTests);
 
+    // Replaces the runs of the row with the given ones, without merging them.
+    static void _SetRuns(ATTR_ROW& row, const std::vector<TextAttributeRun>& runs)
+    {
+        row._list.clear();
+        for (const auto& run : runs)
+        {
+            row._list.emplace_back(run.GetLength(), row._attrStorage->Store(run.GetAttributes()));
+        }
+    }
+
+    // Returns the runs of the row, with their keys resolved into attributes.
+    static std::vector<TextAttributeRun> _GetRuns(const ATTR_ROW& row)
+    {
+        std::vector<TextAttributeRun> runs;
+        for (const auto& run : row._list)
+        {
+            runs.emplace_back(run.GetLength(), row._attrStorage->Get(run.GetKey()));
+        }
+        return runs;
+    }
+
     TEST_METHOD_SETUP(MethodSetup)
     {
-        pSingle = new ATTR_ROW(_sDefaultLength, _DefaultAttr);
+        pSingle = new ATTR_ROW(_sDefaultLength, _DefaultAttr, _attrStorage);
 
         // Segment length is the expected length divided by the row length
         // E.g. row of 80, 4 segments, 20 segment length each
@@ -97,13 +119,13 @@ class AttrRowTests
         }
 
         // Create the chain
-        pChain = new ATTR_ROW(_sDefaultLength, _DefaultAttr);
-        pChain->_list.resize(sChainSegmentsNeeded);
+        pChain = new ATTR_ROW(_sDefaultLength, _DefaultAttr, _attrStorage);
+        std::vector<TextAttributeRun> chain(sChainSegmentsNeeded);
 
         // Attach all chain segments that are even multiples of the row length
         for (short iChain = 0; iChain < _sDefaultChainLength; iChain++)
         {
-            TextAttributeRun* pRun = &pChain->_list[iChain];
+            TextAttributeRun* pRun = &chain[iChain];
 
             pRun->SetAttributes(TextAttribute{ gsl::narrow_cast<WORD>(iChain) }); // Just use the chain position as the value
             pRun->SetLength(sChainSegLength);
@@ -113,12 +135,14 @@ class AttrRowTests
         {
             // If we had a leftover, then this chain is one longer than we expected (the default length)
             // So use it as the index (because indices start at 0)
-            TextAttributeRun* pRun = &pChain->_list[_sDefaultChainLength];
+            TextAttributeRun* pRun = &chain[_sDefaultChainLength];
 
             pRun->SetAttributes(_DefaultChainAttr);
             pRun->SetLength(sChainLeftover);
         }
 
+        _SetRuns(*pChain, chain);
+
         return true;
     }
 
@@ -146,9 +170,10 @@ class AttrRowTests
 
             pUnderTest->Reset(attr);
 
-            VERIFY_ARE_EQUAL(pUnderTest->_list.size(), 1u);
-            VERIFY_ARE_EQUAL(pUnderTest->_list[0].GetAttributes(), attr);
-            VERIFY_ARE_EQUAL(pUnderTest->_list[0].GetLength(), (unsigned int)_sDefaultLength);
+            const auto runs = _GetRuns(*pUnderTest);
+            VERIFY_ARE_EQUAL(runs.size(), 1u);
+            VERIFY_ARE_EQUAL(runs[0].GetAttributes(), attr);
+            VERIFY_ARE_EQUAL(runs[0].GetLength(), (unsigned int)_sDefaultLength);
         }
     }
 
@@ -215,31 +240,13 @@ class AttrRowTests
         return S_OK;
     }
 
-    NoThrowString LogRunElement(_In_ TextAttributeRun& run)
+    NoThrowString LogRunElement(_In_ const TextAttributeRun& run)
     {
         return NoThrowString().Format(L"%wc%d", run.GetAttributes().GetLegacyAttributes(), run.GetLength());
     }
 
     void LogChain(_In_ PCWSTR pwszPrefix,
-                  boost::container::small_vector_base<TextAttributeRun>& chain)
-    {
-        NoThrowString str(pwszPrefix);
-
-        if (chain.size() > 0)
-        {
-            str.Append(LogRunElement(chain[0]));
-
-            for (size_t i = 1; i < chain.size(); i++)
-            {
-                str.AppendFormat(L"->%s", (const wchar_t*)(LogRunElement(chain[i])));
-            }
-        }
-
-        Log::Comment(str);
-    }
-
-    void LogChain(_In_ PCWSTR pwszPrefix,
-                  std::vector<TextAttributeRun>& chain)
+                  const std::vector<TextAttributeRun>& chain)
     {
         NoThrowString str(pwszPrefix);
 
@@ -269,16 +276,10 @@ class AttrRowTests
 
         // Set up our "original row" that we are going to try to insert into.
         // This will represent a 10 column run of R3->B5->G2 that we will use for all tests.
-        ATTR_ROW originalRow{ static_cast<UINT>(_sDefaultLength), _DefaultAttr };
-        originalRow._list.resize(3);
+        ATTR_ROW originalRow{ static_cast<UINT>(_sDefaultLength), _DefaultAttr, _attrStorage };
         originalRow._cchRowWidth = 10;
-        originalRow._list[0].SetAttributes(TextAttribute{ 'R' });
-        originalRow._list[0].SetLength(3);
-        originalRow._list[1].SetAttributes(TextAttribute{ 'B' });
-        originalRow._list[1].SetLength(5);
-        originalRow._list[2].SetAttributes(TextAttribute{ 'G' });
-        originalRow._list[2].SetLength(2);
-        LogChain(L"Original: ", originalRow._list);
+        _SetRuns(originalRow, { { 3, TextAttribute{ 'R' } }, { 5, TextAttribute{ 'B' } }, { 2, TextAttribute{ 'G' } } });
+        LogChain(L"Original: ", _GetRuns(originalRow));
 
         // Set up our "insertion run"
         size_t cInsertRow = 1;
@@ -350,17 +351,18 @@ class AttrRowTests
         VERIFY_SUCCEEDED(originalRow.InsertAttrRuns({ insertRow.data(), insertRow.size() }, uiStartPos, uiEndPos, (UINT)originalRow._cchRowWidth));
 
         // Compare and ensure that the expected and actual match.
-        VERIFY_ARE_EQUAL(cPackedRun, originalRow._list.size(), L"Ensure that number of array elements required for RLE are the same.");
+        const auto actualRuns = _GetRuns(originalRow);
+        VERIFY_ARE_EQUAL(cPackedRun, actualRuns.size(), L"Ensure that number of array elements required for RLE are the same.");
 
         std::vector<TextAttributeRun> packedRunExpected;
         std::copy_n(packedRun.get(), cPackedRun, std::back_inserter(packedRunExpected));
 
         LogChain(L"Expected: ", packedRunExpected);
-        LogChain(L"Actual: ", originalRow._list);
+        LogChain(L"Actual: ", actualRuns);
 
         for (size_t testIndex = 0; testIndex < cPackedRun; testIndex++)
         {
-            VERIFY_ARE_EQUAL(packedRun[testIndex], originalRow._list[testIndex]);
+            VERIFY_ARE_EQUAL(packedRun[testIndex], actualRuns[testIndex]);
         }
     }
 
@@ -542,29 +544,23 @@ class AttrRowTests
         Log::Comment(L"Reverse iterate through ubuntu prompt");
         {
             // Create attr row representing a buffer that's 121 wide.
-            auto chain = std::make_unique<ATTR_ROW>(121, _DefaultAttr);
+            auto chain = std::make_unique<ATTR_ROW>(121, _DefaultAttr, _attrStorage);
 
             // The repro case had 4 chain segments.
-            chain->_list.resize(4);
-
-            // The color 10 went for the first 18.
-            chain->_list[0].SetAttributes(TextAttribute(0xA));
-            chain->_list[0].SetLength(18);
-
-            // Default color for the next 1
-            chain->_list[1].SetAttributes(TextAttribute());
-            chain->_list[1].SetLength(1);
-
-            // Color 12 for the next 29
-            chain->_list[2].SetAttributes(TextAttribute(0xC));
-            chain->_list[2].SetLength(29);
-
-            // Then default color to end the run
-            chain->_list[3].SetAttributes(TextAttribute());
-            chain->_list[3].SetLength(73);
+            _SetRuns(*chain,
+                     {
+                         // The color 10 went for the first 18.
+                         { 18, TextAttribute(0xA) },
+                         // Default color for the next 1
+                         { 1, TextAttribute() },
+                         // Color 12 for the next 29
+                         { 29, TextAttribute(0xC) },
+                         // Then default color to end the run
+                         { 73, TextAttribute() },
+                     });
 
             // The sum of the lengths should be 121.
-            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength + chain->_list[3]._cchLength);
+            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0].GetLength() + chain->_list[1].GetLength() + chain->_list[2].GetLength() + chain->_list[3].GetLength());
 
             auto index = chain->_list[0].GetLength();
             auto stepSize = 1;
@@ -574,25 +570,21 @@ class AttrRowTests
         Log::Comment(L"Reverse iterate across a text run in the chain");
         {
             // Create attr row representing a buffer that's 3 wide.
-            auto chain = std::make_unique<ATTR_ROW>(3, _DefaultAttr);
+            auto chain = std::make_unique<ATTR_ROW>(3, _DefaultAttr, _attrStorage);
 
             // The repro case had 3 chain segments.
-            chain->_list.resize(3);
-
-            // The color 10 went for the first 1.
-            chain->_list[0].SetAttributes(TextAttribute(0xA));
-            chain->_list[0].SetLength(1);
-
-            // The color 11 for the next 1
-            chain->_list[1].SetAttributes(TextAttribute(0xB));
-            chain->_list[1].SetLength(1);
-
-            // Color 12 for the next 1
-            chain->_list[2].SetAttributes(TextAttribute(0xC));
-            chain->_list[2].SetLength(1);
+            _SetRuns(*chain,
+                     {
+                         // The color 10 went for the first 1.
+                         { 1, TextAttribute(0xA) },
+                         // The color 11 for the next 1
+                         { 1, TextAttribute(0xB) },
+                         // Color 12 for the next 1
+                         { 1, TextAttribute(0xC) },
+                     });
 
             // The sum of the lengths should be 3.
-            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength);
+            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0].GetLength() + chain->_list[1].GetLength() + chain->_list[2].GetLength());
 
             // on 'ABC', step from B to A
             auto index = 1;
@@ -603,25 +595,21 @@ class AttrRowTests
         Log::Comment(L"Reverse iterate across two text runs in the chain");
         {
             // Create attr row representing a buffer that's 3 wide.
-            auto chain = std::make_unique<ATTR_ROW>(3, _DefaultAttr);
+            auto chain = std::make_unique<ATTR_ROW>(3, _DefaultAttr, _attrStorage);
 
             // The repro case had 3 chain segments.
-            chain->_list.resize(3);
-
-            // The color 10 went for the first 1.
-            chain->_list[0].SetAttributes(TextAttribute(0xA));
-            chain->_list[0].SetLength(1);
-
-            // The color 11 for the next 1
-            chain->_list[1].SetAttributes(TextAttribute(0xB));
-            chain->_list[1].SetLength(1);
-
-            // Color 12 for the next 1
-            chain->_list[2].SetAttributes(TextAttribute(0xC));
-            chain->_list[2].SetLength(1);
+            _SetRuns(*chain,
+                     {
+                         // The color 10 went for the first 1.
+                         { 1, TextAttribute(0xA) },
+                         // The color 11 for the next 1
+                         { 1, TextAttribute(0xB) },
+                         // Color 12 for the next 1
+                         { 1, TextAttribute(0xC) },
+                     });
 
             // The sum of the lengths should be 3.
-            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0]._cchLength + chain->_list[1]._cchLength + chain->_list[2]._cchLength);
+            VERIFY_ARE_EQUAL(chain->_cchRowWidth, chain->_list[0].GetLength() + chain->_list[1].GetLength() + chain->_list[2].GetLength());
 
             // on 'ABC', step from C to A
             auto index = 2;
@@ -643,35 +631,37 @@ class AttrRowTests
         pSingle->SetAttrToEnd(iTestIndex, TestAttr);
 
         // Was 1 (single), should now have 2 segments
-        VERIFY_ARE_EQUAL(pSingle->_list.size(), 2u);
+        const auto singleRuns = _GetRuns(*pSingle);
+        VERIFY_ARE_EQUAL(singleRuns.size(), 2u);
 
-        VERIFY_ARE_EQUAL(pSingle->_list[0].GetAttributes(), _DefaultAttr);
-        VERIFY_ARE_EQUAL(pSingle->_list[0].GetLength(), (unsigned int)(_sDefaultLength - (_sDefaultLength - iTestIndex)));
+        VERIFY_ARE_EQUAL(singleRuns[0].GetAttributes(), _DefaultAttr);
+        VERIFY_ARE_EQUAL(singleRuns[0].GetLength(), (unsigned int)(_sDefaultLength - (_sDefaultLength - iTestIndex)));
 
-        VERIFY_ARE_EQUAL(pSingle->_list[1].GetAttributes(), TestAttr);
-        VERIFY_ARE_EQUAL(pSingle->_list[1].GetLength(), (unsigned int)(_sDefaultLength - iTestIndex));
+        VERIFY_ARE_EQUAL(singleRuns[1].GetAttributes(), TestAttr);
+        VERIFY_ARE_EQUAL(singleRuns[1].GetLength(), (unsigned int)(_sDefaultLength - iTestIndex));
 
         Log::Comment(L"SetAttrToEnd for existing chain of multiple colors.");
         pChain->SetAttrToEnd(iTestIndex, TestAttr);
 
         // From 7 segments down to 5.
-        VERIFY_ARE_EQUAL(pChain->_list.size(), 5u);
+        const auto chainRuns = _GetRuns(*pChain);
+        VERIFY_ARE_EQUAL(chainRuns.size(), 5u);
 
         // Verify chain colors and lengths
-        VERIFY_ARE_EQUAL(TextAttribute(0), pChain->_list[0].GetAttributes());
-        VERIFY_ARE_EQUAL(pChain->_list[0].GetLength(), (unsigned int)13);
+        VERIFY_ARE_EQUAL(TextAttribute(0), chainRuns[0].GetAttributes());
+        VERIFY_ARE_EQUAL(chainRuns[0].GetLength(), (unsigned int)13);
 
-        VERIFY_ARE_EQUAL(TextAttribute(1), pChain->_list[1].GetAttributes());
-        VERIFY_ARE_EQUAL(pChain->_list[1].GetLength(), (unsigned int)13);
+        VERIFY_ARE_EQUAL(TextAttribute(1), chainRuns[1].GetAttributes());
+        VERIFY_ARE_EQUAL(chainRuns[1].GetLength(), (unsigned int)13);
 
-        VERIFY_ARE_EQUAL(TextAttribute(2), pChain->_list[2].GetAttributes());
-        VERIFY_ARE_EQUAL(pChain->_list[2].GetLength(), (unsigned int)13);
+        VERIFY_ARE_EQUAL(TextAttribute(2), chainRuns[2].GetAttributes());
+        VERIFY_ARE_EQUAL(chainRuns[2].GetLength(), (unsigned int)13);
 
-        VERIFY_ARE_EQUAL(TextAttribute(3), pChain->_list[3].GetAttributes());
-        VERIFY_ARE_EQUAL(pChain->_list[3].GetLength(), (unsigned int)11);
+        VERIFY_ARE_EQUAL(TextAttribute(3), chainRuns[3].GetAttributes());
+        VERIFY_ARE_EQUAL(chainRuns[3].GetLength(), (unsigned int)11);
 
-        VERIFY_ARE_EQUAL(TestAttr, pChain->_list[4].GetAttributes());
-        VERIFY_ARE_EQUAL(pChain->_list[4].GetLength(), (unsigned int)30);
+        VERIFY_ARE_EQUAL(TestAttr, chainRuns[4].GetAttributes());
+        VERIFY_ARE_EQUAL(chainRuns[4].GetLength(), (unsigned int)30);
 
         Log::Comment(L"SECOND: Set index to 0 to test replacing anything with a single");
 
@@ -684,13 +674,14 @@ class AttrRowTests
             pUnderTest->SetAttrToEnd(0, TestAttr);
 
             // should be down to 1 attribute set from beginning to end of string
-            VERIFY_ARE_EQUAL(pUnderTest->_list.size(), 1u);
+            const auto runs = _GetRuns(*pUnderTest);
+            VERIFY_ARE_EQUAL(runs.size(), 1u);
 
             // singular pair should contain the color
-            VERIFY_ARE_EQUAL(pUnderTest->_list[0].GetAttributes(), TestAttr);
+            VERIFY_ARE_EQUAL(runs[0].GetAttributes(), TestAttr);
 
             // and its length should be the length of the whole string
-            VERIFY_ARE_EQUAL(pUnderTest->_list[0].GetLength(), (unsigned int)_sDefaultLength);
+            VERIFY_ARE_EQUAL(runs[0].GetLength(), (unsigned int)_sDefaultLength);
         }
     }
 
@@ -728,4 +719,72 @@ class AttrRowTests
         VERIFY_THROWS_SPECIFIC(pSingle->Resize(0), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
         VERIFY_THROWS_SPECIFIC(pChain->Resize(0), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
     }
+
+    TEST_METHOD(TestCopyAttrs)
+    {
+        const TextAttribute red{ FOREGROUND_RED };
+        const TextAttribute green{ FOREGROUND_GREEN };
+        const TextAttribute blue{ FOREGROUND_BLUE };
+        const TextAttribute yellow{ FOREGROUND_RED | FOREGROUND_GREEN };
+
+        ATTR_ROW row{ 10, red, _attrStorage };
+        _SetRuns(row, { { 3, red }, { 5, green }, { 2, blue } });
+        ATTR_ROW other{ 10, yellow, _attrStorage };
+
+        const auto verifyRuns = [&](const std::vector<TextAttributeRun>& expected) {
+            const auto actual = _GetRuns(row);
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                VERIFY_ARE_EQUAL(expected.at(i), actual.at(i));
+            }
+        };
+
+        Log::Comment(L"Copy to the right, overlapping the source within the same row.");
+        row.CopyAttrs(row, 0, 2, 6);
+        verifyRuns({ { 5, red }, { 3, green }, { 2, blue } });
+
+        Log::Comment(L"Copy from another row up to the end of this one.");
+        row.CopyAttrs(other, 4, 7, 3);
+        verifyRuns({ { 5, red }, { 2, green }, { 3, yellow } });
+
+        Log::Comment(L"Copy to the left, overlapping the source within the same row.");
+        row.CopyAttrs(row, 5, 0, 5);
+        verifyRuns({ { 2, green }, { 3, yellow }, { 2, green }, { 3, yellow } });
+
+        Log::Comment(L"Spans that don't fit into their row are rejected.");
+        VERIFY_THROWS_SPECIFIC(row.CopyAttrs(other, 8, 0, 3), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+        VERIFY_THROWS_SPECIFIC(row.CopyAttrs(other, 0, 8, 3), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
+    }
+
+    TEST_METHOD(TestAttributesBeyond16BitKeys)
+    {
+        TextAttributeStorage storage;
+        const TextAttribute red{ FOREGROUND_RED };
+
+        Log::Comment(L"Use up the first 65536 keys with distinct colors, like truecolor output in a long scrollback.");
+        for (auto i = storage.capacity(); i <= 0xFFFF; ++i)
+        {
+            TextAttribute attr;
+            attr.SetForeground(gsl::narrow_cast<COLORREF>(i));
+            storage.Store(attr);
+        }
+
+        TextAttribute overflow;
+        overflow.SetForeground(RGB(0xff, 0xff, 0xff));
+
+        ATTR_ROW row{ 10, red, storage };
+        VERIFY_IS_TRUE(row.SetAttrToEnd(4, overflow));
+
+        Log::Comment(L"The attribute comes back out of the row as it went in.");
+        VERIFY_ARE_EQUAL(red, row.GetAttrByColumn(3));
+        VERIFY_ARE_EQUAL(overflow, row.GetAttrByColumn(4));
+        VERIFY_ARE_EQUAL(overflow, row.GetAttrByColumn(9));
+
+        Log::Comment(L"It survives being copied within the row, too.");
+        row.CopyAttrs(row, 6, 0, 2);
+        VERIFY_ARE_EQUAL(overflow, row.GetAttrByColumn(0));
+        VERIFY_ARE_EQUAL(overflow, row.GetAttrByColumn(1));
+        VERIFY_ARE_EQUAL(red, row.GetAttrByColumn(2));
+    }
 };
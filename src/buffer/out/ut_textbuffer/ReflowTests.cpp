@@ -289,6 +289,35 @@ namespace
                 },
             },
         },
+        TestCase{
+            L"DBCS, cursor on a character that is padded onto the next row",
+            {
+                TestBuffer{
+                    { 6, 5 },
+                    {
+                        //--0123456--
+                        { L"カタカ", true }, // KA TA KA
+                        { L"ナ$   ", false }, // NA
+                        { L"      ", false },
+                        { L"      ", false },
+                        { L"      ", false },
+                    },
+                    { 4, 0 } // cursor on the second KA
+                },
+                TestBuffer{
+                    { 5, 5 }, // reduce width by 1
+                    {
+                        //--012345--
+                        { L"カタ ", true }, // KA TA [FORCED SPACER]
+                        { L"カナ$", true_due_to_exact_wrap_bug }, // KA NA
+                        { L"     ", false },
+                        { L"     ", false },
+                        { L"     ", false },
+                    },
+                    { 4, 0 } // [BUG] cursor on the spacer instead of the second KA
+                },
+            },
+        },
         TestCase{
             L"SBCS, cursor remains in buffer, with circling, no original wrap",
             {
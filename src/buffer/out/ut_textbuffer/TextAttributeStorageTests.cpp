@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../TextAttributeStorage.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextAttributeStorageTests
+{
+    TEST_CLASS(TextAttributeStorageTests);
+
+    TEST_METHOD(StoresEachAttributeOnce)
+    {
+        TextAttributeStorage storage;
+        const TextAttribute red{ FOREGROUND_RED };
+        const TextAttribute blue{ FOREGROUND_BLUE };
+
+        // the default attributes are always there
+        VERIFY_ARE_EQUAL(TextAttribute{}, storage.Get(TextAttributeStorage::DefaultKey));
+        VERIFY_ARE_EQUAL(TextAttributeStorage::DefaultKey, storage.Store(TextAttribute{}));
+        VERIFY_ARE_EQUAL(1u, storage.size());
+
+        // storing an attribute again hands out the same key
+        const auto redKey = storage.Store(red);
+        VERIFY_ARE_EQUAL(red, storage.Get(redKey));
+        VERIFY_ARE_EQUAL(redKey, storage.Store(red));
+        VERIFY_ARE_EQUAL(redKey, storage.Find(red).value());
+
+        // a different attribute gets a different key
+        VERIFY_IS_FALSE(storage.Find(blue).has_value());
+        const auto blueKey = storage.Store(blue);
+        VERIFY_ARE_NOT_EQUAL(redKey, blueKey);
+        VERIFY_ARE_EQUAL(blue, storage.Get(blueKey));
+        VERIFY_ARE_EQUAL(red, storage.Get(redKey));
+        VERIFY_ARE_EQUAL(3u, storage.size());
+    }
+
+    TEST_METHOD(CollectReleasesUnusedAttributes)
+    {
+        TextAttributeStorage storage;
+        const TextAttribute red{ FOREGROUND_RED };
+        const TextAttribute blue{ FOREGROUND_BLUE };
+        const TextAttribute green{ FOREGROUND_GREEN };
+
+        const auto redKey = storage.Store(red);
+        const auto blueKey = storage.Store(blue);
+
+        // only blue is still in use, the default attributes are kept regardless
+        std::vector<bool> liveKeys(storage.capacity());
+        liveKeys.at(blueKey) = true;
+        storage.Collect(liveKeys);
+
+        VERIFY_ARE_EQUAL(2u, storage.size());
+        VERIFY_IS_FALSE(storage.Find(red).has_value());
+        VERIFY_ARE_EQUAL(blue, storage.Get(blueKey));
+        VERIFY_ARE_EQUAL(TextAttribute{}, storage.Get(TextAttributeStorage::DefaultKey));
+
+        // the released key gets reused for the next new attribute
+        VERIFY_ARE_EQUAL(redKey, storage.Store(green));
+        VERIFY_ARE_EQUAL(green, storage.Get(redKey));
+        VERIFY_ARE_EQUAL(3u, storage.capacity());
+    }
+
+    TEST_METHOD(StoresMoreThan16BitsOfAttributes)
+    {
+        TextAttributeStorage storage;
+
+        // truecolor output easily uses more than 65536 distinct colors
+        for (size_t i = storage.capacity(); i <= 0x10000; ++i)
+        {
+            TextAttribute attr;
+            attr.SetForeground(gsl::narrow_cast<COLORREF>(i));
+            VERIFY_ARE_EQUAL(i, size_t{ storage.Store(attr) });
+        }
+
+        TextAttribute overflow;
+        overflow.SetForeground(RGB(0xff, 0xff, 0xff));
+        const auto key = storage.Store(overflow);
+        VERIFY_ARE_EQUAL(0x10001u, key);
+        VERIFY_ARE_EQUAL(overflow, storage.Get(key));
+        VERIFY_ARE_EQUAL(key, storage.Find(overflow).value());
+    }
+
+    TEST_METHOD(CollectionBacksOffWhenNothingIsFreed)
+    {
+        TextAttributeStorage storage;
+
+        const auto storeDistinct = [&](const size_t count) {
+            for (size_t i = 0; i < count; ++i)
+            {
+                TextAttribute attr;
+                attr.SetForeground(gsl::narrow_cast<COLORREF>(storage.capacity()));
+                storage.Store(attr);
+            }
+        };
+
+        storeDistinct(2000);
+        VERIFY_IS_TRUE(storage.NeedsCollection());
+
+        // every attribute is still in use, so nothing gets freed
+        storage.Collect(std::vector<bool>(storage.capacity(), true));
+        VERIFY_ARE_EQUAL(2001u, storage.size());
+
+        // the next collection is only due once the storage has doubled
+        VERIFY_IS_FALSE(storage.NeedsCollection());
+        storeDistinct(2000);
+        VERIFY_IS_FALSE(storage.NeedsCollection());
+        storeDistinct(1);
+        VERIFY_IS_TRUE(storage.NeedsCollection());
+    }
+};
@@ -15,37 +15,83 @@ class UnicodeStorageTests
 {
     TEST_CLASS(UnicodeStorageTests);
 
-    TEST_METHOD(CanOverwriteEmoji)
+    TEST_METHOD(StoresEachGlyphOnce)
     {
         UnicodeStorage storage;
-        const COORD coord{ 1, 3 };
-        const std::vector<wchar_t> newMoon{ 0xD83C, 0xDF11 };
-        const std::vector<wchar_t> fullMoon{ 0xD83C, 0xDF15 };
+        const std::wstring_view newMoon{ L"\xD83C\xDF11" };
+        const std::wstring_view fullMoon{ L"\xD83C\xDF15" };
 
         // store initial glyph
-        storage.StoreGlyph(coord, newMoon);
-
-        // verify it was stored
-        auto findIt = storage._map.find(coord);
-        VERIFY_ARE_NOT_EQUAL(findIt, storage._map.end());
-        const std::vector<wchar_t>& newMoonGlyph = findIt->second;
-        VERIFY_ARE_EQUAL(newMoonGlyph.size(), newMoon.size());
-        for (size_t i = 0; i < newMoon.size(); ++i)
-        {
-            VERIFY_ARE_EQUAL(newMoonGlyph.at(i), newMoon.at(i));
-        }
-
-        // overwrite it
-        storage.StoreGlyph(coord, fullMoon);
-
-        // verify the glyph was overwritten
-        findIt = storage._map.find(coord);
-        VERIFY_ARE_NOT_EQUAL(findIt, storage._map.end());
-        const std::vector<wchar_t>& fullMoonGlyph = findIt->second;
-        VERIFY_ARE_EQUAL(fullMoonGlyph.size(), fullMoon.size());
-        for (size_t i = 0; i < fullMoon.size(); ++i)
-        {
-            VERIFY_ARE_EQUAL(fullMoonGlyph.at(i), fullMoon.at(i));
-        }
+        const auto newMoonKey = storage.StoreGlyph(newMoon);
+        VERIFY_IS_TRUE(newMoonKey.has_value());
+        VERIFY_ARE_EQUAL(newMoon, std::wstring_view{ storage.GetText(*newMoonKey) });
+
+        // storing it again hands out the same key
+        VERIFY_ARE_EQUAL(*newMoonKey, storage.StoreGlyph(newMoon).value());
+        VERIFY_ARE_EQUAL(1u, storage.size());
+
+        // a different glyph gets a different key
+        const auto fullMoonKey = storage.StoreGlyph(fullMoon);
+        VERIFY_IS_TRUE(fullMoonKey.has_value());
+        VERIFY_ARE_NOT_EQUAL(*newMoonKey, *fullMoonKey);
+        VERIFY_ARE_EQUAL(fullMoon, std::wstring_view{ storage.GetText(*fullMoonKey) });
+        VERIFY_ARE_EQUAL(newMoon, std::wstring_view{ storage.GetText(*newMoonKey) });
+        VERIFY_ARE_EQUAL(2u, storage.size());
+    }
+
+    TEST_METHOD(CollectReleasesUnusedGlyphs)
+    {
+        UnicodeStorage storage;
+        const std::wstring_view newMoon{ L"\xD83C\xDF11" };
+        const std::wstring_view fullMoon{ L"\xD83C\xDF15" };
+        const std::wstring_view fire{ L"\xD83D\xDD25" };
+
+        const auto newMoonKey = storage.StoreGlyph(newMoon).value();
+        const auto fullMoonKey = storage.StoreGlyph(fullMoon).value();
+
+        // only the full moon is still in use
+        std::vector<bool> liveKeys(storage.capacity());
+        liveKeys.at(fullMoonKey) = true;
+        storage.Collect(liveKeys);
+
+        VERIFY_ARE_EQUAL(1u, storage.size());
+        VERIFY_ARE_EQUAL(fullMoon, std::wstring_view{ storage.GetText(fullMoonKey) });
+
+        // the released key gets reused for the next new glyph
+        VERIFY_ARE_EQUAL(newMoonKey, storage.StoreGlyph(fire).value());
+        VERIFY_ARE_EQUAL(fire, std::wstring_view{ storage.GetText(newMoonKey) });
+        VERIFY_ARE_EQUAL(2u, storage.capacity());
+    }
+
+    TEST_METHOD(CollectionBacksOffWhenFull)
+    {
+        UnicodeStorage storage;
+
+        size_t next = 0;
+        const auto storeDistinct = [&](const size_t count) {
+            for (size_t i = 0; i < count; ++i, ++next)
+            {
+                const auto glyph = std::to_wstring(next);
+                storage.StoreGlyph(glyph);
+            }
+        };
+
+        // fill the storage up completely, and then some
+        storeDistinct(0x10000);
+        VERIFY_ARE_EQUAL(0x10000u, storage.size());
+        VERIFY_IS_FALSE(storage.StoreGlyph(L"full").has_value());
+        VERIFY_IS_TRUE(storage.NeedsCollection());
+
+        // every glyph is still in use, so nothing gets freed
+        storage.Collect(std::vector<bool>(storage.capacity(), true));
+        VERIFY_ARE_EQUAL(0x10000u, storage.size());
+
+        // the storage stays full, but the next collection is only due
+        // once as many new glyphs have been stored as it holds
+        VERIFY_IS_FALSE(storage.NeedsCollection());
+        storeDistinct(0xFFFF);
+        VERIFY_IS_FALSE(storage.NeedsCollection());
+        storeDistinct(1);
+        VERIFY_IS_TRUE(storage.NeedsCollection());
     }
 };
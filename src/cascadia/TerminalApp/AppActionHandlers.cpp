@@ -743,6 +743,28 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    void TerminalPage::_HandleDumpPerformanceCounters(const IInspectable& /*sender*/,
+                                                      const ActionEventArgs& args)
+    {
+        if (const auto& control{ _GetActiveControl() })
+        {
+            // The counters of the focused pane go to the clipboard, so they can
+            // be pasted into a bug report or compared against a later dump.
+            DataPackage dataPack{};
+            dataPack.RequestedOperation(DataPackageOperation::Copy);
+            dataPack.SetText(control.DumpPerformanceCounters());
+
+            try
+            {
+                Clipboard::SetContent(dataPack);
+                Clipboard::Flush();
+            }
+            CATCH_LOG();
+
+            args.Handled(true);
+        }
+    }
+
     void TerminalPage::_HandleOpenWindowRenamer(const IInspectable& /*sender*/,
                                                 const ActionEventArgs& args)
     {
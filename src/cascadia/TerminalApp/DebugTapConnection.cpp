@@ -91,7 +91,7 @@ namespace winrt::Microsoft::TerminalApp::implementation
         return ConnectionState::Failed;
     }
 
-    void DebugTapConnection::_OutputHandler(const hstring str)
+    void DebugTapConnection::_OutputHandler(const hstring& str)
     {
         _TerminalOutputHandlers(til::visualize_control_codes(str));
     }
@@ -17,6 +17,11 @@
 
 using namespace ::Microsoft::Console;
 
+// How much output the reader thread may queue up before it has to wait for the output thread.
+static constexpr uint32_t OutputChannelCapacity = 1024 * 1024;
+// The largest batch of output the output thread passes on to the terminal at once.
+static constexpr size_t OutputBatchSize = 128 * 1024;
+
 // Notes:
 // There is a number of ways that the Conpty connection can be terminated (voluntarily or not):
 // 1. The connection is Close()d
@@ -258,6 +263,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         _startTime = std::chrono::high_resolution_clock::now();
 
+        // The reader thread does nothing but drain the output pipe, while the output thread
+        // decodes what was read and passes it on in batches as large as the reader is ahead.
+        // Under a flood of output the terminal is thus locked once per batch instead of once per read,
+        // and the channel's capacity keeps the reader from getting too far ahead of the terminal.
+        std::tie(_outputProducer, _outputConsumer) = til::spsc::channel<char>(OutputChannelCapacity);
+
         // Create our own output handling thread
         // This must be done after the pipes are populated.
         // Each connection needs to make sure to drain the output from its backing host.
@@ -280,6 +291,25 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
 
+        _hReaderThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                ConptyConnection* const pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_ReaderThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hReaderThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hReaderThread.get(), L"ConptyConnection Reader Thread"));
+
         _clientExitWait.reset(CreateThreadpoolWait(
             [](PTP_CALLBACK_INSTANCE /*callbackInstance*/, PVOID context, PTP_WAIT /*wait*/, TP_WAIT_RESULT /*waitResult*/) noexcept {
                 ConptyConnection* const pInstance = static_cast<ConptyConnection*>(context);
@@ -306,6 +336,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         // Tear down any state we may have accumulated.
         _hPC.reset();
+
+        // If the reader thread didn't start, let the output thread know that no output is coming.
+        if (!_hReaderThread)
+        {
+            _outputProducer = til::spsc::producer<char>{ nullptr };
+        }
     }
 
     // Method Description:
@@ -403,6 +439,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _hOutputThread.reset();
             }
 
+            if (_hReaderThread)
+            {
+                LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hReaderThread.get(), INFINITE));
+                _hReaderThread.reset();
+            }
+
             if (_piClient.hProcess)
             {
                 // Wait for the client to terminate (which it should do successfully)
@@ -415,13 +457,21 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
     CATCH_LOG()
 
-    DWORD ConptyConnection::_OutputThread()
+    // Method Description:
+    // - Reads the output of the pseudoconsole and passes it on to the output thread,
+    //   until the output pipe breaks or the output thread exits.
+    DWORD ConptyConnection::_ReaderThread()
     {
-        // Keep us alive until the output thread terminates; the destructor
-        // won't wait for us, and the known exit points _do_.
+        // Keep us alive until the reader thread terminates, just like the output thread.
         auto strongThis{ get_strong() };
 
-        // process the data of the output pipe in a loop
+        // Dropping the producer lets the output thread know that no more output is coming.
+        const auto dropProducer = wil::scope_exit([&]() noexcept {
+            // The output thread reads _readError after it has seen the producer being dropped.
+            std::atomic_thread_fence(std::memory_order_release);
+            _outputProducer = til::spsc::producer<char>{ nullptr };
+        });
+
         while (true)
         {
             DWORD read{};
@@ -430,17 +480,59 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             if (readFail) // reading failed (we must check this first, because read will also be 0.)
             {
                 const auto lastError = GetLastError();
-                if (lastError != ERROR_BROKEN_PIPE && !_isStateAtOrBeyond(ConnectionState::Closing))
+                if (lastError != ERROR_BROKEN_PIPE)
+                {
+                    // The output thread reports the failure, once it passed on everything we read before.
+                    _readError = HRESULT_FROM_WIN32(lastError);
+                }
+                return 0;
+            }
+
+            if (read == 0)
+            {
+                return 0;
+            }
+
+            // This blocks while the channel is full, until the output thread catches up.
+            if (!_outputProducer.push(_buffer.data(), _buffer.data() + read).second)
+            {
+                // The output thread exited.
+                return 0;
+            }
+        }
+    }
+
+    DWORD ConptyConnection::_OutputThread()
+    {
+        // Keep us alive until the output thread terminates; the destructor
+        // won't wait for us, and the known exit points _do_.
+        auto strongThis{ get_strong() };
+
+        // Dropping the consumer unblocks the reader thread, in case we exit early.
+        const auto dropConsumer = wil::scope_exit([&]() noexcept {
+            _outputConsumer = til::spsc::consumer<char>{ nullptr };
+        });
+
+        std::vector<char> batch(OutputBatchSize);
+
+        // process the output of the reader thread in a loop
+        while (true)
+        {
+            // Wait for some output and take everything else that's already there along with it.
+            const auto read = _outputConsumer.pop_n(til::spsc::block_initially, batch.data(), batch.size()).first;
+            if (read == 0) // the reader thread is done and we processed everything it read.
+            {
+                if (FAILED(_readError) && !_isStateAtOrBeyond(ConnectionState::Closing))
                 {
                     // EXIT POINT
-                    _indicateExitWithStatus(HRESULT_FROM_WIN32(lastError)); // print a message
+                    _indicateExitWithStatus(_readError); // print a message
                     _transitionToState(ConnectionState::Failed);
-                    return gsl::narrow_cast<DWORD>(HRESULT_FROM_WIN32(lastError));
+                    return gsl::narrow_cast<DWORD>(_readError);
                 }
                 // else we call convertUTF8ChunkToUTF16 with an empty string_view to convert possible remaining partials to U+FFFD
             }
 
-            const HRESULT result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
+            const HRESULT result{ til::u8u16(std::string_view{ batch.data(), read }, _u16Str, _u8State) };
             if (FAILED(result))
             {
                 if (_isStateAtOrBeyond(ConnectionState::Closing))
@@ -476,7 +568,10 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _receivedFirstByte = true;
             }
 
-            // Pass the output to our registered event handlers
+            // Pass the output to our registered event handlers. A std::wstring is passed
+            // to them as a reference to its null-terminated buffer instead of a copy.
+            // The handlers are done with it by the time they return, so _u16Str
+            // is reused for the next batch without any allocation in between.
             _TerminalOutputHandlers(_u16Str);
         }
 
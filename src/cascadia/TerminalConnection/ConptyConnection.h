@@ -71,6 +71,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _inPipe; // The pipe for writing input to
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
+        wil::unique_handle _hReaderThread;
         wil::unique_process_information _piClient;
         wil::unique_static_pseudoconsole_handle _hPC;
         wil::unique_threadpool_wait _clientExitWait;
@@ -79,6 +80,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         std::wstring _u16Str;
         std::array<char, 4096> _buffer;
 
+        // The reader thread passes the raw output on to the output thread through this channel.
+        til::spsc::producer<char> _outputProducer{ nullptr };
+        til::spsc::consumer<char> _outputConsumer{ nullptr };
+        HRESULT _readError{ S_OK };
+
+        DWORD _ReaderThread();
         DWORD _OutputThread();
     };
 }
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "SearchBoxControl.h"
 #include "SearchBoxControl.g.cpp"
+#include <LibraryResources.h>
 
 using namespace winrt;
 using namespace winrt::Windows::UI::Xaml;
@@ -122,6 +123,37 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             TextBox().Text(text);
         }
+        ClearStatus();
+    }
+
+    // Method Description:
+    // - Shows how many matches the last search found, and which of them is selected
+    // Arguments:
+    // - totalMatches: the number of matches in the buffer
+    // - currentMatch: the 1-based index of the selected match
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::SetStatus(int32_t totalMatches, int32_t currentMatch)
+    {
+        if (totalMatches > 0)
+        {
+            StatusBox().Text(fmt::format(std::wstring_view{ RS_(L"SearchBox_MatchCount") }, currentMatch, totalMatches));
+        }
+        else
+        {
+            StatusBox().Text(RS_(L"SearchBox_NoResults"));
+        }
+    }
+
+    // Method Description:
+    // - Removes the result of the last search, for when it no longer applies
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::ClearStatus()
+    {
+        StatusBox().Text({});
     }
 
     // Method Description:
@@ -30,6 +30,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void SetFocusOnTextbox();
         void PopulateTextbox(winrt::hstring const& text);
+        void SetStatus(int32_t totalMatches, int32_t currentMatch);
+        void ClearStatus();
         bool ContainsFocus();
 
         void GoBackwardClicked(winrt::Windows::Foundation::IInspectable const& /*sender*/, winrt::Windows::UI::Xaml::RoutedEventArgs const& /*e*/);
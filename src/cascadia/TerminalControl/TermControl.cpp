@@ -120,7 +120,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _terminal->TaskbarProgressChangedCallback([&]() { TermControl::TaskbarProgressChanged(); });
 
         // This event is explicitly revoked in the destructor: does not need weak_ref
-        auto onReceiveOutputFn = [this](const hstring str) {
+        // The output refers to the connection's own buffer and is only valid during
+        // the call. We're done with it once it's parsed, so take it by reference:
+        // copying it would allocate a copy of every chunk of output.
+        auto onReceiveOutputFn = [this](const hstring& str) {
             _terminal->Write(str);
             _updatePatternLocations->Run();
         };
@@ -283,12 +286,30 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                     Search::Sensitivity::CaseInsensitive;
 
         Search search(*GetUiaData(), text.c_str(), direction, sensitivity);
-        auto lock = _terminal->LockForWriting();
-        if (search.FindNext())
+        size_t totalMatches = 0;
+        size_t currentMatch = 0;
         {
-            _terminal->SetBlockSelection(false);
-            search.Select();
-            _renderer->TriggerSelection();
+            auto lock = _terminal->LockForWriting();
+            if (search.FindNext())
+            {
+                _terminal->SetBlockSelection(false);
+                search.Select();
+                _renderer->TriggerSelection();
+
+                // FindNext already found all the matches, so counting them is free.
+                const auto& matches = search.FindAll();
+                const auto found = search.GetFoundLocation().first;
+                const auto match = std::find_if(matches.cbegin(), matches.cend(), [&](const auto& candidate) {
+                    return candidate.first.X == found.X && candidate.first.Y == found.Y;
+                });
+                totalMatches = matches.size();
+                currentMatch = gsl::narrow_cast<size_t>(match - matches.cbegin()) + 1;
+            }
+        }
+
+        if (_searchBox)
+        {
+            _searchBox->SetStatus(gsl::narrow_cast<int32_t>(totalMatches), gsl::narrow_cast<int32_t>(currentMatch));
         }
     }
 
@@ -304,6 +325,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                              RoutedEventArgs const& /*args*/)
     {
         _searchBox->Visibility(Visibility::Collapsed);
+        _searchBox->ClearStatus();
 
         // Set focus back to terminal control
         this->Focus(FocusState::Programmatic);
@@ -362,6 +384,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void TermControl::ToggleShaderEffects()
     {
         auto lock = _terminal->LockForWriting();
+        const auto engineLock = _renderer->LockEngines();
         // Originally, this action could be used to enable the retro effects
         // even when they're set to `false` in the settings. If the user didn't
         // specify a custom pixel shader, manually enable the legacy retro
@@ -412,21 +435,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // Update DxEngine settings under the lock
-        _renderEngine->SetForceFullRepaintRendering(_settings.ForceFullRepaintRendering());
-        _renderEngine->SetSoftwareRendering(_settings.SoftwareRendering());
-
-        switch (_settings.AntialiasingMode())
         {
-        case TextAntialiasingMode::Cleartype:
-            _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE);
-            break;
-        case TextAntialiasingMode::Aliased:
-            _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_ALIASED);
-            break;
-        case TextAntialiasingMode::Grayscale:
-        default:
-            _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
-            break;
+            const auto engineLock = _renderer->LockEngines();
+            _renderEngine->SetForceFullRepaintRendering(_settings.ForceFullRepaintRendering());
+            _renderEngine->SetSoftwareRendering(_settings.SoftwareRendering());
+
+            switch (_settings.AntialiasingMode())
+            {
+            case TextAntialiasingMode::Cleartype:
+                _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE);
+                break;
+            case TextAntialiasingMode::Aliased:
+                _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_ALIASED);
+                break;
+            case TextAntialiasingMode::Grayscale:
+            default:
+                _renderEngine->SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+                break;
+            }
         }
 
         // Refresh our font with the renderer
@@ -499,6 +525,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         if (_renderEngine)
         {
             // Update DxEngine settings under the lock
+            const auto engineLock = _renderer->LockEngines();
             _renderEngine->SetSelectionBackground(til::color{ newAppearance.SelectionBackground() });
             _renderEngine->SetRetroTerminalEffect(newAppearance.RetroTerminalEffect());
             _renderEngine->SetPixelShaderPath(newAppearance.PixelShaderPath());
@@ -608,6 +635,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // GH#5098: Inform the engine of the new opacity of the default text background.
             if (_renderEngine)
             {
+                const auto engineLock = _renderer->LockEngines();
                 _renderEngine->SetDefaultTextBackgroundOpacity(::base::saturated_cast<float>(_settings.TintOpacity()));
             }
         }
@@ -619,6 +647,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // GH#5098: Inform the engine of the new opacity of the default text background.
             if (_renderEngine)
             {
+                const auto engineLock = _renderer->LockEngines();
                 _renderEngine->SetDefaultTextBackgroundOpacity(1.0f);
             }
         }
@@ -798,6 +827,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _renderer = std::make_unique<::Microsoft::Console::Render::Renderer>(_terminal.get(), nullptr, 0, std::move(renderThread));
             ::Microsoft::Console::Render::IRenderTarget& renderTarget = *_renderer;
 
+            // Let the renderer paint from a snapshot of the terminal, so that it only holds
+            // the terminal lock for as long as it takes to copy what the frame needs. That way
+            // the connection can go on writing output to the terminal while a frame is painted.
+            _renderer->SetPaintFromSnapshot(true);
+
+            // Count the frames and the paint time of this pane along with the rest of its counters.
+            _renderer->SetPerformanceCounters(&_terminal->GetPerformanceCounters());
+
             _renderer->SetRendererEnteredErrorStateCallback([weakThis = get_weak()]() {
                 if (auto strongThis{ weakThis.get() })
                 {
@@ -1516,7 +1553,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     auto distance{ std::sqrtf(std::powf(cursorPosition.X - touchdownPoint.X, 2) + std::powf(cursorPosition.Y - touchdownPoint.Y, 2)) };
                     const til::size fontSize{ _actualFont.GetSize() };
 
-                    const auto fontSizeInDips = fontSize.scale(til::math::rounding, 1.0f / _renderEngine->GetScaling());
+                    const auto fontSizeInDips = fontSize.scale(til::math::rounding, 1.0f / _GetEngineScaling());
                     if (distance >= (std::min(fontSizeInDips.width(), fontSizeInDips.height()) / 4.f))
                     {
                         _terminal->SetSelectionAnchor(_GetTerminalPosition(touchdownPoint));
@@ -1562,7 +1599,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // Our _actualFont's size is in pixels, convert to DIPs, which the
             // rest of the Points here are in.
             const til::size fontSize{ _actualFont.GetSize() };
-            const auto fontSizeInDips = fontSize.scale(til::math::rounding, 1.0f / _renderEngine->GetScaling());
+            const auto fontSizeInDips = fontSize.scale(til::math::rounding, 1.0f / _GetEngineScaling());
 
             // Get the difference between the point we've dragged to and the start of the touch.
             const float dy = newTouchPoint.Y - anchor.Y;
@@ -1778,6 +1815,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     // GH#5098: Inform the engine of the new opacity of the default text background.
                     if (_renderEngine)
                     {
+                        const auto engineLock = _renderer->LockEngines();
                         _renderEngine->SetDefaultTextBackgroundOpacity(::base::saturated_cast<float>(_settings.TintOpacity()));
                     }
                 }
@@ -2270,7 +2308,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         const auto newSize = e.NewSize();
         const auto currentScaleX = SwapChainPanel().CompositionScaleX();
-        const auto currentEngineScale = _renderEngine->GetScaling();
+        const auto currentEngineScale = _GetEngineScaling();
         auto foundationSize = newSize;
 
         // A strange thing can happen here. If you have two tabs open, and drag
@@ -2325,7 +2363,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             const auto scaleX = sender.CompositionScaleX();
             const auto scaleY = sender.CompositionScaleY();
             const auto dpi = (float)(scaleX * USER_DEFAULT_SCREEN_DPI);
-            const auto currentEngineScale = _renderEngine->GetScaling();
+            const auto currentEngineScale = _GetEngineScaling();
 
             // If we're getting a notification to change to the DPI we already
             // have, then we're probably just beginning the DPI change. Since
@@ -2454,17 +2492,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _terminal->ClearSelection();
 
-        // Tell the dx engine that our window is now the new size.
-        THROW_IF_FAILED(_renderEngine->SetWindowSize(size));
+        // Tell the dx engine that our window is now the new size,
+        // and convert our new dimensions to characters.
+        const auto viewInPixels = Viewport::FromDimensions({ 0, 0 },
+                                                           { static_cast<short>(size.cx), static_cast<short>(size.cy) });
+        Viewport vp;
+        {
+            const auto engineLock = _renderer->LockEngines();
+            THROW_IF_FAILED(_renderEngine->SetWindowSize(size));
+            vp = _renderEngine->GetViewportInCharacters(viewInPixels);
+        }
 
         // Invalidate everything
         _renderer->TriggerRedrawAll();
 
-        // Convert our new dimensions to characters
-        const auto viewInPixels = Viewport::FromDimensions({ 0, 0 },
-                                                           { static_cast<short>(size.cx), static_cast<short>(size.cy) });
-        const auto vp = _renderEngine->GetViewportInCharacters(viewInPixels);
-
         // If this function succeeds with S_FALSE, then the terminal didn't
         // actually change size. No need to notify the connection of this no-op.
         const HRESULT hr = _terminal->UserResize({ vp.Width(), vp.Height() });
@@ -2561,6 +2602,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return hstr;
     }
 
+    // Method Description:
+    // - Formats the performance counters of the parser, the text buffer, the
+    //   renderer and the terminal lock. Every call after the first one also
+    //   reports how much each counter grew since the previous call, and how fast.
+    // - The counters are followed by the frame timing of the render thread.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - The counters, one per line.
+    hstring TermControl::DumpPerformanceCounters()
+    {
+        const auto snapshot = _terminal->CapturePerformanceCounters();
+        const auto previous = std::exchange(_lastPerformanceCounters, snapshot);
+        auto text = PerformanceCounters::Format(snapshot, previous ? &*previous : nullptr);
+
+        if (_renderer)
+        {
+            const auto frames = _renderer->GetFrameStatistics();
+            fmt::format_to(std::back_inserter(text),
+                           L"Frames: {}\nImmediateFrames: {}\nLastPaintMicroseconds: {}\nLastLatencyMicroseconds: {}\nMaxLatencyMicroseconds: {}\n",
+                           frames.frames,
+                           frames.immediateFrames,
+                           frames.lastPaintDuration.count(),
+                           frames.lastLatency.count(),
+                           frames.maxLatency.count());
+        }
+
+        return hstring{ text };
+    }
+
     bool TermControl::BracketedPasteEnabled() const noexcept
     {
         return _terminal->IsXtermBracketedPasteModeEnabled();
@@ -3149,6 +3220,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _multiClickCounter;
     }
 
+    // Method Description:
+    // - Gets the scaling of the DX engine. The engine may be painting without the
+    //   console lock, so this holds the lock on the engines while reading it.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - the scale factor of the engine
+    float TermControl::_GetEngineScaling() const
+    {
+        const auto engineLock = _renderer->LockEngines();
+        return _renderEngine->GetScaling();
+    }
+
     // Method Description:
     // - Calculates speed of single axis of auto scrolling. It has to allow for both
     //      fast and precise selection.
@@ -3470,7 +3554,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             auto lock = _terminal->LockForWriting();
             _lastHoveredId = newId;
             _lastHoveredInterval = newInterval;
-            _renderEngine->UpdateHyperlinkHoveredId(newId);
+            {
+                const auto engineLock = _renderer->LockEngines();
+                _renderEngine->UpdateHyperlinkHoveredId(newId);
+            }
             _renderer->UpdateLastHoveredInterval(newInterval);
             _renderer->TriggerRedrawAll();
         }
@@ -47,6 +47,8 @@ Terminal::Terminal() :
     _screenReversed{ false },
     _pfnWriteInput{ nullptr },
     _scrollOffset{ 0 },
+    _deferScrollNotifications{ false },
+    _scrollNotificationPending{ false },
     _snapOnInput{ true },
     _altGrAliasing{ true },
     _blockSelection{ false },
@@ -59,6 +61,7 @@ Terminal::Terminal() :
     auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
 
     _stateMachine = std::make_unique<StateMachine>(std::move(engine));
+    _stateMachine->SetPerformanceCounters(&_performanceCounters);
 
     auto passAlongInput = [&](std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite) {
         if (!_pfnWriteInput)
@@ -83,6 +86,7 @@ void Terminal::Create(COORD viewportSize, SHORT scrollbackLines, IRenderTarget&
     const TextAttribute attr{};
     const UINT cursorSize = 12;
     _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget);
+    _buffer->SetPerformanceCounters(&_performanceCounters);
     // Add regex pattern recognizers to the buffer
     // For now, we only add the URI regex pattern
     std::wstring_view linkPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
@@ -257,6 +261,7 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
                                                      TextAttribute{},
                                                      0, // temporarily set size to 0 so it won't render.
                                                      _buffer->GetRenderTarget());
+        newTextBuffer->SetPerformanceCounters(&_performanceCounters);
 
         newTextBuffer->GetCursor().StartDeferDrawing();
 
@@ -418,6 +423,17 @@ void Terminal::Write(std::wstring_view stringView)
 {
     auto lock = LockForWriting();
 
+    // Every line feed in the output may move the viewport. Instead of telling
+    // the control about each of those, notify it once for the whole string.
+    _deferScrollNotifications = true;
+    auto endDefer = wil::scope_exit([&]() noexcept {
+        _deferScrollNotifications = false;
+        if (std::exchange(_scrollNotificationPending, false))
+        {
+            _NotifyScrollEvent();
+        }
+    });
+
     _stateMachine->ProcessString(stringView);
 }
 
@@ -857,7 +873,14 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 //      will release this lock when it's destructed.
 [[nodiscard]] std::shared_lock<std::shared_mutex> Terminal::LockForReading()
 {
-    return std::shared_lock<std::shared_mutex>(_readWriteLock);
+    std::shared_lock<std::shared_mutex> lock{ _readWriteLock, std::try_to_lock };
+    if (!lock.owns_lock())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        lock.lock();
+        _CountLockWait(start);
+    }
+    return lock;
 }
 
 // Method Description:
@@ -867,7 +890,43 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 //      will release this lock when it's destructed.
 [[nodiscard]] std::unique_lock<std::shared_mutex> Terminal::LockForWriting()
 {
-    return std::unique_lock<std::shared_mutex>(_readWriteLock);
+    std::unique_lock<std::shared_mutex> lock{ _readWriteLock, std::try_to_lock };
+    if (!lock.owns_lock())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        lock.lock();
+        _CountLockWait(start);
+    }
+    return lock;
+}
+
+// Method Description:
+// - Records that acquiring the terminal lock had to wait for another thread.
+//   The uncontended case is never timed, so that it stays as cheap as before.
+// Arguments:
+// - start: when we started waiting for the lock
+void Terminal::_CountLockWait(const std::chrono::steady_clock::time_point start) noexcept
+{
+    const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    _performanceCounters.Add(PerformanceCounter::LockContentions);
+    _performanceCounters.Add(PerformanceCounter::LockWaitMicroseconds, waited.count());
+}
+
+// Method Description:
+// - Returns the performance counters of this terminal, so that the renderer
+//   painting it can count into them as well.
+PerformanceCounters& Terminal::GetPerformanceCounters() noexcept
+{
+    return _performanceCounters;
+}
+
+// Method Description:
+// - Returns the current totals of the performance counters of the parser, the
+//   text buffer, the renderer and the lock of this terminal. The difference of
+//   two snapshots tells where the time went in between.
+PerformanceCounters::Snapshot Terminal::CapturePerformanceCounters() const noexcept
+{
+    return _performanceCounters.Capture();
 }
 
 Viewport Terminal::_GetMutableViewport() const noexcept
@@ -925,46 +984,34 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
     // We can not waste time displaying a cursor event when we know more text is coming right behind it.
     cursor.StartDeferDrawing();
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    // Walk the printable run a row segment at a time. TextBuffer::WriteLine
+    // fills as much of the current row as it can in a single pass (handling
+    // surrogate pairs, wide glyphs and the wrap flag for us), so the cursor
+    // and viewport only need to be adjusted once per row, not once per glyph.
+    OutputCellIterator it{ stringView, _buffer->GetCurrentAttributes() };
+    while (it)
     {
-        const auto wch = stringView.at(i);
         const COORD cursorPosBefore = cursor.GetPosition();
         COORD proposedCursorPosition = cursorPosBefore;
 
-        // TODO: MSFT 21006766
-        // This is not great but I need it demoable. Fix by making a buffer stream writer.
-        //
-        // If wch is a surrogate character we need to read 2 code units
-        // from the stringView to form a single code point.
-        const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
-        const auto view = stringView.substr(i, isSurrogate ? 2 : 1);
-        const OutputCellIterator it{ view, _buffer->GetCurrentAttributes() };
-        const auto end = _buffer->Write(it);
+        const auto end = _buffer->WriteLine(it, cursorPosBefore, true);
         const auto cellDistance = end.GetCellDistance(it);
         const auto inputDistance = end.GetInputDistance(it);
 
         if (inputDistance > 0)
         {
-            // If "wch" was a surrogate character, we just consumed 2 code units above.
-            // -> Increment "i" by 1 in that case and thus by 2 in total in this iteration.
             proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
-            i += inputDistance - 1;
+            it = end;
         }
         else
         {
-            // If _WriteBuffer() is called with a consecutive string longer than the viewport/buffer width
-            // the call to _buffer->Write() will refuse to write anything on the current line.
-            // GetInputDistance() thus returns 0, which would in turn cause i to be
-            // decremented by 1 below and force the outer loop to loop forever.
-            // This if() basically behaves as if "\r\n" had been encountered above and retries the write.
-            // With well behaving shells during normal operation this safeguard should normally not be encountered.
-            proposedCursorPosition.X = 0;
-            proposedCursorPosition.Y++;
-
-            // Try the character again.
-            i--;
+            // If the cursor already sits past the end of the row (or the next
+            // glyph is a wide one that doesn't fit into the last column),
+            // WriteLine will refuse to write anything on the current line.
+            // This basically behaves as if "\r\n" had been encountered above
+            // and retries the write on the next line.
 
-            // If we write the last cell of the row here, TextBuffer::Write will
+            // If we write the last cell of the row here, TextBuffer::WriteLine will
             // mark this line as wrapped for us. If the next character we
             // process is a newline, the Terminal::CursorLineFeed will unmark
             // this line as wrapped.
@@ -973,6 +1020,8 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
             // the next character to come in is a newline or a cursor
             // movement or anything, then we should _not_ wrap this line
             // here.
+            proposedCursorPosition.X = 0;
+            proposedCursorPosition.Y++;
         }
 
         _AdjustCursorPosition(proposedCursorPosition);
@@ -1088,6 +1137,12 @@ int Terminal::GetScrollOffset() noexcept
 void Terminal::_NotifyScrollEvent() noexcept
 try
 {
+    if (_deferScrollNotifications)
+    {
+        _scrollNotificationPending = true;
+        return;
+    }
+
     if (_pfnScrollPositionChanged)
     {
         const auto visible = _GetVisibleViewport();
@@ -13,6 +13,7 @@
 
 #include "../../types/inc/Viewport.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/PerformanceCounters.hpp"
 #include "../../types/IUiaData.h"
 #include "../../cascadia/terminalcore/ITerminalApi.hpp"
 #include "../../cascadia/terminalcore/ITerminalInput.hpp"
@@ -75,6 +76,9 @@ public:
     [[nodiscard]] std::shared_lock<std::shared_mutex> LockForReading();
     [[nodiscard]] std::unique_lock<std::shared_mutex> LockForWriting();
 
+    Microsoft::Console::Types::PerformanceCounters& GetPerformanceCounters() noexcept;
+    Microsoft::Console::Types::PerformanceCounters::Snapshot CapturePerformanceCounters() const noexcept;
+
     short GetBufferHeight() const noexcept;
 
     int ViewStartIndex() const noexcept;
@@ -192,6 +196,7 @@ public:
     const COORD GetSelectionEnd() const noexcept override;
     const std::wstring_view GetConsoleTitle() const noexcept override;
     void ColorSelection(const COORD coordSelectionStart, const COORD coordSelectionEnd, const TextAttribute) override;
+    SearchIndex& GetSearchIndex() noexcept override;
 #pragma endregion
 
     void SetWriteInputCallback(std::function<void(std::wstring&)> pfn) noexcept;
@@ -290,6 +295,15 @@ private:
 #pragma endregion
 
     std::shared_mutex _readWriteLock;
+    void _CountLockWait(const std::chrono::steady_clock::time_point start) noexcept;
+
+    // The counters of this terminal. The parser, the buffer and the
+    // renderer that belong to it count into these as well.
+    Microsoft::Console::Types::PerformanceCounters _performanceCounters;
+
+    // The text of the rows the last search looked at, so the next one only
+    // needs to flatten the rows that have changed since.
+    SearchIndex _searchIndex;
 
     // TODO: These members are not shared by an alt-buffer. They should be
     //      encapsulated, such that a Terminal can have both a main and alt buffer.
@@ -300,6 +314,10 @@ private:
     // _scrollOffset is the number of lines above the viewport that are currently visible
     // If _scrollOffset is 0, then the visible region of the buffer is the viewport.
     int _scrollOffset;
+    // While Write() is processing output, scroll notifications are held back
+    // and sent once at the end, with the viewport the output left us with.
+    bool _deferScrollNotifications;
+    bool _scrollNotificationPending;
     // TODO this might not be the value we want to store.
     // We might want to store the height in the scrollback that's currently visible.
     // Think on this some more.
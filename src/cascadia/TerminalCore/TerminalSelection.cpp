@@ -290,3 +290,11 @@ void Terminal::ColorSelection(const COORD, const COORD, const TextAttribute)
 {
     THROW_HR(E_NOTIMPL);
 }
+
+// Method Description:
+// - Returns the text of the rows the searches of this terminal keep between them.
+//   Searches lock it on their own, since they may run under the shared console lock.
+SearchIndex& Terminal::GetSearchIndex() noexcept
+{
+    return _searchIndex;
+}
@@ -238,7 +238,12 @@ catch (...)
 //      they're done with any querying they need to do.
 void Terminal::LockConsole() noexcept
 {
-    _readWriteLock.lock_shared();
+    if (!_readWriteLock.try_lock_shared())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _readWriteLock.lock_shared();
+        _CountLockWait(start);
+    }
 }
 
 // Method Description:
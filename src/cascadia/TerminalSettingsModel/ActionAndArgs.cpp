@@ -57,6 +57,7 @@ static constexpr std::string_view IdentifyWindowKey{ "identifyWindow" };
 static constexpr std::string_view IdentifyWindowsKey{ "identifyWindows" };
 static constexpr std::string_view RenameWindowKey{ "renameWindow" };
 static constexpr std::string_view OpenWindowRenamerKey{ "openWindowRenamer" };
+static constexpr std::string_view DumpPerformanceCountersKey{ "dumpPerformanceCounters" };
 
 static constexpr std::string_view ActionKey{ "action" };
 
@@ -127,6 +128,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         { IdentifyWindowsKey, ShortcutAction::IdentifyWindows },
         { RenameWindowKey, ShortcutAction::RenameWindow },
         { OpenWindowRenamerKey, ShortcutAction::OpenWindowRenamer },
+        { DumpPerformanceCountersKey, ShortcutAction::DumpPerformanceCounters },
     };
 
     using ParseResult = std::tuple<IActionArgs, std::vector<SettingsLoadWarnings>>;
@@ -337,6 +339,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 { ShortcutAction::IdentifyWindows, RS_(L"IdentifyWindowsCommandKey") },
                 { ShortcutAction::RenameWindow, RS_(L"ResetWindowNameCommandKey") },
                 { ShortcutAction::OpenWindowRenamer, RS_(L"OpenWindowRenamerCommandKey") },
+                { ShortcutAction::DumpPerformanceCounters, RS_(L"DumpPerformanceCountersCommandKey") },
             };
         }();
 
@@ -87,6 +87,7 @@ class TerminalCoreUnitTests::ScrollTest final
     TEST_CLASS(ScrollTest);
 
     TEST_METHOD(TestNotifyScrolling);
+    TEST_METHOD(TestNotifyScrollingOncePerWrite);
 
     TEST_METHOD_SETUP(MethodSetup)
     {
@@ -215,3 +216,35 @@ void ScrollTest::TestNotifyScrolling()
         }
     }
 }
+
+void ScrollTest::TestNotifyScrollingOncePerWrite()
+{
+    auto notifications = 0;
+    _term->SetScrollPositionChangedCallback([&, scrollBarNotification = _scrollBarNotification](const int top, const int height, const int bottom) {
+        ++notifications;
+        *scrollBarNotification = { ScrollBarNotification{ top, height, bottom } };
+    });
+
+    Log::Comment(L"Write enough lines at once to scroll the viewport many times over.");
+    std::wstring output;
+    for (auto i = 0; i < TerminalViewHeight * 3; i++)
+    {
+        output.append(L"X\r\n");
+    }
+    _term->Write(output);
+
+    Log::Comment(L"The control is told about the final viewport only once.");
+    VERIFY_ARE_EQUAL(1, notifications);
+    VERIFY_IS_TRUE(_scrollBarNotification->has_value());
+
+    const auto tmp = _scrollBarNotification->value();
+    const int expectedTop = TerminalViewHeight * 2 + 1;
+    VERIFY_ARE_EQUAL(expectedTop, tmp.ViewportTop);
+    VERIFY_ARE_EQUAL(TerminalViewHeight, tmp.ViewportHeight);
+    VERIFY_ARE_EQUAL(expectedTop + TerminalViewHeight, tmp.BufferHeight);
+
+    Log::Comment(L"Output that doesn't scroll doesn't notify.");
+    notifications = 0;
+    _term->Write(L"X");
+    VERIFY_ARE_EQUAL(0, notifications);
+}
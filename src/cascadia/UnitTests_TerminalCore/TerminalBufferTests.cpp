@@ -38,6 +38,7 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestWrappingCharByChar);
     TEST_METHOD(TestWrappingALongString);
+    TEST_METHOD(TestWrappingWideGlyphAtEndOfLine);
 
     TEST_METHOD(DontSnapToOutputTest);
 
@@ -165,6 +166,33 @@ void TerminalBufferTests::TestWrappingALongString()
     TestUtils::VerifyExpectedString(termTb, TestUtils::Test100CharsString, { 0, 0 });
 }
 
+void TerminalBufferTests::TestWrappingWideGlyphAtEndOfLine()
+{
+    auto& termTb = *term->_buffer;
+    auto& termSm = *term->_stateMachine;
+    const auto initialView = term->GetViewport();
+    auto& cursor = termTb.GetCursor();
+
+    Log::Comment(L"Fill all but the last column, then print a wide glyph that can't fit into it.");
+    const std::wstring fill(initialView.Width() - 1, L'A');
+    termSm.ProcessString(fill + L"\x3042B");
+
+    // The wide glyph moved to the second line and the last column of the
+    // first line was padded out instead.
+    VERIFY_ARE_EQUAL(3, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(1, cursor.GetPosition().Y);
+
+    const auto& row0 = termTb.GetRowByOffset(0);
+    VERIFY_IS_TRUE(row0.WasWrapForced());
+    VERIFY_IS_TRUE(row0.WasDoubleBytePadded());
+    TestUtils::VerifyExpectedString(termTb, fill + L" ", { 0, 0 });
+
+    const auto iter = termTb.GetCellDataAt({ 0, 1 });
+    VERIFY_ARE_EQUAL(L"\x3042", iter->Chars());
+    VERIFY_IS_TRUE(iter->DbcsAttr().IsLeading());
+    TestUtils::VerifyExpectedString(termTb, L"B", { 2, 1 });
+}
+
 void TerminalBufferTests::DontSnapToOutputTest()
 {
     auto& termTb = *term->_buffer;
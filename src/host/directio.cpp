@@ -171,37 +171,40 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
-        std::deque<std::unique_ptr<IInputEvent>> partialEvents;
+        std::vector<INPUT_RECORD> partialRecords;
         if (!IsUnicode)
         {
             if (inputBuffer.IsReadPartialByteSequenceAvailable())
             {
-                partialEvents.push_back(inputBuffer.FetchReadPartialByteSequence(IsPeek));
+                partialRecords.push_back(inputBuffer.FetchReadPartialByteSequence(IsPeek)->ToInputRecord());
             }
         }
 
         size_t amountToRead;
-        if (FAILED(SizeTSub(eventReadCount, partialEvents.size(), &amountToRead)))
+        if (FAILED(SizeTSub(eventReadCount, partialRecords.size(), &amountToRead)))
         {
             return STATUS_INTEGER_OVERFLOW;
         }
-        std::deque<std::unique_ptr<IInputEvent>> readEvents;
-        NTSTATUS Status = inputBuffer.Read(readEvents,
-                                           amountToRead,
+        // There can't be more records to read than there are events in the buffer.
+        std::vector<INPUT_RECORD> readRecords(std::min(amountToRead, inputBuffer.GetNumberOfReadyEvents()));
+        size_t recordsRead = 0;
+        NTSTATUS Status = inputBuffer.Read(readRecords,
+                                           recordsRead,
                                            IsPeek,
                                            true,
                                            IsUnicode,
                                            false);
+        readRecords.resize(recordsRead);
 
         if (CONSOLE_STATUS_WAIT == Status)
         {
-            FAIL_FAST_IF(!(readEvents.empty()));
+            FAIL_FAST_IF(!(readRecords.empty()));
             // If we're told to wait until later, move all of our context
             // to the read data object and send it back up to the server.
             waiter = std::make_unique<DirectReadData>(&inputBuffer,
                                                       &readHandleState,
                                                       eventReadCount,
-                                                      std::move(partialEvents));
+                                                      std::move(partialRecords));
         }
         else if (NT_SUCCESS(Status))
         {
@@ -210,35 +213,26 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             {
                 try
                 {
-                    SplitToOem(readEvents);
+                    SplitToOem(readRecords);
                 }
                 CATCH_LOG();
             }
 
-            // combine partial and readEvents
-            while (!partialEvents.empty())
-            {
-                readEvents.push_front(std::move(partialEvents.back()));
-                partialEvents.pop_back();
-            }
+            // combine partial and read records
+            readRecords.insert(readRecords.begin(), partialRecords.begin(), partialRecords.end());
 
-            // move events over
-            for (size_t i = 0; i < eventReadCount; ++i)
+            // hand the records over to the caller, which is the first place they're needed as events
+            const auto recordsToReturn = std::min(eventReadCount, readRecords.size());
+            for (size_t i = 0; i < recordsToReturn; ++i)
             {
-                if (readEvents.empty())
-                {
-                    break;
-                }
-                outEvents.push_back(std::move(readEvents.front()));
-                readEvents.pop_front();
+                outEvents.push_back(IInputEvent::Create(til::at(readRecords, i)));
             }
 
             // store partial event if necessary
-            if (!readEvents.empty())
+            if (readRecords.size() > recordsToReturn)
             {
-                inputBuffer.StoreReadPartialByteSequence(std::move(readEvents.front()));
-                readEvents.pop_front();
-                FAIL_FAST_IF(!(readEvents.empty()));
+                inputBuffer.StoreReadPartialByteSequence(IInputEvent::Create(til::at(readRecords, recordsToReturn)));
+                FAIL_FAST_IF(readRecords.size() > recordsToReturn + 1);
             }
         }
         return Status;
@@ -410,17 +404,38 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 }
 
 // Routine Description:
-// - Writes events to the input buffer
+// - Checks whether a record is of one of the event types the input buffer can hold.
+// Arguments:
+// - record - the record to check
+// Return Value:
+// - true if the record can be written to the input buffer
+static bool _IsValidInputRecord(const INPUT_RECORD& record) noexcept
+{
+    switch (record.EventType)
+    {
+    case KEY_EVENT:
+    case MOUSE_EVENT:
+    case WINDOW_BUFFER_SIZE_EVENT:
+    case MENU_EVENT:
+    case FOCUS_EVENT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Writes records to the input buffer
 // Arguments:
 // - context - the input buffer to write to
-// - events - the events to written
+// - records - the records to written
 // - written  - on output, the number of events written
 // - append - true if events should be written to the end of the input
 // buffer, false if they should be written to the front
 // Return Value:
 // - HRESULT indicating success or failure
 [[nodiscard]] static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& events,
+                                                           const gsl::span<const INPUT_RECORD> records,
                                                            size_t& written,
                                                            const bool append) noexcept
 {
@@ -431,11 +446,11 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // add to InputBuffer
         if (append)
         {
-            written = context.Write(events);
+            written = context.Write(records);
         }
         else
         {
-            written = context.Prepend(events);
+            written = context.Prepend(records);
         }
 
         return S_OK;
@@ -444,21 +459,42 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 }
 
 // Routine Description:
-// - Writes events to the input buffer already formed into IInputEvents (private call)
+// - Writes records to the input buffer (private call)
 // Arguments:
 // - context - the input buffer to write to
-// - events - the events to written
+// - records - the records to written
 // - written  - on output, the number of events written
 // - append - true if events should be written to the end of the input
 // buffer, false if they should be written to the front
 // Return Value:
 // - HRESULT indicating success or failure
 [[nodiscard]] HRESULT DoSrvPrivateWriteConsoleInputW(_Inout_ InputBuffer* const pInputBuffer,
-                                                     _Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+                                                     const gsl::span<const INPUT_RECORD> records,
                                                      _Out_ size_t& eventsWritten,
                                                      const bool append) noexcept
 {
-    return _WriteConsoleInputWImplHelper(*pInputBuffer, events, eventsWritten, append);
+    return _WriteConsoleInputWImplHelper(*pInputBuffer, records, eventsWritten, append);
+}
+
+// Routine Description:
+// - Appends text to the input buffer, as if it was typed (private call)
+// Arguments:
+// - pInputBuffer - the input buffer to write to
+// - string - the text to write
+// - codepage - the codepage used to enter characters that aren't part of the keyboard layout
+// Return Value:
+// - HRESULT indicating success or failure
+[[nodiscard]] HRESULT DoSrvPrivateWriteConsoleInputString(_Inout_ InputBuffer* const pInputBuffer,
+                                                          const std::wstring_view string,
+                                                          const unsigned int codepage) noexcept
+{
+    try
+    {
+        const auto written = pInputBuffer->WriteString(string, codepage);
+        RETURN_HR_IF(E_FAIL, written != string.size());
+        return S_OK;
+    }
+    CATCH_RETURN();
 }
 
 // Routine Description:
@@ -500,7 +536,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             context.StoreWritePartialByteSequence(std::move(partialEvent));
         }
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        const auto records = IInputEvent::ToInputRecords(events);
+        return _WriteConsoleInputWImplHelper(context, records, written, append);
     }
     CATCH_RETURN();
 }
@@ -527,9 +564,11 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
     try
     {
-        auto events = IInputEvent::Create(buffer);
+        // The records are stored as they are, so anything that
+        // can't be turned into an event later on is rejected here.
+        RETURN_HR_IF(E_INVALIDARG, !std::all_of(buffer.begin(), buffer.end(), _IsValidInputRecord));
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        return _WriteConsoleInputWImplHelper(context, buffer, written, append);
     }
     CATCH_RETURN();
 }
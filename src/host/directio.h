@@ -22,10 +22,14 @@ Revision History:
 class SCREEN_INFORMATION;
 
 [[nodiscard]] HRESULT DoSrvPrivateWriteConsoleInputW(_Inout_ InputBuffer* const pInputBuffer,
-                                                     _Inout_ std::deque<std::unique_ptr<IInputEvent>>& events,
+                                                     const gsl::span<const INPUT_RECORD> records,
                                                      _Out_ size_t& eventsWritten,
                                                      const bool append) noexcept;
 
+[[nodiscard]] HRESULT DoSrvPrivateWriteConsoleInputString(_Inout_ InputBuffer* const pInputBuffer,
+                                                          const std::wstring_view string,
+                                                          const unsigned int codepage) noexcept;
+
 [[nodiscard]] NTSTATUS ConsoleCreateScreenBuffer(std::unique_ptr<ConsoleHandleData>& handle,
                                                  _In_ PCONSOLE_API_MSG Message,
                                                  _In_ PCD_CREATE_OBJECT_INFORMATION Information,
@@ -162,11 +162,12 @@ void HandleGenericKeyEvent(_In_ KeyEvent keyEvent, const bool generateBreak)
         size_t EventsWritten = 0;
         try
         {
-            EventsWritten = gci.pInputBuffer->Write(std::make_unique<KeyEvent>(keyEvent));
+            auto record = keyEvent.ToInputRecord();
+            EventsWritten = gci.pInputBuffer->Write(gsl::make_span(&record, 1));
             if (EventsWritten && generateBreak)
             {
-                keyEvent.SetKeyDown(false);
-                EventsWritten = gci.pInputBuffer->Write(std::make_unique<KeyEvent>(keyEvent));
+                record.Event.KeyEvent.bKeyDown = FALSE;
+                EventsWritten = gci.pInputBuffer->Write(gsl::make_span(&record, 1));
             }
         }
         catch (...)
@@ -9,6 +9,7 @@
 
 #include <functional>
 
+#include "../interactivity/inc/EventSynthesis.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 #define INPUT_BUFFER_DEFAULT_INPUT_MODE (ENABLE_LINE_INPUT | ENABLE_PROCESSED_INPUT | ENABLE_ECHO_INPUT | ENABLE_MOUSE_INPUT)
@@ -151,6 +152,7 @@ void InputBuffer::ReinitializeInputBuffer()
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     InputMode = INPUT_BUFFER_DEFAULT_INPUT_MODE;
     _storage.clear();
+    _textRuns.clear();
 }
 
 // Routine Description:
@@ -185,7 +187,12 @@ void InputBuffer::TerminateRead(_In_ WaitTerminationReason Flag)
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 {
-    return _storage.size();
+    size_t count = _storage.size();
+    for (const auto& run : _textRuns)
+    {
+        count += run.eventCount + run.following.size();
+    }
+    return count;
 }
 
 // Routine Description:
@@ -199,6 +206,7 @@ size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 void InputBuffer::Flush()
 {
     _storage.clear();
+    _textRuns.clear();
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
 }
 
@@ -212,10 +220,18 @@ void InputBuffer::Flush()
 // - The console lock must be held when calling this routine.
 void InputBuffer::FlushAllButKeys()
 {
-    auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const std::unique_ptr<IInputEvent>& event) {
-        return event->EventType() != InputEventType::KeyEvent;
-    });
-    _storage.erase(newEnd, _storage.end());
+    const auto flush = [](til::ring<INPUT_RECORD>& records) {
+        records.erase_if([](const INPUT_RECORD& record) {
+            return record.EventType != KEY_EVENT;
+        });
+    };
+
+    // Text runs only turn into key events, so they stay as they are.
+    flush(_storage);
+    for (auto& run : _textRuns)
+    {
+        flush(run.following);
+    }
 }
 
 // Routine Description:
@@ -244,6 +260,54 @@ void InputBuffer::FlushAllButKeys()
 {
     try
     {
+        // There can't be more records to read than there are events in the buffer.
+        std::vector<INPUT_RECORD> records(std::min(AmountToRead, GetNumberOfReadyEvents()));
+        size_t recordsRead = 0;
+        const auto Status = Read(records,
+                                 recordsRead,
+                                 Peek,
+                                 WaitForData,
+                                 Unicode,
+                                 Stream);
+
+        for (size_t i = 0; i < recordsRead; ++i)
+        {
+            OutEvents.push_back(IInputEvent::Create(til::at(records, i)));
+        }
+        return Status;
+    }
+    catch (...)
+    {
+        return NTSTATUS_FROM_HRESULT(wil::ResultFromCaughtException());
+    }
+}
+
+// Routine Description:
+// - This routine reads records from the input buffer, without turning them into IInputEvents.
+// - See the above overload for the details of the arguments, the only difference being
+//   that the amount of events to try to read is the size of the given records.
+// Note:
+// - The console lock must be held when calling this routine.
+// Arguments:
+// - records - where the read records are stored
+// - recordsRead - on exit, the number of records that were read
+// Return Value:
+// - STATUS_SUCCESS if records were read into the client buffer and everything is OK.
+// - CONSOLE_STATUS_WAIT if there weren't enough records to satisfy the request (and waits are allowed)
+// - otherwise a suitable memory/math/string error in NTSTATUS form.
+[[nodiscard]] NTSTATUS InputBuffer::Read(gsl::span<INPUT_RECORD> records,
+                                         _Out_ size_t& recordsRead,
+                                         const bool Peek,
+                                         const bool WaitForData,
+                                         const bool Unicode,
+                                         const bool Stream)
+{
+    recordsRead = 0;
+
+    try
+    {
+        _ExpandTextRuns(records.size());
+
         if (_storage.empty())
         {
             if (!WaitForData)
@@ -254,24 +318,14 @@ void InputBuffer::FlushAllButKeys()
         }
 
         // read from buffer
-        std::deque<std::unique_ptr<IInputEvent>> events;
-        size_t eventsRead;
         bool resetWaitEvent;
-        _ReadBuffer(events,
-                    AmountToRead,
-                    eventsRead,
+        _ReadBuffer(records,
+                    recordsRead,
                     Peek,
                     resetWaitEvent,
                     Unicode,
                     Stream);
 
-        // copy events to outEvents
-        while (!events.empty())
-        {
-            OutEvents.push_back(std::move(events.front()));
-            events.pop_front();
-        }
-
         if (resetWaitEvent)
         {
             ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
@@ -309,16 +363,17 @@ void InputBuffer::FlushAllButKeys()
     NTSTATUS Status;
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        Status = Read(outEvents,
-                      1,
+        INPUT_RECORD record;
+        size_t recordsRead = 0;
+        Status = Read(gsl::span<INPUT_RECORD>{ &record, 1 },
+                      recordsRead,
                       Peek,
                       WaitForData,
                       Unicode,
                       Stream);
-        if (!outEvents.empty())
+        if (recordsRead != 0)
         {
-            outEvent.swap(outEvents.front());
+            outEvent = IInputEvent::Create(record);
         }
     }
     catch (...)
@@ -332,8 +387,7 @@ void InputBuffer::FlushAllButKeys()
 // Routine Description:
 // - This routine reads from a buffer. It does the buffer manipulation.
 // Arguments:
-// - outEvents - where read events are placed
-// - readCount - amount of events to read
+// - records - where read records are placed. Its size is the amount of events to read.
 // - eventsRead - where to store number of events read
 // - peek - if true , don't remove data from buffer, just copy it.
 // - resetWaitEvent - on exit, true if buffer became empty.
@@ -343,111 +397,91 @@ void InputBuffer::FlushAllButKeys()
 // - <none>
 // Note:
 // - The console lock must be held when calling this routine.
-void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                              const size_t readCount,
+void InputBuffer::_ReadBuffer(gsl::span<INPUT_RECORD> records,
                               _Out_ size_t& eventsRead,
                               const bool peek,
                               _Out_ bool& resetWaitEvent,
                               const bool unicode,
                               const bool streamRead)
 {
+    const size_t readCount = records.size();
+
     // when stream reading, the previous behavior was to only allow reading of a single
     // event at a time.
     FAIL_FAST_IF(streamRead && readCount != 1);
 
     resetWaitEvent = false;
+    eventsRead = 0;
 
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
     // we need another var to keep track of how many we've read
     // because dbcs records count for two when we aren't doing a
     // unicode read but the eventsRead count should return the number
-    // of events actually put into outRecords.
+    // of events actually put into records.
     size_t virtualReadCount = 0;
 
     while (!_storage.empty() && virtualReadCount < readCount)
     {
-        bool performNormalRead = true;
+        auto& front = _storage.front();
+        auto& record = til::at(records, eventsRead);
+        record = front;
+
         // for stream reads we need to split any key events that have been coalesced
-        if (streamRead)
+        if (streamRead &&
+            front.EventType == KEY_EVENT &&
+            front.Event.KeyEvent.wRepeatCount > 1)
         {
-            if (_storage.front()->EventType() == InputEventType::KeyEvent)
-            {
-                KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.front().get());
-                if (pKeyEvent->GetRepeatCount() > 1)
-                {
-                    // split the key event
-                    std::unique_ptr<KeyEvent> streamKeyEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                    streamKeyEvent->SetRepeatCount(1);
-                    readEvents.push_back(std::move(streamKeyEvent));
-                    pKeyEvent->SetRepeatCount(pKeyEvent->GetRepeatCount() - 1);
-                    performNormalRead = false;
-                }
-            }
+            // split the key event
+            record.Event.KeyEvent.wRepeatCount = 1;
+            front.Event.KeyEvent.wRepeatCount--;
         }
-
-        if (performNormalRead)
+        else
         {
-            readEvents.push_back(std::move(_storage.front()));
             _storage.pop_front();
         }
 
+        ++eventsRead;
         ++virtualReadCount;
         if (!unicode)
         {
-            if (readEvents.back()->EventType() == InputEventType::KeyEvent)
+            if (record.EventType == KEY_EVENT &&
+                IsGlyphFullWidth(record.Event.KeyEvent.uChar.UnicodeChar))
             {
-                const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(readEvents.back().get());
-                if (IsGlyphFullWidth(pKeyEvent->GetCharData()))
-                {
-                    ++virtualReadCount;
-                }
+                ++virtualReadCount;
             }
         }
     }
 
-    // the amount of events that were actually read
-    eventsRead = readEvents.size();
-
     // copy the events back if we were supposed to peek
-    if (peek)
+    if (peek && eventsRead != 0)
     {
         if (streamRead)
         {
             // we need to check and see if the event was split from a coalesced key event
             // or if it was unrelated to the current front event in storage
-            if (!readEvents.empty() &&
-                !_storage.empty() &&
-                readEvents.back()->EventType() == InputEventType::KeyEvent &&
-                _storage.front()->EventType() == InputEventType::KeyEvent &&
-                _CanCoalesce(static_cast<const KeyEvent&>(*readEvents.back()),
-                             static_cast<const KeyEvent&>(*_storage.front())))
+            const auto& lastRecord = til::at(records, eventsRead - 1);
+            if (!_storage.empty() &&
+                lastRecord.EventType == KEY_EVENT &&
+                _storage.front().EventType == KEY_EVENT &&
+                _CanCoalesce(lastRecord.Event.KeyEvent, _storage.front().Event.KeyEvent))
             {
-                KeyEvent& keyEvent = static_cast<KeyEvent&>(*_storage.front());
-                keyEvent.SetRepeatCount(keyEvent.GetRepeatCount() + 1);
+                _storage.front().Event.KeyEvent.wRepeatCount++;
             }
             else
             {
-                _storage.push_front(IInputEvent::Create(readEvents.back()->ToInputRecord()));
+                _storage.push_front(lastRecord);
             }
         }
         else
         {
-            for (auto it = readEvents.crbegin(); it != readEvents.crend(); ++it)
+            for (size_t i = eventsRead; i > 0; --i)
             {
-                _storage.push_front(IInputEvent::Create((*it)->ToInputRecord()));
+                _storage.push_front(til::at(records, i - 1));
             }
         }
     }
 
-    // move events read to proper deque
-    while (!readEvents.empty())
-    {
-        outEvents.push_back(std::move(readEvents.front()));
-        readEvents.pop_front();
-    }
-
     // signal if we emptied the buffer
-    if (_storage.empty())
+    if (_storage.empty() && _textRuns.empty())
     {
         resetWaitEvent = true;
     }
@@ -457,19 +491,42 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 // -  Writes events to the beginning of the input buffer.
 // Arguments:
 // - inEvents - events to write to buffer.
-// - eventsWritten - The number of events written to the buffer on exit.
 // Return Value:
-// S_OK if successful.
+// - The number of events that were written to input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+{
+    try
+    {
+        const auto records = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        return Prepend(records);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// -  Writes records to the beginning of the input buffer.
+// Arguments:
+// - records - records to write to buffer.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Prepend(const gsl::span<const INPUT_RECORD> records)
 {
     try
     {
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        std::vector<INPUT_RECORD> remainingRecords;
+        const auto inRecords = _HandleConsoleSuspensionEvents(records, remainingRecords);
+        if (inRecords.empty())
         {
             return STATUS_SUCCESS;
         }
@@ -478,31 +535,38 @@ size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& in
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<std::unique_ptr<IInputEvent>> existingStorage;
-        existingStorage.swap(_storage);
+        const std::vector<INPUT_RECORD> existingStorage{ _storage.begin(), _storage.end() };
+        _storage.clear();
+
+        // The text runs follow all of the existing records, so they
+        // can simply be put back once everything else is written.
+        std::deque<TextRun> existingTextRuns;
+        existingTextRuns.swap(_textRuns);
+        auto restoreTextRuns = wil::scope_exit([&]() { _textRuns.swap(existingTextRuns); });
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
-        // However, because we swapped the storage out from under it with an empty deque, it will always
-        // return true after the first one (as it is filling the newly emptied backing deque.)
+        // However, because we cleared the storage out from under it, it will always
+        // return true after the first one (as it is filling the newly emptied storage.)
         // Then after the second one, because we've inserted some input, it will always say false.
         bool unusedWaitStatus = false;
 
         // write the prepend records
         size_t prependEventsWritten;
-        _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
+        _WriteBuffer(inRecords, prependEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(unusedWaitStatus));
 
         // write all previously existing records
         size_t existingEventsWritten;
         _WriteBuffer(existingStorage, existingEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(!unusedWaitStatus));
+        restoreTextRuns.reset();
 
         // We need to set the wait event if there were 0 events in the
         // input queue when we started.
         // Because we did interesting manipulation of the wait queue
         // in order to prepend, we can't trust what _WriteBuffer said
-        // and instead need to set the event if the original backing
-        // buffer (the one we swapped out at the top) was empty
+        // and instead need to set the event if the original storage
+        // (the one we copied out at the top) was empty
         // when this whole thing started.
         if (existingStorage.empty())
         {
@@ -531,12 +595,27 @@ size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& in
 // - any outside references to inEvent will ben invalidated after
 // calling this method.
 size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
+{
+    const auto record = inEvent->ToInputRecord();
+    return Write(gsl::span<const INPUT_RECORD>{ &record, 1 });
+}
+
+// Routine Description:
+// - Writes events to the input buffer. Wakes up any readers that are
+// waiting for additional input events.
+// Arguments:
+// - inEvents - input events to store in the buffer.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
 {
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
-        inEvents.push_back(std::move(inEvent));
-        return Write(inEvents);
+        const auto records = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        return Write(records);
     }
     catch (...)
     {
@@ -546,22 +625,23 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 }
 
 // Routine Description:
-// - Writes events to the input buffer. Wakes up any readers that are
+// - Writes records to the input buffer. Wakes up any readers that are
 // waiting for additional input events.
 // Arguments:
-// - inEvents - input events to store in the buffer.
+// - records - input records to store in the buffer.
 // Return Value:
 // - The number of events that were written to input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
-size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+size_t InputBuffer::Write(const gsl::span<const INPUT_RECORD> records)
 {
     try
     {
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        std::vector<INPUT_RECORD> remainingRecords;
+        const auto inRecords = _HandleConsoleSuspensionEvents(records, remainingRecords);
+        if (inRecords.empty())
         {
             return 0;
         }
@@ -569,7 +649,7 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
         // Write to buffer.
         size_t EventsWritten;
         bool SetWaitEvent;
-        _WriteBuffer(inEvents, EventsWritten, SetWaitEvent);
+        _WriteBuffer(inRecords, EventsWritten, SetWaitEvent);
 
         if (SetWaitEvent)
         {
@@ -587,6 +667,210 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
     }
 }
 
+// Routine Description:
+// - Writes text to the input buffer, as if it was typed on the keyboard. Wakes up
+// any readers that are waiting for additional input events.
+// - The text is stored as it is, and only turned into key events once they're read.
+// Readers of characters can read most of it directly, see ReadTextChar.
+// Arguments:
+// - text - the text to store in the buffer.
+// - codepage - the codepage used to enter characters that aren't part of the keyboard layout.
+// Return Value:
+// - The number of characters that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::WriteString(const std::wstring_view text, const unsigned int codepage)
+{
+    try
+    {
+        if (text.empty())
+        {
+            return 0;
+        }
+
+        // The VT input translation and the handling of suspended output both act on the key events
+        // as they're written. In these cases, the text needs to be written as key events right away.
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (IsInVirtualTerminalInputMode() || WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED))
+        {
+            std::vector<INPUT_RECORD> records;
+            for (const auto wch : text)
+            {
+                for (const auto& keyEvent : Microsoft::Console::Interactivity::CharToKeyEvents(wch, codepage))
+                {
+                    records.push_back(keyEvent->ToInputRecord());
+                }
+            }
+            Write(records);
+            return text.size();
+        }
+
+        size_t eventCount = 0;
+        for (const auto wch : text)
+        {
+            eventCount += Microsoft::Console::Interactivity::CountKeyEvents(wch, codepage);
+        }
+
+        const bool initiallyEmptyQueue = _storage.empty() && _textRuns.empty();
+
+        // Text that immediately follows another text run is simply added to it.
+        if (!_textRuns.empty() && _textRuns.back().following.empty() && _textRuns.back().codepage == codepage)
+        {
+            auto& run = _textRuns.back();
+            run.text.append(text);
+            run.eventCount += eventCount;
+        }
+        else
+        {
+            _textRuns.push_back({ std::wstring{ text }, 0, codepage, eventCount, {} });
+        }
+
+        if (initiallyEmptyQueue)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+
+        WakeUpReadersWaitingForData();
+        return text.size();
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Reads the next character directly from the text written by WriteString, without turning
+// it into key events first. This only applies to printable characters, which readers of
+// characters would take straight from the key events anyway. Anything else is left to be
+// read as key events, so that it's handled just like the key it stands for.
+// Arguments:
+// - wch - on exit, the character that was read.
+// - pdwKeyState - if present, on exit the modifier keys the character is typed with,
+// just like in the key event it would've been read from.
+// Return Value:
+// - true if a character was read. false if the next input in the buffer is anything
+// other than a printable character of a text run.
+// Note:
+// - The console lock must be held when calling this routine.
+bool InputBuffer::ReadTextChar(_Out_ wchar_t& wch, _Out_opt_ DWORD* const pdwKeyState)
+{
+    wch = UNICODE_NULL;
+
+    if (!_storage.empty() || _textRuns.empty())
+    {
+        return false;
+    }
+
+    auto& run = _textRuns.front();
+    const auto next = til::at(run.text, run.offset);
+    if (IS_CONTROL_CHAR(next) || next == UNICODE_DEL)
+    {
+        return false;
+    }
+
+    try
+    {
+        if (pdwKeyState)
+        {
+            *pdwKeyState = Microsoft::Console::Interactivity::CharToControlKeyState(next);
+        }
+
+        _ConsumeTextRunEvents(run, Microsoft::Console::Interactivity::CountKeyEvents(next, run.codepage));
+        if (++run.offset == run.text.size())
+        {
+            _PopTextRun();
+        }
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return false;
+    }
+
+    // signal if we emptied the buffer
+    if (_storage.empty() && _textRuns.empty())
+    {
+        ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
+    }
+
+    wch = next;
+    return true;
+}
+
+// Routine Description:
+// - Returns the events that newly written events are appended to. That's the storage
+// itself, unless there are text runs, in which case it's the events following the last one.
+// Arguments:
+// - <none>
+// Return Value:
+// - The events to append new events to.
+til::ring<INPUT_RECORD>& InputBuffer::_GetWriteTarget() noexcept
+{
+    return _textRuns.empty() ? _storage : _textRuns.back().following;
+}
+
+// Routine Description:
+// - Turns the characters of the text runs into key events, in order, until there
+// are at least the given number of events in storage or no text runs are left.
+// Arguments:
+// - count - The number of events that need to be in storage.
+// Return Value:
+// - <none>
+// Note:
+// - The console lock must be held when calling this routine.
+// - will throw on failure
+void InputBuffer::_ExpandTextRuns(const size_t count)
+{
+    while (_storage.size() < count && !_textRuns.empty())
+    {
+        auto& run = _textRuns.front();
+        auto keyEvents = Microsoft::Console::Interactivity::CharToKeyEvents(til::at(run.text, run.offset), run.codepage);
+        _ConsumeTextRunEvents(run, keyEvents.size());
+        for (const auto& keyEvent : keyEvents)
+        {
+            _storage.push_back(keyEvent->ToInputRecord());
+        }
+
+        if (++run.offset == run.text.size())
+        {
+            _PopTextRun();
+        }
+    }
+}
+
+// Routine Description:
+// - Takes the key events of a character that was just read off the number of events
+// the text run is still going to turn into.
+// - The count is only an estimate, since the keyboard layout might have changed since
+// the text was written, and a character might turn into more events now than then.
+// Arguments:
+// - run - The text run the character was read from.
+// - count - The number of key events the character turned into.
+// Return Value:
+// - <none>
+void InputBuffer::_ConsumeTextRunEvents(TextRun& run, const size_t count) noexcept
+{
+    run.eventCount -= std::min(run.eventCount, count);
+}
+
+// Routine Description:
+// - Removes the first text run, once all of its characters have been read. The events
+// that were written after it are moved into storage, since they're up next.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InputBuffer::_PopTextRun()
+{
+    for (const auto& record : _textRuns.front().following)
+    {
+        _storage.push_back(record);
+    }
+    _textRuns.pop_front();
+}
+
 // Routine Description:
 // - Coalesces input events and transfers them to storage queue.
 // Arguments:
@@ -599,28 +883,25 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw on failure
-void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+void InputBuffer::_WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
                                _Out_ size_t& eventsWritten,
                                _Out_ bool& setWaitEvent)
 {
     eventsWritten = 0;
     setWaitEvent = false;
-    const bool initiallyEmptyQueue = _storage.empty();
-    const size_t initialInEventsSize = inEvents.size();
+    const bool initiallyEmptyQueue = _storage.empty() && _textRuns.empty();
     const bool vtInputMode = IsInVirtualTerminalInputMode();
 
-    while (!inEvents.empty())
+    for (const auto& record : inRecords)
     {
-        // Pop the next event.
         // If we're in vt mode, try and handle it with the vt input module.
         // If it was handled, do nothing else for it.
         // If there was one event passed in, try coalescing it with the previous event currently in the buffer.
         // If it's not coalesced, append it to the buffer.
-        std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (vtInputMode)
+        if (vtInputMode && record.EventType == KEY_EVENT)
         {
-            const bool handled = _termInput.HandleKey(inEvent.get());
+            const KeyEvent keyEvent{ record.Event.KeyEvent };
+            const bool handled = _termInput.HandleKey(&keyEvent);
             if (handled)
             {
                 eventsWritten++;
@@ -632,42 +913,19 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
         // record at a time because this is the original behavior of
         // the input buffer. Changing this behavior may break stuff
         // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty())
+        if (inRecords.size() == 1 && !_GetWriteTarget().empty())
         {
-            // coalescing requires a deque of events, so push it back onto the front.
-            inEvents.push_front(std::move(inEvent));
-
-            bool coalesced = false;
             // this looks kinda weird but we don't want to coalesce a
             // mouse event and then try to coalesce a key event right after.
-            //
-            // we also pass the whole deque to the coalescing methods
-            // even though they only want one event because it should
-            // be their responsibility to maintain the correct state
-            // of the deque if they process any records in it.
-            if (_CoalesceMouseMovedEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            else if (_CoalesceRepeatedKeyPressEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            if (coalesced)
+            if (_CoalesceMouseMovedEvents(record) ||
+                _CoalesceRepeatedKeyPressEvents(record))
             {
                 eventsWritten = 1;
                 return;
             }
-            else
-            {
-                // We didn't coalesce the event. pull it from the queue again,
-                //  to keep the state consistent with the start of this block.
-                inEvent = std::move(inEvents.front());
-                inEvents.pop_front();
-            }
         }
         // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(std::move(inEvent));
+        _GetWriteTarget().push_back(record);
         ++eventsWritten;
     }
     if (initiallyEmptyQueue && !_storage.empty())
@@ -677,67 +935,54 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
 }
 
 // Routine Description:
-// - Checks if the last saved event and the first event of inRecords are
+// - Checks if the last saved event and the incoming record are
 // both MOUSE_MOVED events. If they are, the last saved event is
-// updated with the new mouse position and the first event of inRecords is
-// dropped.
+// updated with the new mouse position in place.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord)
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::MouseEvent &&
-        pLastStoredEvent->EventType() == InputEventType::MouseEvent)
+    auto& storage = _GetWriteTarget();
+    FAIL_FAST_IF(storage.empty());
+    auto& lastRecord = storage.back();
+    if (inRecord.EventType == MOUSE_EVENT &&
+        lastRecord.EventType == MOUSE_EVENT &&
+        inRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED &&
+        lastRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED)
     {
-        const MouseEvent* const pInMouseEvent = static_cast<const MouseEvent* const>(pFirstInEvent);
-        const MouseEvent* const pLastMouseEvent = static_cast<const MouseEvent* const>(pLastStoredEvent);
-
-        if (pInMouseEvent->IsMouseMoveEvent() &&
-            pLastMouseEvent->IsMouseMoveEvent())
-        {
-            // update mouse moved position
-            MouseEvent* const pMouseEvent = static_cast<MouseEvent* const>(_storage.back().release());
-            pMouseEvent->SetPosition(pInMouseEvent->GetPosition());
-            std::unique_ptr<IInputEvent> tempPtr(pMouseEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
-            return true;
-        }
+        // update mouse moved position
+        lastRecord.Event.MouseEvent.dwMousePosition = inRecord.Event.MouseEvent.dwMousePosition;
+        return true;
     }
     return false;
 }
 
 // Routine Description:
-// - checks two KeyEvents to see if they're similar enough to be coalesced
+// - checks two key event records to see if they're similar enough to be coalesced
 // Arguments:
-// - a - the first KeyEvent
-// - b - the other KeyEvent
+// - a - the first key event
+// - b - the other key event
 // Return Value:
 // - true if the events could be coalesced, false otherwise
-bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept
+bool InputBuffer::_CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept
 {
-    if (WI_IsFlagSet(a.GetActiveModifierKeys(), NLS_IME_CONVERSION) &&
-        a.GetCharData() == b.GetCharData() &&
-        a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    if (WI_IsFlagSet(a.dwControlKeyState, NLS_IME_CONVERSION) &&
+        a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+        a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
     // other key events check
-    else if (a.GetVirtualScanCode() == b.GetVirtualScanCode() &&
-             a.GetCharData() == b.GetCharData() &&
-             a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    else if (a.wVirtualScanCode == b.wVirtualScanCode &&
+             a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+             a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
@@ -745,44 +990,36 @@ bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexc
 }
 
 // Routine Description::
-// - If the last input event saved and the first input event in inRecords
-// are both a keypress down event for the same key, update the repeat
-// count of the saved event and drop the first from inRecords.
+// - If the last input event saved and the incoming record are both a
+// keypress down event for the same key, update the repeat count of
+// the saved event in place.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
-{
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::KeyEvent &&
-        pLastStoredEvent->EventType() == InputEventType::KeyEvent)
-    {
-        const KeyEvent* const pInKeyEvent = static_cast<const KeyEvent* const>(pFirstInEvent);
-        const KeyEvent* const pLastKeyEvent = static_cast<const KeyEvent* const>(pLastStoredEvent);
-
-        if (pInKeyEvent->IsKeyDown() &&
-            pLastKeyEvent->IsKeyDown() &&
-            !IsGlyphFullWidth(pInKeyEvent->GetCharData()) &&
-            _CanCoalesce(*pInKeyEvent, *pLastKeyEvent))
+bool InputBuffer::_CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord)
+{
+    auto& storage = _GetWriteTarget();
+    FAIL_FAST_IF(storage.empty());
+    auto& lastRecord = storage.back();
+    if (inRecord.EventType == KEY_EVENT &&
+        lastRecord.EventType == KEY_EVENT)
+    {
+        const auto& inKeyEvent = inRecord.Event.KeyEvent;
+        auto& lastKeyEvent = lastRecord.Event.KeyEvent;
+
+        if (inKeyEvent.bKeyDown &&
+            lastKeyEvent.bKeyDown &&
+            !IsGlyphFullWidth(inKeyEvent.uChar.UnicodeChar) &&
+            _CanCoalesce(inKeyEvent, lastKeyEvent))
         {
             // increment repeat count
-            KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.back().release());
-            WORD repeatCount = pKeyEvent->GetRepeatCount() + pInKeyEvent->GetRepeatCount();
-            pKeyEvent->SetRepeatCount(repeatCount);
-            std::unique_ptr<IInputEvent> tempPtr(pKeyEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
+            lastKeyEvent.wRepeatCount += inKeyEvent.wRepeatCount;
             return true;
         }
     }
@@ -793,41 +1030,57 @@ bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique
 // - Handles records that suspend/resume the console.
 // Arguments:
 // - records - records to check for pause/unpause events
+// - remainingRecords - storage for the records that weren't handled. It's only
+// used if any of the records were handled.
 // Return Value:
-// - None
+// - The records that weren't handled. These are either records itself, or remainingRecords.
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw exception on error
-void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+gsl::span<const INPUT_RECORD> InputBuffer::_HandleConsoleSuspensionEvents(const gsl::span<const INPUT_RECORD> records,
+                                                                         std::vector<INPUT_RECORD>& remainingRecords)
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
 
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    while (!inEvents.empty())
+    bool handledAny = false;
+    for (size_t i = 0; i < records.size(); ++i)
     {
-        std::unique_ptr<IInputEvent> currEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (currEvent->EventType() == InputEventType::KeyEvent)
+        const auto& record = til::at(records, i);
+        if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown)
         {
-            const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(currEvent.get());
-            if (pKeyEvent->IsKeyDown())
+            bool handled = false;
+            if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
+                !IsSystemKey(record.Event.KeyEvent.wVirtualKeyCode))
             {
-                if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
-                    !IsSystemKey(pKeyEvent->GetVirtualKeyCode()))
-                {
-                    UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
-                    continue;
-                }
-                else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && pKeyEvent->IsPauseKey())
+                UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
+                handled = true;
+            }
+            else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && record.Event.KeyEvent.wVirtualKeyCode == VK_PAUSE)
+            {
+                WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
+                handled = true;
+            }
+
+            if (handled)
+            {
+                // The records only need to be copied once the first one is dropped.
+                if (!handledAny)
                 {
-                    WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
-                    continue;
+                    const auto preceding = records.first(i);
+                    remainingRecords.assign(preceding.begin(), preceding.end());
+                    handledAny = true;
                 }
+                continue;
             }
         }
-        outEvents.push_back(std::move(currEvent));
+
+        if (handledAny)
+        {
+            remainingRecords.push_back(record);
+        }
     }
-    inEvents.swap(outEvents);
+
+    return handledAny ? gsl::span<const INPUT_RECORD>{ remainingRecords } : records;
 }
 
 // Routine Description:
@@ -853,12 +1106,12 @@ void InputBuffer::_HandleTerminalInputCallback(std::deque<std::unique_ptr<IInput
     try
     {
         // add all input events to the storage queue
-        while (!inEvents.empty())
+        auto& storage = _GetWriteTarget();
+        for (const auto& inEvent : inEvents)
         {
-            std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
-            inEvents.pop_front();
-            _storage.push_back(std::move(inEvent));
+            storage.push_back(inEvent->ToInputRecord());
         }
+        inEvents.clear();
 
         if (!_vtInputShouldSuppress)
         {
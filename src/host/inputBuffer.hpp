@@ -62,6 +62,13 @@ public:
                                 const bool Unicode,
                                 const bool Stream);
 
+    [[nodiscard]] NTSTATUS Read(gsl::span<INPUT_RECORD> records,
+                                _Out_ size_t& recordsRead,
+                                const bool Peek,
+                                const bool WaitForData,
+                                const bool Unicode,
+                                const bool Stream);
+
     [[nodiscard]] NTSTATUS Read(_Out_ std::unique_ptr<IInputEvent>& inEvent,
                                 const bool Peek,
                                 const bool WaitForData,
@@ -69,15 +76,37 @@ public:
                                 const bool Stream);
 
     size_t Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Prepend(const gsl::span<const INPUT_RECORD> records);
 
     size_t Write(_Inout_ std::unique_ptr<IInputEvent> inEvent);
     size_t Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Write(const gsl::span<const INPUT_RECORD> records);
+    size_t WriteString(const std::wstring_view text, const unsigned int codepage);
+
+    bool ReadTextChar(_Out_ wchar_t& wch, _Out_opt_ DWORD* const pdwKeyState);
 
     bool IsInVirtualTerminalInputMode() const;
     Microsoft::Console::VirtualTerminal::TerminalInput& GetTerminalInput();
 
 private:
-    std::deque<std::unique_ptr<IInputEvent>> _storage;
+    // A run of text written to the buffer in one go, like a paste. Its characters are
+    // only turned into key events once they're read as such, see _ExpandTextRuns.
+    struct TextRun
+    {
+        std::wstring text;
+        size_t offset;
+        unsigned int codepage;
+        // The number of key events the remaining characters turn into.
+        size_t eventCount;
+        // The events written after the text, which are read once the text is used up.
+        til::ring<INPUT_RECORD> following;
+    };
+
+    // The events are stored as plain records, so that queueing and coalescing them
+    // doesn't allocate. They're only turned into IInputEvents by the callers that need them.
+    til::ring<INPUT_RECORD> _storage;
+    // The text runs that follow the events in _storage.
+    std::deque<TextRun> _textRuns;
     std::unique_ptr<IInputEvent> _readPartialByteSequence;
     std::unique_ptr<IInputEvent> _writePartialByteSequence;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -88,22 +117,27 @@ private:
     // Otherwise, we should be calling them.
     bool _vtInputShouldSuppress{ false };
 
-    void _ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                     const size_t readCount,
+    void _ReadBuffer(gsl::span<INPUT_RECORD> records,
                      _Out_ size_t& eventsRead,
                      const bool peek,
                      _Out_ bool& resetWaitEvent,
                      const bool unicode,
                      const bool streamRead);
 
-    void _WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inRecords,
+    void _WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
                       _Out_ size_t& eventsWritten,
                       _Out_ bool& setWaitEvent);
 
-    bool _CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept;
-    bool _CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    bool _CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    void _HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    til::ring<INPUT_RECORD>& _GetWriteTarget() noexcept;
+    void _ExpandTextRuns(const size_t count);
+    static void _ConsumeTextRunEvents(TextRun& run, const size_t count) noexcept;
+    void _PopTextRun();
+
+    bool _CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept;
+    bool _CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord);
+    bool _CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord);
+    gsl::span<const INPUT_RECORD> _HandleConsoleSuspensionEvents(const gsl::span<const INPUT_RECORD> records,
+                                                                 std::vector<INPUT_RECORD>& remainingRecords);
 
     void _HandleTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
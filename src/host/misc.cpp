@@ -204,47 +204,41 @@ BOOL CheckBisectProcessW(const SCREEN_INFORMATION& ScreenInfo,
 }
 
 // Routine Description:
-// - Converts all key events in the deque to the oem char data and adds
-// them back to events.
+// - Converts all key events in the records to the oem char data and adds
+// them back to records.
 // Arguments:
-// - events - on input the IInputEvents to convert. on output, the
-// converted input events
+// - records - on input the records to convert. on output, the
+// converted records
 // Note: may throw on error
-void SplitToOem(std::deque<std::unique_ptr<IInputEvent>>& events)
+void SplitToOem(std::vector<INPUT_RECORD>& records)
 {
     const UINT codepage = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
 
-    // convert events to oem codepage
-    std::deque<std::unique_ptr<IInputEvent>> convertedEvents;
-    while (!events.empty())
+    // convert records to oem codepage
+    std::vector<INPUT_RECORD> convertedRecords;
+    convertedRecords.reserve(records.size());
+    for (const auto& record : records)
     {
-        std::unique_ptr<IInputEvent> currentEvent = std::move(events.front());
-        events.pop_front();
-        if (currentEvent->EventType() == InputEventType::KeyEvent)
+        if (record.EventType == KEY_EVENT)
         {
-            const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(currentEvent.get());
             // convert from wchar to char
-            std::wstring wstr{ pKeyEvent->GetCharData() };
-            const auto str = ConvertToA(codepage, wstr);
+            const auto wch = record.Event.KeyEvent.uChar.UnicodeChar;
+            const auto str = ConvertToA(codepage, { &wch, 1 });
 
             for (auto& ch : str)
             {
-                std::unique_ptr<KeyEvent> tempEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                tempEvent->SetCharData(ch);
-                convertedEvents.push_back(std::move(tempEvent));
+                auto tempRecord = record;
+                tempRecord.Event.KeyEvent.uChar.UnicodeChar = ch;
+                convertedRecords.push_back(tempRecord);
             }
         }
         else
         {
-            convertedEvents.push_back(std::move(currentEvent));
+            convertedRecords.push_back(record);
         }
     }
-    // move all events back
-    while (!convertedEvents.empty())
-    {
-        events.push_back(std::move(convertedEvents.front()));
-        convertedEvents.pop_front();
-    }
+    // move all records back
+    records.swap(convertedRecords);
 }
 
 // Routine Description:
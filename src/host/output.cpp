@@ -92,23 +92,22 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
         }
     }
 
-    // 2. We can move any other scenario in-place without copying. We just have to carefully
-    //    choose which direction we walk through filling up the target so it doesn't accidentally
-    //    erase the source material before it can be copied/moved to the new location.
+    // 2. We can move any other scenario in-place without copying, one row segment at a time.
+    //    Each segment is moved as a block, so it may overlap its source within the same row.
+    //    We just have to carefully choose which direction we walk through the rows so that
+    //    we don't accidentally erase a source row before it can be copied/moved to the new location.
     {
-        const auto target = Viewport::FromDimensions(targetOrigin, source.Dimensions());
-        const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
+        auto& textBuffer = screenInfo.GetTextBuffer();
+        const auto height = source.Height();
+        const auto walkUp = targetOrigin.Y > source.Top();
 
-        auto sourcePos = source.GetWalkOrigin(walkDirection);
-        auto targetPos = target.GetWalkOrigin(walkDirection);
-
-        do
+        for (SHORT i = 0; i < height; ++i)
         {
-            const auto data = OutputCell(*screenInfo.GetCellDataAt(sourcePos));
-            screenInfo.Write(OutputCellIterator({ &data, 1 }), targetPos);
-
-            source.WalkInBounds(sourcePos, walkDirection);
-        } while (target.WalkInBounds(targetPos, walkDirection));
+            const auto offset = gsl::narrow_cast<SHORT>(walkUp ? height - 1 - i : i);
+            const COORD sourcePos{ source.Left(), gsl::narrow<SHORT>(source.Top() + offset) };
+            const COORD targetPos{ targetOrigin.X, gsl::narrow<SHORT>(targetOrigin.Y + offset) };
+            textBuffer.CopyCells(sourcePos, targetPos, source.Width());
+        }
     }
 }
 
@@ -130,6 +130,27 @@ bool ConhostInternalGetSet::SetConsoleCursorPosition(const COORD position)
     return SUCCEEDED(ServiceLocator::LocateGlobals().api.SetConsoleCursorPositionImpl(info, clampedPosition));
 }
 
+// Method Description:
+// - Retrieves just the cursor position, viewport and buffer size of the active
+//   screen buffer. This is the subset of GetConsoleScreenBufferInfoEx that the
+//   VT cursor movement and erase operations need, without the cost of
+//   collecting the color table and the maximum window size on every sequence.
+// Arguments:
+// - cursorPosition - Receives the cursor position, in buffer coordinates.
+// - viewport - Receives the viewport, as an exclusive rect (like srWindow in
+//   the result of GetConsoleScreenBufferInfoEx).
+// - bufferSize - Receives the dimensions of the buffer.
+// Return Value:
+// - true if successful. false otherwise.
+bool ConhostInternalGetSet::PrivateGetCursorAndViewport(COORD& cursorPosition, SMALL_RECT& viewport, COORD& bufferSize) const
+{
+    const auto& screenInfo = _io.GetActiveOutputBuffer().GetActiveBuffer();
+    cursorPosition = screenInfo.GetTextBuffer().GetCursor().GetPosition();
+    viewport = screenInfo.GetViewport().ToExclusive();
+    bufferSize = screenInfo.GetBufferSize().Dimensions();
+    return true;
+}
+
 // Method Description:
 // - Retrieves the current TextAttribute of the active screen buffer.
 // Arguments:
@@ -200,22 +221,38 @@ SHORT ConhostInternalGetSet::PrivateGetLineWidth(const size_t row) const
 // Routine Description:
 // - Connects the WriteConsoleInput API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
-// - events - the input events to be copied into the head of the input
+// - records - the input records to be copied into the tail of the input
 //            buffer for the underlying attached process
 // - eventsWritten - on output, the number of events written
 // Return Value:
 // - true if successful (see DoSrvWriteConsoleInput). false otherwise.
-bool ConhostInternalGetSet::PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
+bool ConhostInternalGetSet::PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                                       size_t& eventsWritten)
 {
     eventsWritten = 0;
 
     return SUCCEEDED(DoSrvPrivateWriteConsoleInputW(_io.GetActiveInputBuffer(),
-                                                    events,
+                                                    records,
                                                     eventsWritten,
                                                     true)); // append
 }
 
+// Routine Description:
+// - Connects a string of input directly into the input buffer of Conhost.exe, which stores
+//   it as it is until it's read, instead of converting it into input events up front.
+// Arguments:
+// - string - the text to append to the input buffer, as if it was typed
+// - codepage - the codepage used to enter characters that aren't part of the keyboard layout
+// Return Value:
+// - true if successful (see DoSrvPrivateWriteConsoleInputString). false otherwise.
+bool ConhostInternalGetSet::PrivateWriteConsoleInputString(const std::wstring_view string,
+                                                           const unsigned int codepage)
+{
+    return SUCCEEDED(DoSrvPrivateWriteConsoleInputString(_io.GetActiveInputBuffer(),
+                                                         string,
+                                                         codepage));
+}
+
 // Routine Description:
 // - Connects the SetConsoleWindowInfo API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
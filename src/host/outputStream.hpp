@@ -58,6 +58,7 @@ public:
     bool SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX& screenBufferInfo) override;
 
     bool SetConsoleCursorPosition(const COORD position) override;
+    bool PrivateGetCursorAndViewport(COORD& cursorPosition, SMALL_RECT& viewport, COORD& bufferSize) const override;
 
     bool PrivateGetTextAttributes(TextAttribute& attrs) const override;
     bool PrivateSetTextAttributes(const TextAttribute& attrs) override;
@@ -66,8 +67,10 @@ public:
     bool PrivateResetLineRenditionRange(const size_t startRow, const size_t endRow) override;
     SHORT PrivateGetLineWidth(const size_t row) const override;
 
-    bool PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
+    bool PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                    size_t& eventsWritten) override;
+    bool PrivateWriteConsoleInputString(const std::wstring_view string,
+                                        const unsigned int codepage) override;
 
     bool SetConsoleWindowInfo(bool const absolute,
                               const SMALL_RECT& window) override;
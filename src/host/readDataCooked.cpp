@@ -953,6 +953,17 @@ void COOKED_READ_DATA::SavePendingInput(const size_t index, const bool multiline
             _originalCursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
         }
 
+        // Plain characters at the end of the line are appended together with any
+        // that directly follow them, like the rest of a paste. The character that
+        // ends such a run, if any, is then processed as usual.
+        if (!commandLineEditingKeys && _canAppendPlainChar(wch))
+        {
+            if (!_appendPlainCharRun(wch, wch, commandLineEditingKeys, keyState))
+            {
+                continue;
+            }
+        }
+
         if (commandLineEditingKeys)
         {
             // TODO: this is super weird for command line popups only
@@ -991,6 +1002,89 @@ void COOKED_READ_DATA::SavePendingInput(const size_t index, const bool multiline
     return Status;
 }
 
+// Routine Description:
+// - Checks whether a character can be appended to the line as part of a run of plain
+//   characters. That's the case for characters that ProcessInput would simply store and
+//   echo, as long as the line is edited at its end and there's room for the character.
+// Arguments:
+// - wch - the character to check
+// Return Value:
+// - true if the character can be appended by _appendPlainCharRun
+bool COOKED_READ_DATA::_canAppendPlainChar(const wchar_t wch) const noexcept
+{
+    // ProcessInput drops characters once all but the room for the carriage return and line feed is used up.
+    const auto isPlain = !IS_CONTROL_CHAR(wch) && wch != UNICODE_DEL && wch != UNICODE_BACKSPACE2;
+    return isPlain && AtEol() && _bytesRead + 2 * sizeof(wchar_t) < _bufferSize;
+}
+
+// Routine Description:
+// - Appends a plain character to the end of the line, together with all plain characters
+//   that are already waiting in the input buffer behind it. The whole run is echoed with
+//   a single write, instead of redrawing the line for every character.
+// Arguments:
+// - wch - the plain character that was read. _canAppendPlainChar must be true for it.
+// - next - on exit, the character that was read after the run, if any
+// - commandLineEditingKeys - on exit, true if next is a command line editing key
+// - keyState - on exit, the modifier key state that came with next
+// Return Value:
+// - true if a character was read after the run, which still needs to be processed. false otherwise.
+bool COOKED_READ_DATA::_appendPlainCharRun(const wchar_t wch, wchar_t& next, bool& commandLineEditingKeys, DWORD& keyState) noexcept
+{
+    // The characters are stored right where they belong, since the line is edited at its end.
+    const size_t capacity = (_bufferSize - _bytesRead) / sizeof(wchar_t) - 2;
+    size_t count = 0;
+    _bufPtr[count++] = wch;
+
+    bool haveNext = false;
+    while (count < capacity)
+    {
+        // Don't wait for more input. Once the input buffer is empty, the run is over.
+        if (!NT_SUCCESS(GetChar(_pInputBuffer, &next, false, &commandLineEditingKeys, nullptr, &keyState)))
+        {
+            break;
+        }
+
+        if (commandLineEditingKeys || !_canAppendPlainChar(next))
+        {
+            haveNext = true;
+            break;
+        }
+
+        _bufPtr[count++] = next;
+    }
+
+    if (_echoInput)
+    {
+        size_t NumSpaces = 0;
+        SHORT ScrollY = 0;
+        size_t NumToWrite = count * sizeof(wchar_t);
+        const NTSTATUS status = WriteCharsLegacy(_screenInfo,
+                                                 _backupLimit,
+                                                 _bufPtr,
+                                                 _bufPtr,
+                                                 &NumToWrite,
+                                                 &NumSpaces,
+                                                 _originalCursorPosition.X,
+                                                 WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
+                                                 &ScrollY);
+        if (NT_SUCCESS(status))
+        {
+            _originalCursorPosition.Y += ScrollY;
+        }
+        else
+        {
+            RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed %x", status);
+        }
+        _visibleCharCount += NumSpaces;
+    }
+
+    _bytesRead += count * sizeof(wchar_t);
+    _bufPtr += count;
+    _currentPosition += count;
+
+    return haveNext;
+}
+
 // Routine Description:
 // - handles any tasks that need to be completed after the read input loop finishes
 // Arguments:
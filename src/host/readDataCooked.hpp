@@ -156,5 +156,8 @@ private:
 
     [[nodiscard]] NTSTATUS _readCharInputLoop(const bool isUnicode, size_t& numBytes) noexcept;
 
+    bool _canAppendPlainChar(const wchar_t wch) const noexcept;
+    bool _appendPlainCharRun(const wchar_t wch, wchar_t& next, bool& commandLineEditingKeys, DWORD& keyState) noexcept;
+
     [[nodiscard]] NTSTATUS _handlePostCharInputLoop(const bool isUnicode, size_t& numBytes, ULONG& controlKeyState) noexcept;
 };
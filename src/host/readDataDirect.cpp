@@ -19,17 +19,17 @@
 // input handle to return partial data appropriately.
 // the user's buffer (pOutRecords)
 // - eventReadCount - the number of events to read
-// - partialEvents - any partial events already read
+// - partialRecords - any partial records already read
 // Return Value:
 // - THROW: Throws E_INVALIDARG for invalid pointers.
 DirectReadData::DirectReadData(_In_ InputBuffer* const pInputBuffer,
                                _In_ INPUT_READ_HANDLE_DATA* const pInputReadHandleData,
                                const size_t eventReadCount,
-                               _In_ std::deque<std::unique_ptr<IInputEvent>> partialEvents) :
+                               _In_ std::vector<INPUT_RECORD> partialRecords) :
     ReadData(pInputBuffer, pInputReadHandleData),
     _eventReadCount{ eventReadCount },
-    _partialEvents{ std::move(partialEvents) },
-    _outEvents{}
+    _partialRecords{ std::move(partialRecords) },
+    _outRecords{}
 {
 }
 
@@ -82,7 +82,7 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
     *pControlKeyState = 0;
     *pNumBytes = 0;
     bool retVal = true;
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
+    std::vector<INPUT_RECORD> readRecords;
 
     // If ctrl-c or ctrl-break was seen, ignore it.
     if (WI_IsAnyFlagSet(TerminationReason, (WaitTerminationReason::CtrlC | WaitTerminationReason::CtrlBreak)))
@@ -95,7 +95,7 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
         _pInputBuffer->IsReadPartialByteSequenceAvailable() &&
         _eventReadCount == 1)
     {
-        _partialEvents.push_back(_pInputBuffer->FetchReadPartialByteSequence(false));
+        _partialRecords.push_back(_pInputBuffer->FetchReadPartialByteSequence(false)->ToInputRecord());
     }
 
     // See if called by CsrDestroyProcess or CsrDestroyThread
@@ -120,7 +120,7 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
 
         // calculate how many events we need to read
         size_t amountAlreadyRead;
-        if (FAILED(SizeTAdd(_partialEvents.size(), _outEvents.size(), &amountAlreadyRead)))
+        if (FAILED(SizeTAdd(_partialRecords.size(), _outRecords.size(), &amountAlreadyRead)))
         {
             *pReplyStatus = STATUS_INTEGER_OVERFLOW;
             return retVal;
@@ -132,12 +132,16 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
             return retVal;
         }
 
-        *pReplyStatus = _pInputBuffer->Read(readEvents,
-                                            amountToRead,
+        // There can't be more records to read than there are events in the buffer.
+        readRecords.resize(std::min(amountToRead, _pInputBuffer->GetNumberOfReadyEvents()));
+        size_t recordsRead = 0;
+        *pReplyStatus = _pInputBuffer->Read(readRecords,
+                                            recordsRead,
                                             false,
                                             false,
                                             fIsUnicode,
                                             false);
+        readRecords.resize(recordsRead);
 
         if (*pReplyStatus == CONSOLE_STATUS_WAIT)
         {
@@ -152,41 +156,34 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
         {
             try
             {
-                SplitToOem(readEvents);
+                SplitToOem(readRecords);
             }
             CATCH_LOG();
         }
 
-        // combine partial and whole events
-        while (!_partialEvents.empty())
-        {
-            readEvents.push_front(std::move(_partialEvents.back()));
-            _partialEvents.pop_back();
-        }
+        // combine partial and whole records
+        readRecords.insert(readRecords.begin(), _partialRecords.begin(), _partialRecords.end());
+        _partialRecords.clear();
 
-        // move read events to out storage
-        for (size_t i = 0; i < _eventReadCount; ++i)
-        {
-            if (readEvents.empty())
-            {
-                break;
-            }
-            _outEvents.push_back(std::move(readEvents.front()));
-            readEvents.pop_front();
-        }
+        // move read records to out storage
+        const auto recordsToReturn = std::min(_eventReadCount, readRecords.size());
+        _outRecords.insert(_outRecords.end(), readRecords.begin(), readRecords.begin() + gsl::narrow_cast<ptrdiff_t>(recordsToReturn));
 
         // store partial event if necessary
-        if (!readEvents.empty())
+        if (readRecords.size() > recordsToReturn)
         {
-            _pInputBuffer->StoreReadPartialByteSequence(std::move(readEvents.front()));
-            readEvents.pop_front();
-            FAIL_FAST_IF(!(readEvents.empty()));
+            _pInputBuffer->StoreReadPartialByteSequence(IInputEvent::Create(til::at(readRecords, recordsToReturn)));
+            FAIL_FAST_IF(readRecords.size() > recordsToReturn + 1);
         }
 
-        // move events to pOutputData
+        // move records to pOutputData, which is the first place they're needed as events
         std::deque<std::unique_ptr<IInputEvent>>* const pOutputDeque = reinterpret_cast<std::deque<std::unique_ptr<IInputEvent>>* const>(pOutputData);
-        *pNumBytes = _outEvents.size() * sizeof(INPUT_RECORD);
-        pOutputDeque->swap(_outEvents);
+        *pNumBytes = _outRecords.size() * sizeof(INPUT_RECORD);
+        for (const auto& record : _outRecords)
+        {
+            pOutputDeque->push_back(IInputEvent::Create(record));
+        }
+        _outRecords.clear();
     }
     return retVal;
 }
@@ -470,6 +470,17 @@ void RenderData::ColorSelection(const COORD coordSelectionStart, const COORD coo
     Selection::Instance().ColorSelection(coordSelectionStart, coordSelectionEnd, attr);
 }
 
+// Routine Description:
+// - Returns the text of the rows the searches of the console keep between them.
+// Arguments:
+// - <none>
+// Return Value:
+// - The search index, which searches lock on their own.
+SearchIndex& RenderData::GetSearchIndex() noexcept
+{
+    return _searchIndex;
+}
+
 // Method Description:
 // - Returns true if the screen is globally inverted
 // Arguments:
@@ -70,5 +70,11 @@ public:
     const COORD GetSelectionAnchor() const noexcept;
     const COORD GetSelectionEnd() const noexcept;
     void ColorSelection(const COORD coordSelectionStart, const COORD coordSelectionEnd, const TextAttribute attr);
+    SearchIndex& GetSearchIndex() noexcept override;
 #pragma endregion
+
+private:
+    // The text of the rows the last search looked at, so the next one only
+    // needs to flatten the rows that have changed since.
+    SearchIndex _searchIndex;
 };
@@ -60,6 +60,13 @@ using Microsoft::Console::Interactivity::ServiceLocator;
     NTSTATUS Status;
     for (;;)
     {
+        // Printable characters of text that was written in one go, like a paste,
+        // can be read without turning them into key events first.
+        if (pInputBuffer->ReadTextChar(*pwchOut, pdwKeyState))
+        {
+            return STATUS_SUCCESS;
+        }
+
         std::unique_ptr<IInputEvent> inputEvent;
         Status = pInputBuffer->Read(inputEvent,
                                     false, // peek
@@ -189,26 +196,34 @@ size_t RetrieveTotalNumberOfSpaces(const SHORT sOriginalCursorPositionX,
     SHORT XPosition = sOriginalCursorPositionX;
     size_t NumSpaces = 0;
 
-    for (size_t i = 0; i < ulCurrentPosition; i++)
+    for (size_t i = 0; i < ulCurrentPosition;)
     {
-        WCHAR const Char = pwchBuffer[i];
-
-        size_t NumSpacesForChar;
-        if (Char == UNICODE_TAB)
+        // Measure everything up to the next control character in one go.
+        // Only tabs depend on the position they're at.
+        const size_t RunStart = i;
+        while (i < ulCurrentPosition && !IS_CONTROL_CHAR(pwchBuffer[i]))
         {
-            NumSpacesForChar = NUMBER_OF_SPACES_IN_TAB(XPosition);
+            i++;
         }
-        else if (IS_CONTROL_CHAR(Char))
+
+        if (i != RunStart)
         {
-            NumSpacesForChar = 2;
+            const size_t NumSpacesForRun = MeasureGlyphRun({ pwchBuffer + RunStart, i - RunStart });
+            XPosition = (SHORT)(XPosition + NumSpacesForRun);
+            NumSpaces += NumSpacesForRun;
+            continue;
         }
-        else if (IsGlyphFullWidth(Char))
+
+        WCHAR const Char = pwchBuffer[i++];
+
+        size_t NumSpacesForChar;
+        if (Char == UNICODE_TAB)
         {
-            NumSpacesForChar = 2;
+            NumSpacesForChar = NUMBER_OF_SPACES_IN_TAB(XPosition);
         }
         else
         {
-            NumSpacesForChar = 1;
+            NumSpacesForChar = 2;
         }
         XPosition = (SHORT)(XPosition + NumSpacesForChar);
         NumSpaces += NumSpacesForChar;
@@ -91,11 +91,61 @@ class CodepointWidthDetectorTests
 
         // Cached item should match what we expect
         const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
+        VERIFY_ARE_EQUAL(0x414u, it->first);
         VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
 
         // Cache should empty when font changes.
         widthDetector.NotifyFontChanged();
         VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
     }
+
+    TEST_METHOD(CanLookUpRangeBoundaries)
+    {
+        // The edges of ranges in the generated table, including ones that don't start or end on a block boundary.
+        static constexpr std::array<std::pair<unsigned int, CodepointWidth>, 10> boundaries{ {
+            { 0xa0, CodepointWidth::Narrow },
+            { 0xa1, CodepointWidth::Ambiguous },
+            { 0xa2, CodepointWidth::Narrow },
+            { 0x1f9ff, CodepointWidth::Wide },
+            { 0x1fa00, CodepointWidth::Narrow },
+            { 0x20000, CodepointWidth::Wide },
+            { 0x2fffd, CodepointWidth::Wide },
+            { 0x2fffe, CodepointWidth::Narrow },
+            { 0x10fffd, CodepointWidth::Ambiguous },
+            { 0x10ffff, CodepointWidth::Narrow },
+        } };
+
+        for (const auto& [codepoint, expected] : boundaries)
+        {
+            Log::Comment(NoThrowString().Format(L"U+%X", codepoint));
+            VERIFY_ARE_EQUAL(expected, CodepointWidthDetector::_lookupCodepointWidth(codepoint));
+        }
+
+        for (const auto& data : testData)
+        {
+            VERIFY_ARE_EQUAL(std::get<2>(data), CodepointWidthDetector::_lookupCodepointWidth(std::get<0>(data)));
+        }
+    }
+
+    TEST_METHOD(CanMeasureRun)
+    {
+        CodepointWidthDetector widthDetector;
+
+        // "a" + hiragana na + cyrillic de + "b"
+        const std::wstring_view text{ L"a\x306A\x414"
+                                L"b" };
+        VERIFY_ARE_EQUAL(5u, widthDetector.MeasureRun(text));
+        VERIFY_ARE_EQUAL(0u, widthDetector.MeasureRun({}));
+
+        size_t expected = 0;
+        for (const auto wch : text)
+        {
+            expected += widthDetector.IsWide(wch) ? 2 : 1;
+        }
+        VERIFY_ARE_EQUAL(expected, widthDetector.MeasureRun(text));
+
+        // Ambiguous characters are measured through the fallback when there is one.
+        widthDetector.SetFallbackMethod([](const std::wstring_view) { return true; });
+        VERIFY_ARE_EQUAL(6u, widthDetector.MeasureRun(text));
+    }
 };
@@ -534,4 +534,43 @@ class CommandLineTests
             }
         }
     }
+
+    TEST_METHOD(PlainCharsAreAppendedAsARun)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& cookedReadData = gci.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+
+        Log::Comment(L"The text up to the backspace is appended as a run, followed by the backspace and the rest of the text.");
+        const std::wstring_view text{ L"echo hellp\bo" };
+        VERIFY_ARE_EQUAL(gci.pInputBuffer->WriteString(text, CP_UTF8), text.size());
+
+        size_t numBytes = PROMPT_SIZE * sizeof(wchar_t);
+        VERIFY_ARE_EQUAL(cookedReadData._readCharInputLoop(true, numBytes), CONSOLE_STATUS_WAIT);
+        VerifyPromptText(cookedReadData, L"echo hello");
+        VERIFY_ARE_EQUAL(gci.pInputBuffer->GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(PlainCharRunsLeaveRoomForTheLineEnding)
+    {
+        constexpr size_t bufferSize = 8;
+        auto buffer = std::make_unique<wchar_t[]>(bufferSize);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& cookedReadData = gci.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), bufferSize);
+
+        Log::Comment(L"Characters beyond the room for the carriage return and line feed are dropped, just like when they're typed.");
+        const std::wstring_view text{ L"abcdefghij" };
+        VERIFY_ARE_EQUAL(gci.pInputBuffer->WriteString(text, CP_UTF8), text.size());
+
+        size_t numBytes = bufferSize * sizeof(wchar_t);
+        VERIFY_ARE_EQUAL(cookedReadData._readCharInputLoop(true, numBytes), CONSOLE_STATUS_WAIT);
+        VerifyPromptText(cookedReadData, L"abcdef");
+        VERIFY_ARE_EQUAL(gci.pInputBuffer->GetNumberOfReadyEvents(), 0u);
+    }
 };
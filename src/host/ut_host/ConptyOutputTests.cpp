@@ -93,6 +93,7 @@ class ConptyOutputTests
         gci.GetActiveOutputBuffer().SetTerminalConnection(vtRenderEngine.get());
 
         expectedOutput.clear();
+        _onWrite = nullptr;
 
         // Manually set the console into conpty mode. We're not actually going
         // to set up the pipes for conpty, but we want the console to behave
@@ -119,11 +120,14 @@ class ConptyOutputTests
     TEST_METHOD(WriteTwoLinesUsesNewline);
     TEST_METHOD(WriteAFewSimpleLines);
     TEST_METHOD(InvalidateUntilOneBeforeEnd);
+    TEST_METHOD(PaintFromSnapshotWithoutTheLock);
 
 private:
     bool _writeCallback(const char* const pch, size_t const cch);
     void _flushFirstFrame();
     std::deque<std::string> expectedOutput;
+    // Called before the next string written by the engine is checked, in the middle of its frame.
+    std::function<void()> _onWrite;
     std::unique_ptr<CommonState> m_state;
 };
 
@@ -133,6 +137,14 @@ bool ConptyOutputTests::_writeCallback(const char* const pch, size_t const cch)
     // we need to rely on VERIFY's return codes instead of exceptions.
     const WEX::TestExecution::DisableVerifyExceptions disableExceptionsScope;
 
+    if (_onWrite)
+    {
+        // Let go of it first, so that anything it writes doesn't call it again.
+        const auto onWrite = std::move(_onWrite);
+        _onWrite = nullptr;
+        onWrite();
+    }
+
     std::string actualString = std::string(pch, cch);
     RETURN_BOOL_IF_FALSE(VERIFY_IS_GREATER_THAN(expectedOutput.size(),
                                                 static_cast<size_t>(0),
@@ -364,3 +376,58 @@ void ConptyOutputTests::InvalidateUntilOneBeforeEnd()
 
     VERIFY_SUCCEEDED(renderer.PaintFrame());
 }
+
+void ConptyOutputTests::PaintFromSnapshotWithoutTheLock()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Paint a frame from a snapshot of the console. The console lock should be let go of "
+        L"while the engine paints, and whatever happens to the console meanwhile, circling "
+        L"included, should be queued up for the next frame."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& sm = si.GetStateMachine();
+    auto& engine = static_cast<Xterm256Engine&>(*renderer._rgpEngines.front());
+
+    renderer.SetPaintFromSnapshot(true);
+
+    _flushFirstFrame();
+
+    sm.ProcessString(L"Hello");
+    expectedOutput.push_back("Hello");
+
+    bool lockedDuringPaint = true;
+    size_t queuedDuringPaint = 0;
+    bool circledDuringPaint = true;
+    _onWrite = [&]() {
+        lockedDuringPaint = gci.IsConsoleLocked();
+
+        // Circling used to wait for the frame to be done, which can't ever happen on this thread.
+        sm.ProcessString(L" World");
+        renderer.TriggerCircling();
+
+        queuedDuringPaint = renderer._pendingInvalidations.size();
+        circledDuringPaint = engine._circled;
+    };
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    VERIFY_IS_FALSE(lockedDuringPaint, L"The console shouldn't be locked while the frame is painted.");
+    VERIFY_IS_GREATER_THAN(queuedDuringPaint, static_cast<size_t>(1), L"The text and the circling should both have been queued up.");
+    VERIFY_IS_FALSE(circledDuringPaint, L"The engine shouldn't hear about the circling in the middle of its frame.");
+    VERIFY_IS_FALSE(renderer._pendingInvalidations.empty(), L"The invalidations should wait for the next frame.");
+
+    Log::Comment(L"The next frame should pick up where the console went on without us.");
+    _onWrite = [&]() {
+        circledDuringPaint = engine._circled;
+    };
+    expectedOutput.push_back(" World");
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    VERIFY_IS_TRUE(circledDuringPaint, L"The engine should have been told about the circling at the beginning of the frame.");
+    VERIFY_IS_TRUE(renderer._pendingInvalidations.empty());
+    VERIFY_IS_FALSE(engine._circled);
+}
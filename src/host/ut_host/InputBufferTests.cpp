@@ -7,6 +7,7 @@
 #include "CommonState.hpp"
 
 #include "../interactivity/inc/ServiceLocator.hpp"
+#include "../interactivity/inc/EventSynthesis.hpp"
 #include "../types/inc/IInputEvent.hpp"
 
 using namespace WEX::Logging;
@@ -57,6 +58,14 @@ class InputBufferTests
         return retval;
     }
 
+    INPUT_RECORD MakeMouseEvent()
+    {
+        INPUT_RECORD retval{};
+        retval.EventType = MOUSE_EVENT;
+        retval.Event.MouseEvent.dwButtonState = FROM_LEFT_1ST_BUTTON_PRESSED;
+        return retval;
+    }
+
     TEST_METHOD(CanGetNumberOfReadyEvents)
     {
         InputBuffer inputBuffer;
@@ -78,7 +87,7 @@ class InputBufferTests
             INPUT_RECORD record;
             record.EventType = MENU_EVENT;
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back()->ToInputRecord());
+            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back());
         }
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
     }
@@ -98,10 +107,42 @@ class InputBufferTests
         // verify that the events are the same in storage
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i]->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i], record);
         }
     }
 
+    TEST_METHOD(CanWriteAndReadRecords)
+    {
+        InputBuffer inputBuffer;
+        INPUT_RECORD inRecords[RECORD_INSERT_COUNT];
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            inRecords[i] = MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i), 0, static_cast<WCHAR>(L'A' + i), 0);
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Write(inRecords), RECORD_INSERT_COUNT);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
+
+        // a single record is coalesced in place with the one before it
+        VERIFY_ARE_EQUAL(inputBuffer.Write(gsl::make_span(&inRecords[RECORD_INSERT_COUNT - 1], 1)), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.back().Event.KeyEvent.wRepeatCount, 2u);
+
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
+        size_t recordsRead = 0;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 recordsRead,
+                                                 false,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_ARE_EQUAL(recordsRead, RECORD_INSERT_COUNT);
+        for (size_t i = 0; i < RECORD_INSERT_COUNT - 1; ++i)
+        {
+            VERIFY_ARE_EQUAL(outRecords[i], inRecords[i]);
+        }
+        VERIFY_IS_TRUE(inputBuffer._storage.empty());
+    }
+
     TEST_METHOD(InputBufferCoalescesMouseEvents)
     {
         InputBuffer inputBuffer;
@@ -121,10 +162,9 @@ class InputBufferTests
         // check that they coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
         // check that the mouse position is being updated correctly
-        const IInputEvent* const pOutEvent = inputBuffer._storage.front().get();
-        const MouseEvent* const pMouseEvent = static_cast<const MouseEvent* const>(pOutEvent);
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().X, static_cast<SHORT>(RECORD_INSERT_COUNT));
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
+        const auto& mouseEvent = inputBuffer._storage.front().Event.MouseEvent;
+        VERIFY_ARE_EQUAL(mouseEvent.dwMousePosition.X, static_cast<SHORT>(RECORD_INSERT_COUNT));
+        VERIFY_ARE_EQUAL(mouseEvent.dwMousePosition.Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
 
         // add a key event and another mouse event to make sure that
         // an event between two mouse events stopped the coalescing.
@@ -162,10 +202,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), mouseRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), mouseRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), mouseRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], mouseRecords[i]);
         }
     }
 
@@ -221,10 +261,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), keyRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), keyRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), keyRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], keyRecords[i]);
         }
     }
 
@@ -239,7 +279,7 @@ class InputBufferTests
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(inputBuffer._storage.back()->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage.back(), record);
         }
 
         // The events shouldn't be coalesced
@@ -382,11 +422,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read one record, make sure ResetWaitEvent isn't set
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
-                                1,
+        inputBuffer._ReadBuffer(gsl::make_span(outRecords, 1),
                                 eventsRead,
                                 false,
                                 resetWaitEvent,
@@ -396,9 +435,7 @@ class InputBufferTests
         VERIFY_IS_FALSE(!!resetWaitEvent);
 
         // read the rest, resetWaitEvent should be set to true
-        outEvents.clear();
-        inputBuffer._ReadBuffer(outEvents,
-                                RECORD_INSERT_COUNT - 1,
+        inputBuffer._ReadBuffer(gsl::make_span(outRecords, RECORD_INSERT_COUNT - 1),
                                 eventsRead,
                                 false,
                                 resetWaitEvent,
@@ -431,11 +468,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read them out non-unicode style and compare
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecords[recordInsertCount];
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
-                                recordInsertCount,
+        inputBuffer._ReadBuffer(outRecords,
                                 eventsRead,
                                 false,
                                 resetWaitEvent,
@@ -444,10 +480,9 @@ class InputBufferTests
         // the dbcs record should have counted for two elements in
         // the array, making it so that we get less events read
         VERIFY_ARE_EQUAL(eventsRead, recordInsertCount - 1);
-        VERIFY_ARE_EQUAL(eventsRead, outEvents.size());
         for (size_t i = 0; i < eventsRead; ++i)
         {
-            VERIFY_ARE_EQUAL(outEvents[i]->ToInputRecord(), inRecords[i]);
+            VERIFY_ARE_EQUAL(outRecords[i], inRecords[i]);
         }
     }
 
@@ -625,7 +660,7 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount - 1);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount - 1);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
 
@@ -645,7 +680,100 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
+
+    TEST_METHOD(WrittenStringsAreReadAsKeyEvents)
+    {
+        InputBuffer inputBuffer;
+        const std::wstring_view text{ L"Hi!" };
+        const unsigned int codepage = CP_UTF8;
+
+        std::vector<INPUT_RECORD> expected;
+        for (const auto wch : text)
+        {
+            for (const auto& keyEvent : Microsoft::Console::Interactivity::CharToKeyEvents(wch, codepage))
+            {
+                expected.push_back(keyEvent->ToInputRecord());
+            }
+        }
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(text, codepage), text.size());
+        Log::Comment(L"The text is stored as it is until it's read.");
+        VERIFY_IS_TRUE(inputBuffer._storage.empty());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), expected.size());
+
+        Log::Comment(L"Events written after the text come after its key events.");
+        const INPUT_RECORD mouseRecord = MakeMouseEvent();
+        VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(mouseRecord)), 1u);
+        expected.push_back(mouseRecord);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), expected.size());
+
+        Log::Comment(L"Reading a single event only turns the first character into key events.");
+        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents, 1, false, false, true, false));
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size() + 1, Microsoft::Console::Interactivity::CountKeyEvents(L'H', codepage));
+
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents, expected.size(), false, false, true, false));
+        VERIFY_ARE_EQUAL(outEvents.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected.at(i), outEvents.at(i)->ToInputRecord());
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(WrittenStringsAreReadAsChars)
+    {
+        InputBuffer inputBuffer;
+        const unsigned int codepage = CP_UTF8;
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(L"ab", codepage), 2u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(L"\r", codepage), 1u);
+        Log::Comment(L"Text written right after other text is appended to it.");
+        VERIFY_ARE_EQUAL(inputBuffer._textRuns.size(), 1u);
+
+        const INPUT_RECORD mouseRecord = MakeMouseEvent();
+        VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(mouseRecord)), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(L"c", codepage), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._textRuns.size(), 2u);
+
+        Log::Comment(L"The modifier keys are those of the key event the character would've been read from.");
+        DWORD expectedKeyState = 0;
+        for (const auto& keyEvent : Microsoft::Console::Interactivity::CharToKeyEvents(L'a', codepage))
+        {
+            if (keyEvent->GetCharData() == L'a')
+            {
+                expectedKeyState = keyEvent->GetActiveModifierKeys();
+            }
+        }
+
+        wchar_t wch;
+        DWORD keyState = 0;
+        VERIFY_IS_TRUE(inputBuffer.ReadTextChar(wch, &keyState));
+        VERIFY_ARE_EQUAL(L'a', wch);
+        VERIFY_ARE_EQUAL(expectedKeyState, keyState);
+        VERIFY_IS_TRUE(inputBuffer.ReadTextChar(wch, nullptr));
+        VERIFY_ARE_EQUAL(L'b', wch);
+        VERIFY_IS_TRUE(inputBuffer._storage.empty());
+
+        Log::Comment(L"Control characters have to be read as key events.");
+        VERIFY_IS_FALSE(inputBuffer.ReadTextChar(wch, nullptr));
+        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        const auto returnEvents = Microsoft::Console::Interactivity::CountKeyEvents(L'\r', codepage);
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents, returnEvents, false, false, true, false));
+        VERIFY_ARE_EQUAL(outEvents.size(), returnEvents);
+
+        Log::Comment(L"The mouse event comes before the text written after it.");
+        VERIFY_IS_FALSE(inputBuffer.ReadTextChar(wch, nullptr));
+        outEvents.clear();
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents, 1, false, false, true, false));
+        VERIFY_ARE_EQUAL(mouseRecord, outEvents.front()->ToInputRecord());
+
+        VERIFY_IS_TRUE(inputBuffer.ReadTextChar(wch, nullptr));
+        VERIFY_ARE_EQUAL(L'c', wch);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+        VERIFY_IS_FALSE(inputBuffer.ReadTextChar(wch, nullptr));
+    }
 };
@@ -11,8 +11,7 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 
-#include <deque>
-#include <memory>
+#include <vector>
 
 using namespace WEX::Logging;
 using Microsoft::Console::Interactivity::ServiceLocator;
@@ -45,22 +44,22 @@ class InputRecordConversionTests
     {
         Log::Comment(L"nothing should happen to input events that aren't key events");
 
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
+        std::vector<INPUT_RECORD> records;
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT] = { 0 };
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
             inRecords[i].EventType = MOUSE_EVENT;
             inRecords[i].Event.MouseEvent.dwMousePosition.X = static_cast<SHORT>(i);
             inRecords[i].Event.MouseEvent.dwMousePosition.Y = static_cast<SHORT>(i * 2);
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
+            records.push_back(inRecords[i]);
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, inEvents.size());
+        SplitToOem(records);
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, records.size());
 
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inRecords[i], inEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(inRecords[i], records[i]);
         }
     }
 
@@ -68,21 +67,21 @@ class InputRecordConversionTests
     {
         Log::Comment(L"non-dbcs chars shouldn't be split");
 
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
+        std::vector<INPUT_RECORD> records;
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT] = { 0 };
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
             inRecords[i].EventType = KEY_EVENT;
             inRecords[i].Event.KeyEvent.uChar.UnicodeChar = static_cast<wchar_t>(L'a' + i);
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
+            records.push_back(inRecords[i]);
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, inEvents.size());
+        SplitToOem(records);
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, records.size());
 
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inRecords[i], inEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(inRecords[i], records[i]);
         }
     }
 
@@ -93,7 +92,7 @@ class InputRecordConversionTests
         const UINT codepage = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
 
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT * 2] = { 0 };
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
+        std::vector<INPUT_RECORD> records;
         // U+3042 hiragana letter A
         wchar_t hiraganaA = 0x3042;
         wchar_t inChars[INPUT_RECORD_COUNT];
@@ -103,11 +102,11 @@ class InputRecordConversionTests
             inRecords[i].EventType = KEY_EVENT;
             inRecords[i].Event.KeyEvent.uChar.UnicodeChar = currentChar;
             inChars[i] = currentChar;
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
+            records.push_back(inRecords[i]);
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT * 2, inEvents.size());
+        SplitToOem(records);
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT * 2, records.size());
 
         // create the data to compare the output to
         char dbcsChars[INPUT_RECORD_COUNT * 2] = { 0 };
@@ -122,8 +121,7 @@ class InputRecordConversionTests
         VERIFY_ARE_EQUAL(writtenBytes, static_cast<int>(INPUT_RECORD_COUNT * 2));
         for (size_t i = 0; i < INPUT_RECORD_COUNT * 2; ++i)
         {
-            const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(inEvents[i].get());
-            VERIFY_ARE_EQUAL(static_cast<char>(pKeyEvent->GetCharData()), dbcsChars[i]);
+            VERIFY_ARE_EQUAL(static_cast<char>(records[i].Event.KeyEvent.uChar.UnicodeChar), dbcsChars[i]);
         }
     }
 };
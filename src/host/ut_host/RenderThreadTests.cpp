@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include <wextestclass.h>
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../renderer/base/thread.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace Microsoft::Console::Render
+{
+    class RenderThreadTests;
+}
+using namespace Microsoft::Console::Render;
+using namespace std::chrono_literals;
+
+// The tests drive the frame pacing with made up times, which start here. It's far
+// enough from the epoch that a thread that hasn't painted yet has been idle since.
+static constexpr auto t0 = std::chrono::steady_clock::time_point{ std::chrono::hours{ 1 } };
+
+class Microsoft::Console::Render::RenderThreadTests
+{
+    TEST_CLASS(RenderThreadTests);
+
+    TEST_METHOD(FirstFrameIsImmediate);
+    TEST_METHOD(FrameAfterIdleIsImmediate);
+    TEST_METHOD(FramesInQuickSuccessionArePaced);
+    TEST_METHOD(FrameIntervalFollowsPaintDuration);
+    TEST_METHOD(FrameIntervalIsClamped);
+    TEST_METHOD(RecordFrameUpdatesStatistics);
+};
+
+void RenderThreadTests::FirstFrameIsImmediate()
+{
+    RenderThread thread;
+
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0).count());
+    VERIFY_IS_TRUE(thread._immediateFrame);
+}
+
+void RenderThreadTests::FrameAfterIdleIsImmediate()
+{
+    RenderThread thread;
+    thread._RecordFrame(t0, t0 + 2ms, 0);
+
+    Log::Comment(L"A frame requested just before the idle time is up is a paced frame...");
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0 + 2ms + 16ms - 1ns).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+
+    Log::Comment(L"...but one requested after it is painted right away, like the echo of a keystroke.");
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0 + 2ms + 16ms).count());
+    VERIFY_IS_TRUE(thread._immediateFrame);
+}
+
+void RenderThreadTests::FramesInQuickSuccessionArePaced()
+{
+    RenderThread thread;
+    thread._RecordFrame(t0, t0 + 2ms, 0);
+
+    Log::Comment(L"Painting is cheap, so the next frame is due the minimum interval after the last one started.");
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 3ms }.count(), thread._GetFrameDelay(t0 + 5ms).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+
+    Log::Comment(L"Once that time has passed, the frame is due right away, but it's still a paced frame.");
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0 + 10ms).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+}
+
+void RenderThreadTests::FrameIntervalFollowsPaintDuration()
+{
+    RenderThread thread;
+    thread._averagePaintDuration = 6ms;
+    thread._lastPaintStart = t0;
+    thread._lastPaintEnd = t0 + 6ms;
+
+    Log::Comment(L"Frames start twice the paint duration apart.");
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 5ms }.count(), thread._GetFrameDelay(t0 + 7ms).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+}
+
+void RenderThreadTests::FrameIntervalIsClamped()
+{
+    RenderThread thread;
+
+    Log::Comment(L"Fast paints don't make frames start closer together than the minimum interval.");
+    thread._averagePaintDuration = 1ms;
+    thread._lastPaintStart = t0;
+    thread._lastPaintEnd = t0 + 1ms;
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 6ms }.count(), thread._GetFrameDelay(t0 + 2ms).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+
+    Log::Comment(L"Slow paints don't make frames start further apart than the maximum interval.");
+    thread._averagePaintDuration = 40ms;
+    thread._lastPaintStart = t0;
+    thread._lastPaintEnd = t0 + 40ms;
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 9ms }.count(), thread._GetFrameDelay(t0 + 41ms).count());
+    VERIFY_IS_FALSE(thread._immediateFrame);
+}
+
+void RenderThreadTests::RecordFrameUpdatesStatistics()
+{
+    RenderThread thread;
+
+    Log::Comment(L"An immediate frame, requested 3ms before it was started and painted in 8ms.");
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0).count());
+    thread._RecordFrame(t0, t0 + 8ms, (t0 - 3ms).time_since_epoch().count());
+
+    auto statistics = thread.GetFrameStatistics();
+    VERIFY_ARE_EQUAL(1u, statistics.frames);
+    VERIFY_ARE_EQUAL(1u, statistics.immediateFrames);
+    VERIFY_ARE_EQUAL(8000, statistics.lastPaintDuration.count());
+    VERIFY_ARE_EQUAL(11000, statistics.lastLatency.count());
+    VERIFY_ARE_EQUAL(11000, statistics.maxLatency.count());
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 1ms }.count(), thread._averagePaintDuration.count());
+
+    Log::Comment(L"A paced frame, requested 1ms before it was started and painted in 2ms.");
+    VERIFY_ARE_EQUAL(0, thread._GetFrameDelay(t0 + 10ms).count());
+    thread._RecordFrame(t0 + 10ms, t0 + 12ms, (t0 + 9ms).time_since_epoch().count());
+
+    statistics = thread.GetFrameStatistics();
+    VERIFY_ARE_EQUAL(2u, statistics.frames);
+    VERIFY_ARE_EQUAL(1u, statistics.immediateFrames);
+    VERIFY_ARE_EQUAL(2000, statistics.lastPaintDuration.count());
+    VERIFY_ARE_EQUAL(3000, statistics.lastLatency.count());
+    VERIFY_ARE_EQUAL(11000, statistics.maxLatency.count());
+    VERIFY_ARE_EQUAL(std::chrono::nanoseconds{ 1125us }.count(), thread._averagePaintDuration.count());
+
+    Log::Comment(L"A frame without a request time leaves the latencies alone.");
+    thread._RecordFrame(t0 + 20ms, t0 + 21ms, 0);
+
+    statistics = thread.GetFrameStatistics();
+    VERIFY_ARE_EQUAL(3u, statistics.frames);
+    VERIFY_ARE_EQUAL(3000, statistics.lastLatency.count());
+    VERIFY_ARE_EQUAL(11000, statistics.maxLatency.count());
+}
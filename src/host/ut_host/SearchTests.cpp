@@ -156,4 +156,50 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    TEST_METHOD(FindAll)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"b\x304b", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+        const auto& matches = s.FindAll();
+        VERIFY_ARE_EQUAL(4u, matches.size());
+        for (SHORT row = 0; row < 4; ++row)
+        {
+            VERIFY_ARE_EQUAL((COORD{ 1, row }), matches.at(row).first);
+            VERIFY_ARE_EQUAL((COORD{ 3, row }), matches.at(row).second);
+        }
+
+        Search caseSensitive(gci.renderData, L"b\x304b", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_ARE_EQUAL(0u, caseSensitive.FindAll().size());
+        VERIFY_IS_FALSE(caseSensitive.FindNext());
+    }
+
+    TEST_METHOD(FindAllPicksUpChangedRows)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto lastColumn = textBuffer.GetSize().RightInclusive();
+
+        // This search leaves the text of the rows in the search index.
+        Search before(gci.renderData, L"xyB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_ARE_EQUAL(0u, before.FindAll().size());
+
+        Log::Comment(L"Write a word which runs from the end of the second row into the third.");
+        textBuffer.Write(OutputCellIterator{ std::wstring_view{ L"xy" } }, { lastColumn, 1 });
+
+        Search after(gci.renderData, L"xyB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        const auto& matches = after.FindAll();
+        VERIFY_ARE_EQUAL(1u, matches.size());
+        VERIFY_ARE_EQUAL((COORD{ lastColumn, 1 }), matches.at(0).first);
+        VERIFY_ARE_EQUAL((COORD{ 1, 2 }), matches.at(0).second);
+
+        Log::Comment(L"The rows that didn't change are still found, the one that did isn't anymore.");
+        Search unchanged(gci.renderData, L"AB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        const auto& unchangedMatches = unchanged.FindAll();
+        VERIFY_ARE_EQUAL(3u, unchangedMatches.size());
+        VERIFY_ARE_EQUAL((COORD{ 0, 0 }), unchangedMatches.at(0).first);
+        VERIFY_ARE_EQUAL((COORD{ 0, 1 }), unchangedMatches.at(1).first);
+        VERIFY_ARE_EQUAL((COORD{ 0, 3 }), unchangedMatches.at(2).first);
+    }
 };
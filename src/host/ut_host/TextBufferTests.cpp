@@ -75,6 +75,8 @@ class TextBufferTests
 
     TEST_METHOD(TestBufferRowByOffset);
 
+    TEST_METHOD(TestRowGeneration);
+
     TEST_METHOD(TestWrapFlag);
 
     TEST_METHOD(TestWrapThroughWriteLine);
@@ -137,9 +139,19 @@ class TextBufferTests
     TEST_METHOD(TestRepeatCharacter);
 
     TEST_METHOD(ResizeTraditional);
+    TEST_METHOD(ResizeTraditionalKeepsRowsInSingleAllocation);
+
+    TEST_METHOD(GetPatternsAcrossWrappedRows);
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(ScrollRowsOnlyMovesRowsInRegion);
+    TEST_METHOD(WriteLineCollectsUnusedGlyphs);
+
+    TEST_METHOD(CharRowCopyCells);
+    TEST_METHOD(RowCopyCells);
+    TEST_METHOD(RowCopyCellsPadsDoubleWidthEdges);
+    TEST_METHOD(TextBufferCopyCells);
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
@@ -156,6 +168,7 @@ class TextBufferTests
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkRefCounts);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -192,6 +205,32 @@ void TextBufferTests::TestBufferRowByOffset()
     VERIFY_ARE_EQUAL(row.GetId(), sId);
 }
 
+void TextBufferTests::TestRowGeneration()
+{
+    TextBuffer& textBuffer = GetTbi();
+    const auto& row = textBuffer.GetRowByOffset(0);
+    const auto& otherRow = textBuffer.GetRowByOffset(1);
+
+    Log::Comment(L"Every row starts out with a generation of its own.");
+    VERIFY_ARE_NOT_EQUAL(row.GetGeneration(), otherRow.GetGeneration());
+
+    Log::Comment(L"Reading a row doesn't change its generation.");
+    auto generation = row.GetGeneration();
+    const auto attr = row.GetAttrRow().GetAttrByColumn(0);
+    VERIFY_ARE_EQUAL(generation, row.GetGeneration());
+
+    Log::Comment(L"Writing to a row does, and leaves the other rows alone.");
+    const auto otherGeneration = otherRow.GetGeneration();
+    textBuffer.WriteLine(OutputCellIterator(L"ABC", attr), { 0, 0 });
+    VERIFY_ARE_NOT_EQUAL(generation, row.GetGeneration());
+    VERIFY_ARE_EQUAL(otherGeneration, otherRow.GetGeneration());
+
+    Log::Comment(L"So does resetting it.");
+    generation = row.GetGeneration();
+    textBuffer.GetRowByOffset(0).Reset(attr);
+    VERIFY_ARE_NOT_EQUAL(generation, row.GetGeneration());
+}
+
 void TextBufferTests::TestWrapFlag()
 {
     TextBuffer& textBuffer = GetTbi();
@@ -1828,6 +1867,86 @@ void TextBufferTests::ResizeTraditional()
     }
 }
 
+void TextBufferTests::ResizeTraditionalKeepsRowsInSingleAllocation()
+{
+    const COORD bufferSize{ 8, 6 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0 }, 12, _renderTarget);
+
+    const auto verifyRowsWithinStorage = [&](const COORD size) {
+        const auto first = buffer._charBuffer.data();
+        const auto last = first + buffer._charBuffer.size();
+        VERIFY_ARE_EQUAL(static_cast<size_t>(size.X * size.Y), buffer._charBuffer.size());
+
+        for (SHORT y = 0; y < size.Y; ++y)
+        {
+            auto& charRow = buffer.GetRowByOffset(y).GetCharRow();
+            VERIFY_ARE_EQUAL(static_cast<size_t>(size.X), charRow.size());
+            VERIFY_IS_TRUE(charRow.begin() >= first && charRow.end() <= last);
+        }
+    };
+
+    Log::Comment(L"All rows are views into the same cell storage.");
+    verifyRowsWithinStorage(bufferSize);
+
+    Log::Comment(L"Cycle the buffer so that the first row isn't at the start of the storage, then resize.");
+    buffer.GetCursor().SetPosition({ 0, 5 });
+    buffer.Write(OutputCellIterator{ L"ABCDEFGH" });
+    buffer.IncrementCircularBuffer();
+    buffer.GetCursor().SetPosition({ 0, 4 });
+
+    const COORD newSize{ 12, 5 };
+    VERIFY_SUCCEEDED(buffer.ResizeTraditional(newSize));
+    verifyRowsWithinStorage(newSize);
+
+    Log::Comment(L"The written text survived the move into the new storage.");
+    VERIFY_ARE_EQUAL(L"ABCDEFGH    ", buffer.GetRowByOffset(4).GetText());
+}
+
+void TextBufferTests::GetPatternsAcrossWrappedRows()
+{
+    const COORD bufferSize{ 20, 4 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0 }, 12, _renderTarget);
+    const auto id = buffer.AddPatternRecognizer(LR"(\bhttps?://[^ ]+)");
+
+    Log::Comment(L"Write a URL that wraps from the first into the second row, and one that doesn't wrap.");
+    buffer.WriteLine(OutputCellIterator{ L"go to http://example" }, { 0, 0 });
+    buffer.GetRowByOffset(0).SetWrapForced(true);
+    buffer.WriteLine(OutputCellIterator{ L".com/x now" }, { 0, 1 });
+    buffer.WriteLine(OutputCellIterator{ L"http://a.b" }, { 4, 3 });
+
+    const auto verifyPatterns = [&]() {
+        const auto tree = buffer.GetPatterns(0, 3);
+        const auto results = tree.findOverlapping(til::point{ 0, 0 }, til::point{ 19, 3 });
+        VERIFY_ARE_EQUAL(2u, results.size());
+
+        for (const auto& result : results)
+        {
+            VERIFY_ARE_EQUAL(id, result.value);
+        }
+
+        const auto wrapped = std::find_if(results.begin(), results.end(), [](const auto& interval) { return interval.start.y() == 0; });
+        VERIFY_ARE_NOT_EQUAL(results.end(), wrapped);
+        VERIFY_ARE_EQUAL((til::point{ 6, 0 }), wrapped->start);
+        VERIFY_ARE_EQUAL((til::point{ 6, 1 }), wrapped->stop);
+
+        const auto single = std::find_if(results.begin(), results.end(), [](const auto& interval) { return interval.start.y() == 3; });
+        VERIFY_ARE_NOT_EQUAL(results.end(), single);
+        VERIFY_ARE_EQUAL((til::point{ 4, 3 }), single->start);
+        VERIFY_ARE_EQUAL((til::point{ 14, 3 }), single->stop);
+    };
+
+    verifyPatterns();
+
+    Log::Comment(L"Asking again gives the same results from the cached lines.");
+    VERIFY_ARE_EQUAL(3u, buffer._patternCache.size());
+    verifyPatterns();
+
+    Log::Comment(L"Changing a line is picked up.");
+    buffer.WriteLine(OutputCellIterator{ L"ftp://a.b " }, { 4, 3 });
+    const auto results = buffer.GetPatterns(0, 3).findOverlapping(til::point{ 0, 0 }, til::point{ 19, 3 });
+    VERIFY_ARE_EQUAL(1u, results.size());
+}
+
 // This tests that when buffer storage rows are rotated around during a resize traditional operation,
 // that the Unicode Storage-held high unicode items like emoji rotate properly with it.
 void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
@@ -1910,6 +2029,272 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// This tests that scrolling a region of rows, even one that wraps around the end of the circular buffer,
+// rearranges the rows within the region and leaves every other row where it is.
+void TextBufferTests::ScrollRowsOnlyMovesRowsInRegion()
+{
+    // Set up a text buffer for us
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Circle the buffer, so that the region we scroll wraps around the end of it.
+    for (auto i = 0; i < 7; ++i)
+    {
+        VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    }
+    VERIFY_ARE_EQUAL(static_cast<SHORT>(7), _buffer->GetFirstRowIndex());
+
+    // Label each row with a letter, and remember where each of them lives.
+    std::vector<ROW*> rows;
+    for (SHORT y = 0; y < bufferSize.Y; ++y)
+    {
+        _buffer->Write({ std::wstring_view{ L"ABCDEFGHIJ" }.substr(y, 1) }, { 0, y });
+        rows.push_back(&_buffer->GetRowByOffset(y));
+    }
+
+    const auto verifyRows = [&](const std::wstring_view expected) {
+        for (SHORT y = 0; y < bufferSize.Y; ++y)
+        {
+            const auto text = *_buffer->GetTextDataAt({ 0, y });
+            VERIFY_ARE_EQUAL(String(expected.substr(y, 1).data(), 1), String(text.data(), gsl::narrow<int>(text.size())));
+        }
+    };
+
+    Log::Comment(L"Scroll rows 3 through 7 up by 2.");
+    _buffer->ScrollRows(3, 5, -2);
+    verifyRows(L"ADEFGHBCIJ");
+
+    // The rows outside of the region are untouched, and the ones within
+    // it have been rearranged without being moved around themselves.
+    VERIFY_ARE_EQUAL(rows.at(0), &_buffer->GetRowByOffset(0));
+    VERIFY_ARE_EQUAL(rows.at(3), &_buffer->GetRowByOffset(1));
+    VERIFY_ARE_EQUAL(rows.at(1), &_buffer->GetRowByOffset(6));
+    VERIFY_ARE_EQUAL(rows.at(8), &_buffer->GetRowByOffset(8));
+    VERIFY_ARE_EQUAL(rows.at(9), &_buffer->GetRowByOffset(9));
+
+    // The rows still know which one comes before them.
+    VERIFY_ARE_EQUAL(&_buffer->GetRowByOffset(5), &_buffer->_GetPrevRowNoWrap(_buffer->GetRowByOffset(6)));
+    VERIFY_ARE_EQUAL(&_buffer->GetRowByOffset(2), &_buffer->_GetPrevRowNoWrap(_buffer->GetRowByOffset(3)));
+
+    Log::Comment(L"Scroll rows 1 through 5 back down by 2.");
+    _buffer->ScrollRows(1, 5, 2);
+    verifyRows(L"ABCDEFGHIJ");
+
+    for (SHORT y = 0; y < bufferSize.Y; ++y)
+    {
+        VERIFY_ARE_EQUAL(rows.at(y), &_buffer->GetRowByOffset(y));
+    }
+
+    Log::Comment(L"Resizing puts the rows back in order within storage, and keeps their contents.");
+    VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(bufferSize));
+    verifyRows(L"ABCDEFGHIJ");
+}
+
+void TextBufferTests::WriteLineCollectsUnusedGlyphs()
+{
+    // Set up a text buffer for us
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Like an app in the alt buffer, keep overwriting the same cell with new
+    // glyphs from the supplementary planes, without ever circling the buffer.
+    std::wstring glyph;
+    for (char32_t codepoint = 0x20000; codepoint < 0x20000 + 4096; ++codepoint)
+    {
+        glyph = { gsl::narrow_cast<wchar_t>(0xD800 + ((codepoint - 0x10000) >> 10)),
+                  gsl::narrow_cast<wchar_t>(0xDC00 + ((codepoint - 0x10000) & 0x3FF)) };
+        _buffer->Write({ std::wstring_view{ glyph } }, { 0, 0 });
+    }
+
+    // Only the glyph written last is still in use. The ones before it have
+    // been released along the way, instead of filling up the storage.
+    VERIFY_IS_LESS_THAN_OR_EQUAL(_buffer->GetUnicodeStorage().size(), static_cast<size_t>(1024));
+
+    const auto text = *_buffer->GetTextDataAt({ 0, 0 });
+    VERIFY_ARE_EQUAL(String(glyph.data(), gsl::narrow<int>(glyph.size())), String(text.data(), gsl::narrow<int>(text.size())));
+}
+
+void TextBufferTests::CharRowCopyCells()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:copyRight", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    bool copyRight;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"copyRight", copyRight), L"Get copyRight variant");
+
+    // Set up a text buffer for us
+    const COORD bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // The wide character takes up columns 6 and 7.
+    _buffer->Write(OutputCellIterator{ L"ABCDEF\x3042" L"GH" }, { 0, 0 });
+    _buffer->Write(OutputCellIterator{ L"0123456789" }, { 0, 1 });
+
+    const auto& row = _buffer->GetRowByOffset(0);
+    auto& charRow = _buffer->GetRowByOffset(0).GetCharRow();
+    const auto& otherRow = std::as_const(*_buffer).GetRowByOffset(1).GetCharRow();
+
+    Log::Comment(L"Copy eight cells two columns over, within the row. The spans overlap.");
+    size_t leadingColumn;
+    if (copyRight)
+    {
+        charRow.CopyCells(charRow, 0, 2, 8);
+        VERIFY_ARE_EQUAL(L"ABABCDEF\x3042", row.GetText());
+        leadingColumn = 8;
+    }
+    else
+    {
+        charRow.CopyCells(charRow, 2, 0, 8);
+        VERIFY_ARE_EQUAL(L"CDEF\x3042" L"GHGH", row.GetText());
+        leadingColumn = 4;
+    }
+
+    Log::Comment(L"The wide character moved as a whole.");
+    VERIFY_IS_TRUE(charRow.DbcsAttrAt(leadingColumn).IsLeading());
+    VERIFY_IS_TRUE(charRow.DbcsAttrAt(leadingColumn + 1).IsTrailing());
+
+    Log::Comment(L"Copy three cells from another row.");
+    charRow.CopyCells(otherRow, 5, 1, 3);
+    VERIFY_ARE_EQUAL(copyRight ? L"A567CDEF\x3042" : L"C567\x3042" L"GHGH", row.GetText());
+    VERIFY_ARE_EQUAL(L"0123456789", _buffer->GetRowByOffset(1).GetText());
+}
+
+void TextBufferTests::RowCopyCells()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:copyRight", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    bool copyRight;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"copyRight", copyRight), L"Get copyRight variant");
+
+    // Set up a text buffer for us
+    const COORD bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const TextAttribute attrA{ FOREGROUND_RED };
+    const TextAttribute attrB{ FOREGROUND_GREEN };
+    const TextAttribute attrC{ FOREGROUND_BLUE };
+    _buffer->Write(OutputCellIterator{ L"ABCDE", attrA }, { 0, 0 });
+    _buffer->Write(OutputCellIterator{ L"FGHIJ", attrB }, { 5, 0 });
+    _buffer->Write(OutputCellIterator{ L"0123456789", attrC }, { 0, 1 });
+
+    auto& row = _buffer->GetRowByOffset(0);
+    const auto& otherRow = std::as_const(*_buffer).GetRowByOffset(1);
+
+    // Each letter of the expected string names the attribute of a column.
+    const auto verifyAttrs = [&](const std::wstring_view expected) {
+        for (size_t column = 0; column < expected.size(); ++column)
+        {
+            const auto name = til::at(expected, column);
+            const auto& expectedAttr = name == L'A' ? attrA : name == L'B' ? attrB : attrC;
+            VERIFY_ARE_EQUAL(expectedAttr, row.GetAttrRow().GetAttrByColumn(column));
+        }
+    };
+
+    Log::Comment(L"Copy six cells two columns over, within the row. The spans overlap.");
+    if (copyRight)
+    {
+        row.CopyCells(row, 0, 2, 6);
+        VERIFY_ARE_EQUAL(L"ABABCDEFIJ", row.GetText());
+        verifyAttrs(L"AAAAAAABBB");
+    }
+    else
+    {
+        row.CopyCells(row, 2, 0, 6);
+        VERIFY_ARE_EQUAL(L"CDEFGHGHIJ", row.GetText());
+        verifyAttrs(L"AAABBBBBBB");
+    }
+
+    Log::Comment(L"Copy three cells from another row, along with their attributes.");
+    row.CopyCells(otherRow, 5, 1, 3);
+    if (copyRight)
+    {
+        VERIFY_ARE_EQUAL(L"A567CDEFIJ", row.GetText());
+        verifyAttrs(L"ACCCAAABBB");
+    }
+    else
+    {
+        VERIFY_ARE_EQUAL(L"C567GHGHIJ", row.GetText());
+        verifyAttrs(L"ACCCBBBBBB");
+    }
+    VERIFY_ARE_EQUAL(L"0123456789", otherRow.GetText());
+}
+
+void TextBufferTests::RowCopyCellsPadsDoubleWidthEdges()
+{
+    // Set up a text buffer for us
+    const COORD bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // The wide character takes up columns 2 and 3.
+    _buffer->Write(OutputCellIterator{ L"ABCDEFGHIJ" }, { 0, 0 });
+    _buffer->Write(OutputCellIterator{ L"01\x3042" L"456789" }, { 0, 1 });
+
+    auto& row = _buffer->GetRowByOffset(0);
+    const auto& otherRow = std::as_const(*_buffer).GetRowByOffset(1);
+
+    Log::Comment(L"Copying the trailing half of the wide character into column 0 leaves a space there.");
+    row.CopyCells(otherRow, 3, 0, 2);
+    VERIFY_ARE_EQUAL(L" 4CDEFGHIJ", row.GetText());
+    VERIFY_IS_FALSE(row.GetCharRow().DbcsAttrAt(0).IsTrailing());
+    VERIFY_IS_FALSE(row.WasDoubleBytePadded());
+
+    Log::Comment(L"Copying the leading half into the last column leaves a space there, and marks the row as padded.");
+    row.CopyCells(otherRow, 2, 9, 1);
+    VERIFY_ARE_EQUAL(L" 4CDEFGHI ", row.GetText());
+    VERIFY_IS_FALSE(row.GetCharRow().DbcsAttrAt(9).IsLeading());
+    VERIFY_IS_TRUE(row.WasDoubleBytePadded());
+
+    VERIFY_ARE_EQUAL(L"01\x3042" L"456789", otherRow.GetText());
+}
+
+void TextBufferTests::TextBufferCopyCells()
+{
+    // Set up a text buffer for us
+    const COORD bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // The wide character takes up columns 2 and 3 of the second row.
+    _buffer->Write(OutputCellIterator{ L"ABCDEFGHIJ" }, { 0, 0 });
+    _buffer->Write(OutputCellIterator{ L"01\x3042" L"456789" }, { 0, 1 });
+
+    const auto& row = std::as_const(*_buffer).GetRowByOffset(0);
+
+    Log::Comment(L"Copy to the right within the row, then back to the left. The spans overlap both times.");
+    _buffer->CopyCells({ 0, 0 }, { 3, 0 }, 5);
+    VERIFY_ARE_EQUAL(L"ABCABCDEIJ", row.GetText());
+    _buffer->CopyCells({ 3, 0 }, { 1, 0 }, 5);
+    VERIFY_ARE_EQUAL(L"AABCDEDEIJ", row.GetText());
+
+    Log::Comment(L"Copy from another row.");
+    _buffer->CopyCells({ 4, 1 }, { 6, 0 }, 4);
+    VERIFY_ARE_EQUAL(L"AABCDE4567", row.GetText());
+
+    Log::Comment(L"Halves of the wide character copied to either edge of the row are padded out.");
+    _buffer->CopyCells({ 3, 1 }, { 0, 0 }, 1);
+    VERIFY_ARE_EQUAL(L" ABCDE4567", row.GetText());
+    VERIFY_IS_FALSE(row.WasDoubleBytePadded());
+    _buffer->CopyCells({ 2, 1 }, { 9, 0 }, 1);
+    VERIFY_ARE_EQUAL(L" ABCDE456 ", row.GetText());
+    VERIFY_IS_TRUE(row.WasDoubleBytePadded());
+
+    VERIFY_ARE_EQUAL(L"01\x3042" L"456789", _buffer->GetRowByOffset(1).GetText());
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
 // characters from the Unicode Storage buffer
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
@@ -1935,14 +2320,14 @@ void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage().size(), L"There should be one item in the storage.");
 
     // Perform resize to trim off the row of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X, bufferSize.Y - 1 };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    VERIFY_ARE_EQUAL(0u, _buffer->GetUnicodeStorage().size(), L"The storage should now be empty.");
 }
 
 // This tests that columns removed from the buffer while resizing traditionally will also drop the high unicode
@@ -1970,14 +2355,14 @@ void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage().size(), L"There should be one item in the storage.");
 
     // Perform resize to trim off the column of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X - 1, bufferSize.Y };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    VERIFY_ARE_EQUAL(0u, _buffer->GetUnicodeStorage().size(), L"The storage should now be empty.");
 }
 
 void TextBufferTests::TestBurrito()
@@ -2660,3 +3045,58 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// This tests that the rows keep count of how many of them refer to each hyperlink
+void TextBufferTests::HyperlinkRefCounts()
+{
+    const COORD bufferSize{ 80, 10 };
+    TextBuffer buffer(bufferSize, TextAttribute{ 0x7f }, 12, _renderTarget);
+
+    const auto url = L"test.url";
+    const auto id = buffer.GetHyperlinkId(url, {});
+    buffer.AddHyperlinkToMap(url, id);
+    TextAttribute linkAttr{ 0x7f };
+    linkAttr.SetHyperlinkId(id);
+
+    Log::Comment(L"A hyperlink that isn't written anywhere has no references.");
+    VERIFY_ARE_EQUAL(0u, buffer._hyperlinkRefCounts.count(id));
+
+    Log::Comment(L"Each row counts once, no matter how many runs refer to the hyperlink.");
+    auto& attrRow = buffer.GetRowByOffset(1).GetAttrRow();
+    attrRow.SetAttrToEnd(10, linkAttr);
+    attrRow.SetAttrToEnd(20, TextAttribute{ 0x7f });
+    attrRow.SetAttrToEnd(30, linkAttr);
+    buffer.GetRowByOffset(5).GetAttrRow().SetAttrToEnd(70, linkAttr);
+    VERIFY_ARE_EQUAL(2u, buffer._hyperlinkRefCounts.at(id));
+
+    Log::Comment(L"Overwriting the hyperlink drops the row's reference.");
+    buffer.GetRowByOffset(5).GetAttrRow().SetAttrToEnd(0, TextAttribute{ 0x7f });
+    VERIFY_ARE_EQUAL(1u, buffer._hyperlinkRefCounts.at(id));
+
+    Log::Comment(L"Copying the hyperlink into a row without one adds a reference, replacing it drops it again.");
+    auto& otherRow = buffer.GetRowByOffset(3).GetAttrRow();
+    otherRow.CopyAttrs(attrRow, 5, 0, 10);
+    VERIFY_ARE_EQUAL(2u, buffer._hyperlinkRefCounts.at(id));
+    otherRow.ReplaceAttrs(linkAttr, TextAttribute{ 0x7f });
+    VERIFY_ARE_EQUAL(1u, buffer._hyperlinkRefCounts.at(id));
+
+    Log::Comment(L"Moving rows around during a resize keeps the counts intact.");
+    buffer.GetRowByOffset(8).GetAttrRow().SetAttrToEnd(0, linkAttr);
+    buffer.GetCursor().SetPosition({ 0, 9 });
+    buffer.IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(2u, buffer._hyperlinkRefCounts.at(id));
+    VERIFY_SUCCEEDED(buffer.ResizeTraditional({ 40, 10 }));
+    VERIFY_ARE_EQUAL(2u, buffer._hyperlinkRefCounts.at(id));
+
+    Log::Comment(L"Rows that are cut off release their hyperlinks.");
+    VERIFY_SUCCEEDED(buffer.ResizeTraditional({ 40, 5 }));
+    VERIFY_ARE_EQUAL(1u, buffer._hyperlinkRefCounts.at(id));
+
+    Log::Comment(L"Once the last reference scrolls out of the buffer, the hyperlink is removed.");
+    for (auto i = 0; i < 5; ++i)
+    {
+        buffer.IncrementCircularBuffer();
+    }
+    VERIFY_ARE_EQUAL(0u, buffer._hyperlinkRefCounts.count(id));
+    VERIFY_ARE_EQUAL(buffer._hyperlinkMap.end(), buffer._hyperlinkMap.find(id));
+}
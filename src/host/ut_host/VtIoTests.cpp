@@ -392,6 +392,11 @@ public:
     {
     }
 
+    SearchIndex& GetSearchIndex() noexcept
+    {
+        return _searchIndex;
+    }
+
     const std::wstring GetHyperlinkUri(uint16_t /*id*/) const noexcept
     {
         return {};
@@ -406,6 +411,9 @@ public:
     {
         return {};
     }
+
+private:
+    SearchIndex _searchIndex;
 };
 
 void VtIoTests::RendererDtorAndThread()
@@ -416,8 +416,8 @@ void VtRendererTest::Xterm256TestColors()
     Log::Comment(NoThrowString().Format(
         L"Begin by setting some test values - FG,BG = (1,2,3), (4,5,6) to start"
         L"These values were picked for ease of formatting raw COLORREF values."));
-    qExpectedInput.push_back("\x1b[38;2;1;2;3m");
-    qExpectedInput.push_back("\x1b[48;2;5;6;7m");
+    Log::Comment(L"Both colors change, so they're emitted in a single sequence.");
+    qExpectedInput.push_back("\x1b[38;2;1;2;3;48;2;5;6;7m");
     VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes({ 0x00030201, 0x00070605 },
                                                   &renderData,
                                                   false));
@@ -1556,13 +1556,6 @@ void VtRendererTest::TestCursorVisibility()
 
 void VtRendererTest::FormattedString()
 {
-    // This test works with a static cache variable that
-    // can be affected by other tests
-    BEGIN_TEST_METHOD_PROPERTIES()
-        TEST_METHOD_PROPERTY(L"IsolationLevel", L"Method")
-    END_TEST_METHOD_PROPERTIES();
-
-    static const std::string format("\x1b[%dm");
     const auto value = 12;
 
     Viewport view = SetUpViewport();
@@ -1571,17 +1564,21 @@ void VtRendererTest::FormattedString()
     auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
     engine->SetTestCallback(pfn);
 
-    Log::Comment(L"1.) Write it once. It should resize itself.");
+    Log::Comment(L"1.) Write it once.");
     qExpectedInput.push_back("\x1b[12m");
-    VERIFY_SUCCEEDED(engine->_WriteFormattedString(&format, value));
+    VERIFY_SUCCEEDED(engine->_WriteFormatted(FMT_COMPILE("\x1b[{}m"), value));
 
     Log::Comment(L"2.) Write the same thing again, should be fine.");
     qExpectedInput.push_back("\x1b[12m");
-    VERIFY_SUCCEEDED(engine->_WriteFormattedString(&format, value));
+    VERIFY_SUCCEEDED(engine->_WriteFormatted(FMT_COMPILE("\x1b[{}m"), value));
 
-    Log::Comment(L"3.) Now write something huge. Should resize itself and still be fine.");
-    static const std::string bigFormat("\x1b[28;3;%d;%d;%dm");
+    Log::Comment(L"3.) Now write something with multiple parameters.");
     const auto bigValue = 500;
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
-    VERIFY_SUCCEEDED(engine->_WriteFormattedString(&bigFormat, bigValue, bigValue, bigValue));
+    VERIFY_SUCCEEDED(engine->_WriteFormatted(FMT_COMPILE("\x1b[28;3;{};{};{}m"), bigValue, bigValue, bigValue));
+
+    Log::Comment(L"4.) Now write something that doesn't fit on the stack. Should still be fine.");
+    const std::string bigString(100, 'A');
+    qExpectedInput.push_back("\x1b]0;" + bigString + "\x07");
+    VERIFY_SUCCEEDED(engine->_WriteFormatted(FMT_COMPILE("\x1b]0;{}\x07"), bigString));
 }
@@ -18,6 +18,7 @@
 #include "til/spsc.h"
 #include "til/coalesce.h"
 #include "til/replace.h"
+#include "til/ring.h"
 #include "til/visualize_control_codes.h"
 #include "til/pmr.h"
 
@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+namespace til // Terminal Implementation Library. Also: "Today I Learned"
+{
+    // A double-ended queue of values stored in a single contiguous, growable buffer.
+    // Unlike std::deque it doesn't allocate as values are pushed and popped at the
+    // ends, which makes it suitable for queues of small values with a high turnover.
+    // Values are only overwritten, never destroyed, once they're removed.
+    // A buffer that grew large is given back once the ring runs empty.
+    template<typename T>
+    class ring
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "til::ring only supports trivially copyable types");
+
+        template<typename Ring, typename Value>
+        class ring_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+
+            ring_iterator(Ring* ring, size_t index) noexcept :
+                _ring{ ring },
+                _index{ index }
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return (*_ring)[_index];
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &(*_ring)[_index];
+            }
+
+            ring_iterator& operator++() noexcept
+            {
+                ++_index;
+                return *this;
+            }
+
+            ring_iterator operator++(int) noexcept
+            {
+                auto copy = *this;
+                ++_index;
+                return copy;
+            }
+
+            bool operator==(const ring_iterator& other) const noexcept
+            {
+                return _ring == other._ring && _index == other._index;
+            }
+
+            bool operator!=(const ring_iterator& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+            Ring* _ring;
+            size_t _index;
+        };
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = ring_iterator<ring, T>;
+        using const_iterator = ring_iterator<const ring, const T>;
+
+        ring() = default;
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return _buffer.size();
+        }
+
+        reference operator[](const size_type index) noexcept
+        {
+            return til::at(_buffer, _physical(index));
+        }
+
+        const_reference operator[](const size_type index) const noexcept
+        {
+            return til::at(_buffer, _physical(index));
+        }
+
+        reference at(const size_type index)
+        {
+            _checkIndex(index);
+            return (*this)[index];
+        }
+
+        const_reference at(const size_type index) const
+        {
+            _checkIndex(index);
+            return (*this)[index];
+        }
+
+        reference front() noexcept
+        {
+            return (*this)[0];
+        }
+
+        const_reference front() const noexcept
+        {
+            return (*this)[0];
+        }
+
+        reference back() noexcept
+        {
+            return (*this)[_size - 1];
+        }
+
+        const_reference back() const noexcept
+        {
+            return (*this)[_size - 1];
+        }
+
+        iterator begin() noexcept
+        {
+            return { this, 0 };
+        }
+
+        iterator end() noexcept
+        {
+            return { this, _size };
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return { this, 0 };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return { this, _size };
+        }
+
+        void push_back(const T& value)
+        {
+            _reserveOneMore();
+            til::at(_buffer, _physical(_size)) = value;
+            ++_size;
+        }
+
+        void push_front(const T& value)
+        {
+            _reserveOneMore();
+            _head = (_head == 0 ? _buffer.size() : _head) - 1;
+            til::at(_buffer, _head) = value;
+            ++_size;
+        }
+
+        void pop_front() noexcept
+        {
+            _head = _physical(1);
+            --_size;
+            _shrinkIfEmpty();
+        }
+
+        void pop_back() noexcept
+        {
+            --_size;
+            _shrinkIfEmpty();
+        }
+
+        void clear() noexcept
+        {
+            _head = 0;
+            _size = 0;
+            _shrinkIfEmpty();
+        }
+
+        void swap(ring& other) noexcept
+        {
+            _buffer.swap(other._buffer);
+            std::swap(_head, other._head);
+            std::swap(_size, other._size);
+        }
+
+        // Removes all values for which the predicate returns true, keeping the order of the others.
+        template<typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            size_type kept = 0;
+            for (size_type i = 0; i < _size; ++i)
+            {
+                const auto& value = (*this)[i];
+                if (!pred(value))
+                {
+                    (*this)[kept++] = value;
+                }
+            }
+
+            const auto erased = _size - kept;
+            _size = kept;
+            _shrinkIfEmpty();
+            return erased;
+        }
+
+    private:
+        static constexpr size_type _minimumCapacity = 16;
+        // Buffers up to this size are kept around while the ring is empty, since
+        // a queue that keeps running empty would otherwise allocate all the time.
+        static constexpr size_type _retainedCapacity = 1024;
+
+        std::vector<T> _buffer;
+        size_type _head = 0;
+        size_type _size = 0;
+
+#ifdef UNIT_TESTING
+        friend class RingTests;
+#endif
+
+        size_type _physical(const size_type index) const noexcept
+        {
+            const auto capacity = _buffer.size();
+            const auto physical = _head + index;
+            return physical >= capacity ? physical - capacity : physical;
+        }
+
+        void _checkIndex(const size_type index) const
+        {
+            if (index >= _size)
+            {
+                throw std::out_of_range("til::ring index out of range");
+            }
+        }
+
+        // Grows the buffer if it's full, moving the values to its start in the process.
+        void _reserveOneMore()
+        {
+            if (_size < _buffer.size())
+            {
+                return;
+            }
+
+            std::vector<T> buffer(std::max(_minimumCapacity, _buffer.size() * 2));
+            for (size_type i = 0; i < _size; ++i)
+            {
+                til::at(buffer, i) = (*this)[i];
+            }
+
+            _buffer.swap(buffer);
+            _head = 0;
+        }
+
+        // Gives the buffer back once the ring is empty, if it grew past what's worth keeping.
+        void _shrinkIfEmpty() noexcept
+        {
+            if (_size == 0 && _buffer.size() > _retainedCapacity)
+            {
+                std::vector<T>{}.swap(_buffer);
+                _head = 0;
+            }
+        }
+    };
+}
@@ -14,6 +14,10 @@ could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
 Based on the results the decision was made to keep using the platform
 functions MultiByteToWideChar and WideCharToMultiByte.
+Since then, the conversions got an ASCII fast path which widens/narrows 16
+code units at a time using SSE2, and code points outside of ASCII are
+transcoded by hand. Invalid UTF-8 is still handed to MultiByteToWideChar,
+so that the replacement characters are the same as the platform's.
 
 Author(s):
 - Steffen Illhardt (german-one) 2020
@@ -21,8 +25,218 @@ Author(s):
 
 #pragma once
 
+#if defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. We're scanning raw memory on purpose.
+#pragma warning(disable : 26490) // Don't use reinterpret_cast. Required to load the strings into SSE registers.
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator.
+
+        // Routine Description:
+        // - Copies the leading ASCII characters of a UTF-8 string into a UTF-16 string.
+        // Arguments:
+        // - in - the UTF-8 code units
+        // - count - the number of code units in `in`
+        // - out - receives the UTF-16 code units. Must have room for `count` of them.
+        // Return Value:
+        // - the number of code units copied, which is where the first non-ASCII character is
+        inline size_t widen_ascii(const char* const in, const size_t count, wchar_t* const out) noexcept
+        {
+            size_t pos{};
+#if defined(_M_X64) || defined(_M_IX86)
+            const auto zero = _mm_setzero_si128();
+            for (; pos + 16 <= count; pos += 16)
+            {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+                // ASCII is exactly the bytes that don't have their high bit set.
+                if (_mm_movemask_epi8(chunk) != 0)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_unpacklo_epi8(chunk, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 8), _mm_unpackhi_epi8(chunk, zero));
+            }
+#endif
+            for (; pos < count && static_cast<unsigned char>(in[pos]) < 0x80; ++pos)
+            {
+                out[pos] = static_cast<wchar_t>(in[pos]);
+            }
+            return pos;
+        }
+
+        // Routine Description:
+        // - Copies the leading ASCII characters of a UTF-16 string into a UTF-8 string.
+        // Arguments:
+        // - in - the UTF-16 code units
+        // - count - the number of code units in `in`
+        // - out - receives the UTF-8 code units. Must have room for `count` of them.
+        // Return Value:
+        // - the number of code units copied, which is where the first non-ASCII character is
+        inline size_t narrow_ascii(const wchar_t* const in, const size_t count, char* const out) noexcept
+        {
+            size_t pos{};
+#if defined(_M_X64) || defined(_M_IX86)
+            const auto zero = _mm_setzero_si128();
+            const auto nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+            for (; pos + 16 <= count; pos += 16)
+            {
+                const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+                const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos + 8));
+                const auto nonAscii = _mm_and_si128(_mm_or_si128(lo, hi), nonAsciiBits);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xFFFF)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; pos < count && in[pos] < 0x80; ++pos)
+            {
+                out[pos] = static_cast<char>(in[pos]);
+            }
+            return pos;
+        }
+
+        // Routine Description:
+        // - Converts complete UTF-8 code points into UTF-16.
+        // Arguments:
+        // - in - the UTF-8 string. Its length must fit into an int.
+        // - out - receives the UTF-16 code units. Must have room for `in.length()` of them,
+        //   as no UTF-8 code unit ever turns into more than one UTF-16 code unit.
+        // Return Value:
+        // - the number of UTF-16 code units written, 0 if the conversion failed
+        inline size_t utf8_to_utf16(const std::string_view in, wchar_t* const out) noexcept
+        {
+            const auto data = reinterpret_cast<const unsigned char*>(in.data());
+            const auto count = in.length();
+            const auto isContinuation = [](const unsigned char byte) noexcept { return (byte & 0b11'000000) == 0b10'000000; };
+
+            size_t pos{};
+            size_t written{};
+            while (pos < count)
+            {
+                const auto ascii = widen_ascii(in.data() + pos, count - pos, out + written);
+                pos += ascii;
+                written += ascii;
+
+                for (; pos < count && data[pos] >= 0x80;)
+                {
+                    const auto lead = data[pos];
+                    const auto remaining = count - pos;
+                    if (lead >= 0xC2 && lead <= 0xDF && remaining >= 2 && isContinuation(data[pos + 1]))
+                    {
+                        out[written++] = static_cast<wchar_t>((lead & 0x1F) << 6 | (data[pos + 1] & 0x3F));
+                        pos += 2;
+                        continue;
+                    }
+                    if (lead >= 0xE0 && lead <= 0xEF && remaining >= 3)
+                    {
+                        // E0 must not encode what fits into 2 bytes, and ED must not encode surrogates.
+                        const unsigned char min = lead == 0xE0 ? 0xA0 : 0x80;
+                        const unsigned char max = lead == 0xED ? 0x9F : 0xBF;
+                        if (data[pos + 1] >= min && data[pos + 1] <= max && isContinuation(data[pos + 2]))
+                        {
+                            out[written++] = static_cast<wchar_t>((lead & 0x0F) << 12 | (data[pos + 1] & 0x3F) << 6 | (data[pos + 2] & 0x3F));
+                            pos += 3;
+                            continue;
+                        }
+                    }
+                    if (lead >= 0xF0 && lead <= 0xF4 && remaining >= 4)
+                    {
+                        // F0 must not encode what fits into 3 bytes, and F4 must not exceed U+10FFFF.
+                        const unsigned char min = lead == 0xF0 ? 0x90 : 0x80;
+                        const unsigned char max = lead == 0xF4 ? 0x8F : 0xBF;
+                        if (data[pos + 1] >= min && data[pos + 1] <= max && isContinuation(data[pos + 2]) && isContinuation(data[pos + 3]))
+                        {
+                            const auto codepoint = (lead & 0x07u) << 18 | (data[pos + 1] & 0x3Fu) << 12 | (data[pos + 2] & 0x3Fu) << 6 | (data[pos + 3] & 0x3Fu);
+                            out[written++] = static_cast<wchar_t>(0xD7C0u + (codepoint >> 10));
+                            out[written++] = static_cast<wchar_t>(0xDC00u | (codepoint & 0x3FFu));
+                            pos += 4;
+                            continue;
+                        }
+                    }
+
+                    // The sequence is invalid. Let the platform deal with it (and anything else)
+                    // up to the next ASCII character, which can't be part of any sequence.
+                    auto end = pos + 1;
+                    while (end < count && data[end] >= 0x80)
+                    {
+                        ++end;
+                    }
+                    const auto length = gsl::narrow_cast<int>(end - pos);
+                    const auto replaced = MultiByteToWideChar(CP_UTF8, 0ul, in.data() + pos, length, out + written, length);
+                    if (replaced == 0)
+                    {
+                        return 0;
+                    }
+                    pos = end;
+                    written += gsl::narrow_cast<size_t>(replaced);
+                }
+            }
+            return written;
+        }
+
+        // Routine Description:
+        // - Converts complete UTF-16 code points into UTF-8. Unpaired surrogates are
+        //   replaced with U+FFFD, just like WideCharToMultiByte does.
+        // Arguments:
+        // - in - the UTF-16 string
+        // - out - receives the UTF-8 code units. Must have room for 3 times `in.length()` of them.
+        // Return Value:
+        // - the number of UTF-8 code units written
+        inline size_t utf16_to_utf8(const std::wstring_view in, char* const out) noexcept
+        {
+            const auto data = in.data();
+            const auto count = in.length();
+
+            size_t pos{};
+            size_t written{};
+            while (pos < count)
+            {
+                const auto ascii = narrow_ascii(data + pos, count - pos, out + written);
+                pos += ascii;
+                written += ascii;
+
+                for (; pos < count && data[pos] >= 0x80; ++pos)
+                {
+                    unsigned int codepoint = data[pos];
+                    if (codepoint < 0x800)
+                    {
+                        out[written++] = static_cast<char>(0xC0 | codepoint >> 6);
+                        out[written++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+                        continue;
+                    }
+                    if (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+                    {
+                        if (codepoint <= 0xDBFF && pos + 1 < count && data[pos + 1] >= 0xDC00 && data[pos + 1] <= 0xDFFF)
+                        {
+                            codepoint = 0x10000 + ((codepoint - 0xD800) << 10 | (data[pos + 1] - 0xDC00u));
+                            ++pos;
+                            out[written++] = static_cast<char>(0xF0 | codepoint >> 18);
+                            out[written++] = static_cast<char>(0x80 | (codepoint >> 12 & 0x3F));
+                            out[written++] = static_cast<char>(0x80 | (codepoint >> 6 & 0x3F));
+                            out[written++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+                            continue;
+                        }
+                        codepoint = 0xFFFD;
+                    }
+                    out[written++] = static_cast<char>(0xE0 | codepoint >> 12);
+                    out[written++] = static_cast<char>(0x80 | (codepoint >> 6 & 0x3F));
+                    out[written++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+                }
+            }
+            return written;
+        }
+
+#pragma warning(pop)
+    }
+
     template<class charT>
     class u8u16state final
     {
@@ -38,7 +252,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         //   If it receives an incomplete codepoint, it will cache it until it can be completed.
         // Arguments:
         // - in - UTF-8 string_view potentially containing partial code points
-        // - out - on return, populated with complete codepoints at the string end
+        // - out - on return, populated with complete codepoints at the string end.
+        //   Unless partials had to be prepended, it refers to the memory of `in`.
         // Return Value:
         // - S_OK          - the resulting string doesn't end with a partial
         // - S_FALSE       - the resulting string contains the previously cached partials only
@@ -54,20 +269,23 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 size_t capacity{};
                 RETURN_HR_IF(E_ABORT, !base::CheckAdd(in.length(), _partialsLen).AssignIfValid(&capacity));
 
-                _buffer.clear();
-                _buffer.reserve(capacity);
-
-                // copy UTF-8 code units that were remaining from the previous call (if any)
+                // Only if UTF-8 code units were remaining from the previous call, the
+                // string has to be copied, to prepend them. Otherwise we work on `in`.
+                std::basic_string_view<T> text{ in };
                 if (_partialsLen != 0u)
                 {
+                    _buffer.clear();
+                    _buffer.reserve(capacity);
                     _buffer.assign(_utfPartials.cbegin(), _utfPartials.cbegin() + _partialsLen);
+                    _buffer.append(in);
                     _partialsLen = 0u;
+                    text = _buffer;
                 }
 
                 if (in.empty())
                 {
-                    out = _buffer;
-                    if (_buffer.empty())
+                    out = text;
+                    if (text.empty())
                     {
                         return S_OK;
                     }
@@ -75,15 +293,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     return S_FALSE; // the partial is populated
                 }
 
-                _buffer.append(in);
-                size_t remainingLength{ _buffer.length() };
+                size_t remainingLength{ text.length() };
 
-                auto backIter = _buffer.end();
+                auto backIter = text.end();
                 // If the last byte in the string was a byte belonging to a UTF-8 multi-byte character
                 if ((*(backIter - 1) & _Utf8BitMasks::MaskAsciiByte) > _Utf8BitMasks::IsAsciiByte)
                 {
                     // Check only up to 3 last bytes, if no Lead Byte was found then the byte before must be the Lead Byte and no partials are in the string
-                    const size_t stopLen{ std::min(_buffer.length(), gsl::narrow_cast<size_t>(3u)) };
+                    const size_t stopLen{ std::min(text.length(), gsl::narrow_cast<size_t>(3u)) };
                     for (size_t sequenceLen{ 1u }; sequenceLen <= stopLen; ++sequenceLen)
                     {
                         --backIter;
@@ -96,7 +313,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                             //  sequence is a complete UTF-8 code point and the whole string is ready for the conversion into a UTF-16 string.
                             if ((*backIter & _cmpMasks.at(sequenceLen)) != _cmpOperands.at(sequenceLen))
                             {
-                                std::move(backIter, _buffer.end(), _utfPartials.begin());
+                                std::copy(backIter, text.end(), _utfPartials.begin());
                                 remainingLength -= sequenceLen;
                                 _partialsLen = sequenceLen;
                             }
@@ -107,7 +324,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
 
                 // populate the part of the string that contains complete code points only
-                out = { _buffer.data(), remainingLength };
+                out = text.substr(0u, remainingLength);
 
                 return S_OK;
             }
@@ -130,7 +347,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         //   If it receives an incomplete codepoint, it will cache it until it can be completed.
         // Arguments:
         // - in - UTF-16 string_view potentially containing partial code points
-        // - out - on return, populated with complete codepoints at the string end
+        // - out - on return, populated with complete codepoints at the string end.
+        //   Unless a high surrogate had to be prepended, it refers to the memory of `in`.
         // Return Value:
         // - S_OK          - the resulting string doesn't end with a partial
         // - S_FALSE       - the resulting string contains the previously cached partials only
@@ -148,20 +366,21 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
                 RETURN_HR_IF(E_ABORT, !base::CheckAdd(remainingLength, _partialsLen).AssignIfValid(&capacity));
 
-                _buffer.clear();
-                _buffer.reserve(capacity);
-
-                // copy UTF-8 code units that were remaining from the previous call (if any)
-                if (_partialsLen != 0u)
+                // Only if a high surrogate was remaining from the previous call, the
+                // string has to be copied, to prepend it. Otherwise we work on `in`.
+                const bool prependPartial{ _partialsLen != 0u };
+                if (prependPartial)
                 {
+                    _buffer.clear();
+                    _buffer.reserve(capacity);
                     _buffer.push_back(_utfPartials.front());
                     _partialsLen = 0u;
                 }
 
                 if (in.empty())
                 {
-                    out = _buffer;
-                    if (_buffer.empty())
+                    out = prependPartial ? std::basic_string_view<T>{ _buffer } : in;
+                    if (out.empty())
                     {
                         return S_OK;
                     }
@@ -182,8 +401,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
 
                 // populate the part of the string that contains complete code points only
-                _buffer.append(in, 0u, remainingLength);
-                out = _buffer;
+                if (prependPartial)
+                {
+                    _buffer.append(in, 0u, remainingLength);
+                    out = _buffer;
+                }
+                else
+                {
+                    out = in.substr(0u, remainingLength);
+                }
 
                 return S_OK;
             }
@@ -268,19 +494,19 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     {
         try
         {
-            out.clear();
-
             if (in.empty())
             {
+                out.clear();
                 return S_OK;
             }
 
             int lengthRequired{};
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
-            out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            // Resizing without clearing first only initializes what grows beyond the previous length.
+            out.resize(in.length());
+            const size_t lengthOut = details::utf8_to_utf16(std::string_view{ in.data(), in.length() }, out.data());
+            out.resize(lengthOut);
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
         }
@@ -334,10 +560,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     {
         try
         {
-            out.clear();
-
             if (in.empty())
             {
+                out.clear();
                 return S_OK;
             }
 
@@ -347,11 +572,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Code Points >U+FFFF: 2 UTF-16 code units --> 4 UTF-8 code units.
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
-            out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            // Resizing without clearing first only initializes what grows beyond the previous length.
+            out.resize(gsl::narrow_cast<size_t>(lengthRequired));
+            const size_t lengthOut = details::utf16_to_utf8(std::wstring_view{ in.data(), in.length() }, out.data());
+            out.resize(lengthOut);
 
-            return lengthOut == 0 ? E_UNEXPECTED : S_OK;
+            return S_OK;
         }
         catch (std::length_error&)
         {
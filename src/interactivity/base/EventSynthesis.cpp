@@ -15,11 +15,17 @@
 // runtime without breaking compatibility?
 static constexpr WORD altScanCode = 0x38;
 static constexpr WORD leftShiftScanCode = 0x2A;
+static constexpr short invalidKey = -1;
 
-std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToKeyEvents(const wchar_t wch,
-                                                                                         const unsigned int codepage)
+// Routine Description:
+// - gets the key and modifiers that type the given wchar_t in the current keyboard layout
+// Arguments:
+// - wch - the wchar_t to look up
+// Return Value:
+// - the key state as returned by VkKeyScanW, or invalidKey if the wchar_t
+//   has to be entered through the numpad instead
+static short _CharToKeyState(const wchar_t wch)
 {
-    const short invalidKey = -1;
     short keyState = VkKeyScanW(wch);
 
     if (keyState == invalidKey)
@@ -36,6 +42,41 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToK
         }
     }
 
+    return keyState;
+}
+
+// Routine Description:
+// - gets the control key state of the key event that types a wchar_t, given the key state
+//   returned by VkKeyScanW for it
+// Arguments:
+// - keyState - the key and modifiers that type the wchar_t
+// Return Value:
+// - the control key state, with the modifiers held down while typing the wchar_t
+static DWORD _KeyStateToControlKeyState(const short keyState) noexcept
+{
+    const byte modifierState = HIBYTE(keyState);
+
+    DWORD controlKeyState = 0;
+    if (WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed))
+    {
+        WI_SetFlag(controlKeyState, SHIFT_PRESSED);
+    }
+    if (WI_IsFlagSet(modifierState, VkKeyScanModState::CtrlPressed))
+    {
+        WI_SetFlag(controlKeyState, LEFT_CTRL_PRESSED);
+    }
+    if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed))
+    {
+        WI_SetFlag(controlKeyState, RIGHT_ALT_PRESSED);
+    }
+    return controlKeyState;
+}
+
+std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToKeyEvents(const wchar_t wch,
+                                                                                         const unsigned int codepage)
+{
+    const short keyState = _CharToKeyState(wch);
+
     std::deque<std::unique_ptr<KeyEvent>> convertedEvents;
     if (keyState == invalidKey)
     {
@@ -51,6 +92,57 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToK
     return convertedEvents;
 }
 
+// Routine Description:
+// - counts the KeyEvents that CharToKeyEvents converts a wchar_t into, without creating them
+// Arguments:
+// - wch - the wchar_t to convert
+// - codepage - the codepage used to enter the wchar_t through the numpad, if necessary
+// Return Value:
+// - the number of KeyEvents
+// Note:
+// - will throw exception on error
+size_t Microsoft::Console::Interactivity::CountKeyEvents(const wchar_t wch, const unsigned int codepage)
+{
+    const short keyState = _CharToKeyState(wch);
+
+    if (keyState == invalidKey)
+    {
+        // alt down and up, with a key down and up for each digit typed on the numpad in between
+        size_t count = 2;
+        const auto convertedChars = ConvertToA(codepage, { &wch, 1 });
+        if (convertedChars.size() == 1)
+        {
+            const unsigned char uch = static_cast<unsigned char>(convertedChars.at(0));
+            count += 2 * std::to_string(uch).size();
+        }
+        return count;
+    }
+
+    // key down and up, surrounded by a down and up of shift or alt gr if necessary
+    const byte modifierState = HIBYTE(keyState);
+    if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed) ||
+        WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed))
+    {
+        return 4;
+    }
+    return 2;
+}
+
+// Routine Description:
+// - gets the control key state of the key event that carries the wchar_t
+//   among the KeyEvents that CharToKeyEvents converts it into
+// Arguments:
+// - wch - the wchar_t to convert
+// Return Value:
+// - the control key state. Characters entered through the numpad have none.
+// Note:
+// - will throw exception on error
+DWORD Microsoft::Console::Interactivity::CharToControlKeyState(const wchar_t wch)
+{
+    const short keyState = _CharToKeyState(wch);
+    return keyState == invalidKey ? 0 : _KeyStateToControlKeyState(keyState);
+}
+
 // Routine Description:
 // - converts a wchar_t into a series of KeyEvents as if it was typed
 // using the keyboard
@@ -92,21 +184,7 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::Synthes
 
     const auto vk = LOBYTE(keyState);
     const WORD virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(vk, MAPVK_VK_TO_VSC));
-    KeyEvent keyEvent{ true, 1, LOBYTE(keyState), virtualScanCode, wch, 0 };
-
-    // add modifier flags if necessary
-    if (WI_IsFlagSet(modifierState, VkKeyScanModState::ShiftPressed))
-    {
-        keyEvent.ActivateModifierKey(ModifierKeyState::Shift);
-    }
-    if (WI_IsFlagSet(modifierState, VkKeyScanModState::CtrlPressed))
-    {
-        keyEvent.ActivateModifierKey(ModifierKeyState::LeftCtrl);
-    }
-    if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed))
-    {
-        keyEvent.ActivateModifierKey(ModifierKeyState::RightAlt);
-    }
+    KeyEvent keyEvent{ true, 1, LOBYTE(keyState), virtualScanCode, wch, _KeyStateToControlKeyState(keyState) };
 
     // add key event down and up
     keyEvents.push_back(std::make_unique<KeyEvent>(keyEvent));
@@ -21,6 +21,8 @@ Author:
 namespace Microsoft::Console::Interactivity
 {
     std::deque<std::unique_ptr<KeyEvent>> CharToKeyEvents(const wchar_t wch, const unsigned int codepage);
+    size_t CountKeyEvents(const wchar_t wch, const unsigned int codepage);
+    DWORD CharToControlKeyState(const wchar_t wch);
 
     std::deque<std::unique_ptr<KeyEvent>> SynthesizeKeyboardEvents(const wchar_t wch,
                                                                    const short keyState);
@@ -934,12 +934,12 @@ BOOL HandleMouseEvent(const SCREEN_INFORMATION& ScreenInfo,
     ULONG EventsWritten = 0;
     try
     {
-        std::unique_ptr<MouseEvent> mouseEvent = std::make_unique<MouseEvent>(
-            MousePosition,
-            ConvertMouseButtonState(ButtonFlags, static_cast<UINT>(wParam)),
-            GetControlKeyState(0),
-            EventFlags);
-        EventsWritten = static_cast<ULONG>(gci.pInputBuffer->Write(std::move(mouseEvent)));
+        const MouseEvent mouseEvent{ MousePosition,
+                                     ConvertMouseButtonState(ButtonFlags, static_cast<UINT>(wParam)),
+                                     GetControlKeyState(0),
+                                     EventFlags };
+        const auto record = mouseEvent.ToInputRecord();
+        EventsWritten = static_cast<ULONG>(gci.pInputBuffer->Write(gsl::make_span(&record, 1)));
     }
     catch (...)
     {
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "RenderSnapshot.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Routine Description:
+// - Copies the state of the frame that doesn't depend on which rows are going to be painted:
+//   the default colors, the screen and grid line settings and the title.
+// - Whatever was captured for the previous frame is dropped, since any of it may have changed.
+// - The console must be locked while this is called.
+// Arguments:
+// - data - The render data to copy from.
+void RenderSnapshot::Capture(IRenderData& data)
+{
+    _screenReversed = data.IsScreenReversed();
+    _gridLineDrawingAllowed = data.IsGridLineDrawingAllowed();
+    _title = data.GetConsoleTitle();
+
+    _attributeColors.clear();
+    _hyperlinks.clear();
+    _patternRuns.clear();
+    _patternRows.assign(gsl::narrow_cast<size_t>(data.GetViewport().Height()), std::nullopt);
+
+    _defaultBrushColors = data.GetDefaultBrushColors();
+    CaptureAttributes(data, { &_defaultBrushColors, 1 });
+}
+
+// Routine Description:
+// - Copies the colors of the given attributes, and the targets of the ones that are hyperlinks.
+// Arguments:
+// - data - The render data to copy from.
+// - attrs - The attributes of the cells that are going to be painted.
+void RenderSnapshot::CaptureAttributes(IRenderData& data, const gsl::span<const TextAttribute> attrs)
+{
+    for (const auto& attr : attrs)
+    {
+        const auto [it, inserted] = _attributeColors.try_emplace(attr);
+        if (!inserted)
+        {
+            continue;
+        }
+
+        it->second = data.GetAttributeColors(attr);
+
+        if (attr.IsHyperlink())
+        {
+            const auto id = attr.GetHyperlinkId();
+            _hyperlinks.try_emplace(id, data.GetHyperlinkUri(id), data.GetHyperlinkCustomId(id));
+        }
+    }
+}
+
+// Routine Description:
+// - Copies the pattern ids of the cells of a row, unless they have been copied already.
+// Arguments:
+// - data - The render data to copy from.
+// - row - The row of the viewport to copy the pattern ids of.
+// - width - The number of columns of the row.
+void RenderSnapshot::CapturePatternIds(IRenderData& data, const SHORT row, const SHORT width)
+{
+    const auto index = gsl::narrow_cast<size_t>(row);
+    if (row < 0 || index >= _patternRows.size() || _patternRows.at(index))
+    {
+        return;
+    }
+
+    const auto first = _patternRuns.size();
+    for (SHORT column = 0; column < width; ++column)
+    {
+        auto ids = data.GetPatternId({ column, row });
+        if (ids.empty())
+        {
+            continue;
+        }
+
+        if (_patternRuns.size() > first)
+        {
+            auto& previous = _patternRuns.back();
+            if (previous.right == column && previous.ids == ids)
+            {
+                ++previous.right;
+                continue;
+            }
+        }
+
+        _patternRuns.push_back({ column, gsl::narrow_cast<SHORT>(column + 1), std::move(ids) });
+    }
+
+    _patternRows.at(index) = std::pair{ first, _patternRuns.size() };
+}
+
+const TextAttribute RenderSnapshot::GetDefaultBrushColors() noexcept
+{
+    return _defaultBrushColors;
+}
+
+// Routine Description:
+// - Retrieves the colors of an attribute. Only the attributes of the rows that were captured
+//   are known. Any other attribute gets the default colors.
+std::pair<COLORREF, COLORREF> RenderSnapshot::GetAttributeColors(const TextAttribute& attr) const noexcept
+{
+    auto it = _attributeColors.find(attr);
+    if (it == _attributeColors.end())
+    {
+        it = _attributeColors.find(_defaultBrushColors);
+    }
+    return it != _attributeColors.end() ? it->second : std::pair<COLORREF, COLORREF>{};
+}
+
+bool RenderSnapshot::IsScreenReversed() const noexcept
+{
+    return _screenReversed;
+}
+
+// Routine Description:
+// - Overlays reference buffers of the console, which can't be painted without holding the lock.
+//   The renderer doesn't paint from a snapshot while there are any.
+const std::vector<RenderOverlay> RenderSnapshot::GetOverlays() const noexcept
+{
+    return {};
+}
+
+const bool RenderSnapshot::IsGridLineDrawingAllowed() noexcept
+{
+    return _gridLineDrawingAllowed;
+}
+
+const std::wstring_view RenderSnapshot::GetConsoleTitle() const noexcept
+{
+    return _title;
+}
+
+const std::wstring RenderSnapshot::GetHyperlinkUri(uint16_t id) const noexcept
+try
+{
+    const auto it = _hyperlinks.find(id);
+    return it != _hyperlinks.end() ? it->second.first : std::wstring{};
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
+const std::wstring RenderSnapshot::GetHyperlinkCustomId(uint16_t id) const noexcept
+try
+{
+    const auto it = _hyperlinks.find(id);
+    return it != _hyperlinks.end() ? it->second.second : std::wstring{};
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
+// Routine Description:
+// - Retrieves the pattern ids of a cell. Only the rows that were captured are known.
+// - This is called for every cell that's painted, so it looks up the runs of the
+//   cell's row and binary searches them, instead of going through all runs.
+const std::vector<size_t> RenderSnapshot::GetPatternId(const COORD location) const noexcept
+try
+{
+    const auto index = gsl::narrow_cast<size_t>(location.Y);
+    if (location.Y < 0 || index >= _patternRows.size() || !_patternRows.at(index))
+    {
+        return {};
+    }
+
+    const auto [first, last] = *_patternRows.at(index);
+    const auto begin = _patternRuns.begin() + gsl::narrow_cast<ptrdiff_t>(first);
+    const auto end = _patternRuns.begin() + gsl::narrow_cast<ptrdiff_t>(last);
+
+    // Find the last run that starts at or before the cell.
+    const auto it = std::upper_bound(begin, end, location.X, [](const SHORT column, const PatternRun& run) {
+        return column < run.left;
+    });
+    if (it != begin && location.X < std::prev(it)->right)
+    {
+        return std::prev(it)->ids;
+    }
+    return {};
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
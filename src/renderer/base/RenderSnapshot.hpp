@@ -0,0 +1,77 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RenderSnapshot.hpp
+
+Abstract:
+- A copy of the render data that the renderer needs to paint a frame.
+- The renderer fills it in at the beginning of a frame while the console is locked,
+  and then paints the frame from it after letting go of the lock, so that the console
+  can go on changing the buffer in the meantime.
+- Only what the frame is going to paint is copied. The renderer keeps the cells of
+  the dirty rows, the viewport, the cursor and the selection itself, so this holds
+  the colors of the attributes and the pattern ids of the cells, next to the title.
+- It's only the frame data the engines get to see, so that nothing can ask it for the
+  buffer or the font of the console, neither of which is copied.
+--*/
+
+#pragma once
+
+#include "../inc/IRenderData.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class RenderSnapshot final : public IRenderFrameData
+    {
+    public:
+        RenderSnapshot() = default;
+
+        void Capture(IRenderData& data);
+        void CaptureAttributes(IRenderData& data, const gsl::span<const TextAttribute> attrs);
+        void CapturePatternIds(IRenderData& data, const SHORT row, const SHORT width);
+
+#pragma region IRenderFrameData
+        const TextAttribute GetDefaultBrushColors() noexcept override;
+
+        std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
+
+        bool IsScreenReversed() const noexcept override;
+
+        const std::vector<RenderOverlay> GetOverlays() const noexcept override;
+
+        const bool IsGridLineDrawingAllowed() noexcept override;
+        const std::wstring_view GetConsoleTitle() const noexcept override;
+
+        const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
+        const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
+
+        const std::vector<size_t> GetPatternId(const COORD location) const noexcept override;
+#pragma endregion
+
+    private:
+        // The cells of a row that share the same pattern ids.
+        // Cells without any pattern ids aren't recorded at all.
+        struct PatternRun
+        {
+            SHORT left;
+            SHORT right;
+            std::vector<size_t> ids;
+        };
+
+        TextAttribute _defaultBrushColors;
+        std::unordered_map<TextAttribute, std::pair<COLORREF, COLORREF>> _attributeColors;
+        std::unordered_map<uint16_t, std::pair<std::wstring, std::wstring>> _hyperlinks;
+
+        bool _screenReversed = false;
+        bool _gridLineDrawingAllowed = false;
+        std::wstring _title;
+
+        // The runs of all captured rows, each row's runs ordered by column.
+        std::vector<PatternRun> _patternRuns;
+        // For each row of the viewport, the range of _patternRuns that belongs to it,
+        // or nullopt if its pattern ids haven't been captured.
+        std::vector<std::optional<std::pair<size_t, size_t>>> _patternRows;
+    };
+}
@@ -4,6 +4,7 @@
 #include "precomp.h"
 
 #include "renderer.hpp"
+#include "../../types/inc/PerformanceCounters.hpp"
 
 #pragma hdrstop
 
@@ -31,7 +32,10 @@ Renderer::Renderer(IRenderData* pData,
     _pData(THROW_HR_IF_NULL(E_INVALIDARG, pData)),
     _pThread{ std::move(thread) },
     _destructing{ false },
+    _performanceCounters{ nullptr },
     _clusterBuffer{},
+    _rowLayouts{},
+    _rowLayoutClock{ 0 },
     _viewport{ pData->GetViewport() }
 {
     for (size_t i = 0; i < cEngines; i++)
@@ -67,6 +71,11 @@ Renderer::~Renderer()
         return S_FALSE;
     }
 
+    if (_performanceCounters)
+    {
+        _performanceCounters->Add(PerformanceCounter::FramesPainted);
+    }
+
     for (IRenderEngine* const pEngine : _rgpEngines)
     {
         auto tries = maxRetriesForRenderEngine;
@@ -116,6 +125,13 @@ try
         _pData->UnlockConsole();
     });
 
+    // Keep everyone else away from the engines until we're done with the frame,
+    // even if we let go of the console lock halfway through.
+    std::unique_lock paintLock{ _paintMutex };
+
+    // Hand the engines whatever was invalidated while the previous frame was painted without the lock.
+    _FlushPendingInvalidations();
+
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
 
@@ -131,6 +147,28 @@ try
         return S_OK;
     }
 
+    // Count the time it takes to paint, but not the time spent waiting for the console lock above.
+    const auto paintStart = std::chrono::steady_clock::now();
+    auto countPaint = wil::scope_exit([&]() noexcept {
+        if (_performanceCounters)
+        {
+            // Engines are told apart by their position in the list of engines.
+            const auto engine = gsl::narrow_cast<size_t>(std::find(_rgpEngines.cbegin(), _rgpEngines.cend(), pEngine) - _rgpEngines.cbegin());
+            const auto paintTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - paintStart);
+            _performanceCounters->AddEnginePaint(engine, paintTime);
+        }
+    });
+
+    // Overlays are painted straight from the buffers of the console, so they need the lock.
+    const auto fromSnapshot = _paintFromSnapshot && _pData->GetOverlays().empty();
+
+    // Once the engine is done with the frame, invalidations may go to it directly again.
+    // This is declared before EndPaint below, so that it runs after it.
+    auto stopPaintingUnlocked = wil::scope_exit([&]() {
+        std::scoped_lock invalidationLock{ _invalidationMutex };
+        _paintingUnlocked = false;
+    });
+
     auto endPaint = wil::scope_exit([&]() {
         LOG_IF_FAILED(pEngine->EndPaint());
 
@@ -143,8 +181,11 @@ try
         }
     });
 
+    // Gather the state of the frame.
+    _GatherFrame(fromSnapshot);
+
     // A. Prep Colors
-    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _pData->GetDefaultBrushColors(), true));
+    RETURN_IF_FAILED(_UpdateDrawingBrushes(pEngine, _frame.data->GetDefaultBrushColors(), true));
 
     // B. Perform Scroll Operations
     RETURN_IF_FAILED(_PerformScrolling(pEngine));
@@ -152,6 +193,21 @@ try
     // C. Prepare the engine with additional information before we start drawing.
     RETURN_IF_FAILED(_PrepareRenderInfo(pEngine));
 
+    // Gather the rows we're going to paint.
+    _GatherDirtyRows(pEngine, fromSnapshot);
+
+    // With everything we're going to paint copied into the snapshot, the console
+    // can go on changing while we paint. Invalidations are queued up meanwhile,
+    // since the engine is busy with the frame.
+    if (fromSnapshot)
+    {
+        {
+            std::scoped_lock invalidationLock{ _invalidationMutex };
+            _paintingUnlocked = true;
+        }
+        unlock.reset();
+    }
+
     // 1. Paint Background
     RETURN_IF_FAILED(_PaintBackground(pEngine));
 
@@ -172,6 +228,7 @@ try
 
     // Force scope exit end paint to finish up collecting information and possibly painting
     endPaint.reset();
+    stopPaintingUnlocked.reset();
 
     // Force scope exit unlock to let go of global lock so other threads can run
     unlock.reset();
@@ -202,8 +259,10 @@ void Renderer::_NotifyPaintFrame()
 // - <none>
 void Renderer::TriggerSystemRedraw(const RECT* const prcDirtyClient)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->InvalidateSystem(prcDirtyClient));
+    _InvalidateEngines([this, dirtyClient = *prcDirtyClient]() {
+        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+            LOG_IF_FAILED(pEngine->InvalidateSystem(&dirtyClient));
+        });
     });
 
     _NotifyPaintFrame();
@@ -235,8 +294,10 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-            LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+        _InvalidateEngines([this, srUpdateRegion]() {
+            std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+                LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
+            });
         });
 
         _NotifyPaintFrame();
@@ -286,10 +347,12 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
         if (cursorView.IsValid())
         {
             const SMALL_RECT updateRect = view.ConvertToOrigin(cursorView).ToExclusive();
-            for (IRenderEngine* pEngine : _rgpEngines)
-            {
-                LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
-            }
+            _InvalidateEngines([this, updateRect]() {
+                for (IRenderEngine* pEngine : _rgpEngines)
+                {
+                    LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
+                }
+            });
 
             _NotifyPaintFrame();
         }
@@ -305,8 +368,10 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
 // - <none>
 void Renderer::TriggerRedrawAll()
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->InvalidateAll());
+    _InvalidateEngines([this]() {
+        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+        });
     });
 
     _NotifyPaintFrame();
@@ -367,9 +432,11 @@ void Renderer::TriggerSelection()
             sr = Viewport::FromInclusive(rc).ToExclusive();
         }
 
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-            LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
-            LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+        _InvalidateEngines([this, previousSelection = _previousSelection, rects]() {
+            std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+                LOG_IF_FAILED(pEngine->InvalidateSelection(previousSelection));
+                LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
+            });
         });
 
         _previousSelection = rects;
@@ -394,26 +461,25 @@ bool Renderer::_CheckViewportAndScroll()
     coordDelta.X = srOldViewport.Left - srNewViewport.Left;
     coordDelta.Y = srOldViewport.Top - srNewViewport.Top;
 
-    for (auto engine : _rgpEngines)
-    {
-        LOG_IF_FAILED(engine->UpdateViewport(srNewViewport));
-    }
-
     _viewport = Viewport::FromInclusive(srNewViewport);
 
-    // If we're keeping some buffers between calls, let them know about the viewport size
-    // so they can prepare the buffers for changes to either preallocate memory at once
-    // (instead of growing naturally) or shrink down to reduce usage as appropriate.
-    const size_t lineLength = gsl::narrow_cast<size_t>(til::rectangle{ srNewViewport }.width());
-    til::manage_vector(_clusterBuffer, lineLength, _shrinkThreshold);
-
-    if (coordDelta.X != 0 || coordDelta.Y != 0)
-    {
+    _InvalidateEngines([this, srNewViewport, coordDelta]() {
         for (auto engine : _rgpEngines)
         {
-            LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
+            LOG_IF_FAILED(engine->UpdateViewport(srNewViewport));
         }
 
+        if (coordDelta.X != 0 || coordDelta.Y != 0)
+        {
+            for (auto engine : _rgpEngines)
+            {
+                LOG_IF_FAILED(engine->InvalidateScroll(&coordDelta));
+            }
+        }
+    });
+
+    if (coordDelta.X != 0 || coordDelta.Y != 0)
+    {
         _ScrollPreviousSelection(coordDelta);
 
         return true;
@@ -448,8 +514,10 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 {
-    std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-        LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
+    _InvalidateEngines([this, coordDelta = *pcoordDelta]() {
+        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+            LOG_IF_FAILED(pEngine->InvalidateScroll(&coordDelta));
+        });
     });
 
     _ScrollPreviousSelection(*pcoordDelta);
@@ -460,6 +528,9 @@ void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 // Routine Description:
 // - Called when the text buffer is about to circle its backing buffer.
 //      A renderer might want to get painted before that happens.
+// - Like any other invalidation, this is queued up while an engine paints a frame
+//      without the console lock. That frame was gathered before the buffer circled,
+//      and the engine is told about it at the beginning of the next one.
 // Arguments:
 // - <none>
 // Return Value:
@@ -469,9 +540,24 @@ void Renderer::TriggerCircling()
     for (IRenderEngine* const pEngine : _rgpEngines)
     {
         bool fEngineRequestsRepaint = false;
-        HRESULT hr = pEngine->InvalidateCircling(&fEngineRequestsRepaint);
-        LOG_IF_FAILED(hr);
+        HRESULT hr = S_OK;
 
+        {
+            std::scoped_lock invalidationLock{ _invalidationMutex };
+            if (_paintingUnlocked || !_pendingInvalidations.empty())
+            {
+                _pendingInvalidations.emplace_back([pEngine]() {
+                    bool fIgnored = false;
+                    LOG_IF_FAILED(pEngine->InvalidateCircling(&fIgnored));
+                });
+                continue;
+            }
+
+            hr = pEngine->InvalidateCircling(&fEngineRequestsRepaint);
+            LOG_IF_FAILED(hr);
+        }
+
+        // Only an engine that has to be painted before the buffer circles waits for the paint.
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
         {
             LOG_IF_FAILED(_PaintFrameForEngine(pEngine));
@@ -488,11 +574,12 @@ void Renderer::TriggerCircling()
 // - <none>
 void Renderer::TriggerTitleChange()
 {
-    const auto newTitle = _pData->GetConsoleTitle();
-    for (IRenderEngine* const pEngine : _rgpEngines)
-    {
-        LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
-    }
+    _InvalidateEngines([this, newTitle = std::wstring{ _pData->GetConsoleTitle() }]() {
+        for (IRenderEngine* const pEngine : _rgpEngines)
+        {
+            LOG_IF_FAILED(pEngine->InvalidateTitle(newTitle));
+        }
+    });
     _NotifyPaintFrame();
 }
 
@@ -504,7 +591,7 @@ void Renderer::TriggerTitleChange()
 // - the HRESULT of the underlying engine's UpdateTitle call.
 HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 {
-    const auto newTitle = _pData->GetConsoleTitle();
+    const auto newTitle = _frame.data->GetConsoleTitle();
     return pEngine->UpdateTitle(newTitle);
 }
 
@@ -518,6 +605,9 @@ HRESULT Renderer::_PaintTitle(IRenderEngine* const pEngine)
 // - <none>
 void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfoDesired, _Out_ FontInfo& FontInfo)
 {
+    // The caller needs the font right away, so this can't be queued up for the next frame.
+    std::scoped_lock paintLock{ _paintMutex };
+
     std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
         LOG_IF_FAILED(pEngine->UpdateDpi(iDpi));
         LOG_IF_FAILED(pEngine->UpdateFont(FontInfoDesired, FontInfo));
@@ -632,30 +722,59 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
 }
 
 // Routine Description:
-// - Paint helper to copy the primary console buffer text onto the screen.
-// - This portion primarily handles figuring the current viewport, comparing it/trimming it versus the invalid portion of the frame, and queuing up, row by row, which pieces of text need to be further processed.
-// - See also: Helper functions that separate out each complexity of text rendering.
+// - Gathers the state of the frame that's about to be painted: what it's painted from,
+//   the viewport, the cursor and the selection.
+// - The console must be locked while this is called.
 // Arguments:
+// - fromSnapshot - Whether to copy the render data into the snapshot and paint the frame from it.
+// Return Value:
 // - <none>
+void Renderer::_GatherFrame(const bool fromSnapshot)
+{
+    if (fromSnapshot)
+    {
+        _snapshot.Capture(*_pData);
+        _frame.data = &_snapshot;
+    }
+    else
+    {
+        _frame.data = _pData;
+    }
+
+    _frame.view = _pData->GetViewport();
+    _frame.cursor = _GetCursorInfo();
+    _frame.selection = _GetSelectionRects();
+    _frame.hoveredInterval = _hoveredInterval;
+    _frame.rows.clear();
+
+    // If we're keeping some buffers between calls, let them know about the viewport size
+    // so they can prepare the buffers for changes to either preallocate memory at once
+    // (instead of growing naturally) or shrink down to reduce usage as appropriate.
+    const size_t lineLength = gsl::narrow_cast<size_t>(_frame.view.Width());
+    til::manage_vector(_clusterBuffer, lineLength, _shrinkThreshold);
+}
+
+// Routine Description:
+// - Figures out which rows of the buffer the engine needs to repaint, by comparing the viewport
+//   with the invalid portion of the frame, and retrieves the cells of each.
+// - The console must be locked while this is called.
+// Arguments:
+// - pEngine - The engine that's painting the frame.
+// - fromSnapshot - Whether to copy the colors and pattern ids of the rows into the snapshot.
 // Return Value:
 // - <none>
-void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+void Renderer::_GatherDirtyRows(_In_ IRenderEngine* const pEngine, const bool fromSnapshot)
 {
     // This is the subsection of the entire screen buffer that is currently being presented.
     // It can move left/right or top/bottom depending on how the viewport is scrolled
     // relative to the entire buffer.
-    const auto view = _pData->GetViewport();
+    const auto& view = _frame.view;
 
     // This is effectively the number of cells on the visible screen that need to be redrawn.
     // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
     gsl::span<const til::rectangle> dirtyAreas;
     LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
-    // This is to make sure any transforms are reset when this paint is finished.
-    auto resetLineTransform = wil::scope_exit([&]() {
-        LOG_IF_FAILED(pEngine->ResetLineTransform());
-    });
-
     for (const auto& dirtyRect : dirtyAreas)
     {
         auto dirty = Viewport::FromInclusive(dirtyRect);
@@ -694,58 +813,203 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
                 // of the backing buffer to fill in line 1 of the screen.
                 const auto screenPosition = bufferLine.Origin() - COORD{ 0, view.Top() };
 
-                // Retrieve the cell information iterator limited to just this line we want to redraw.
-                auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
+                // Retrieve the cell information of the row, which we only need to
+                // gather again if the row has changed since we last painted it.
+                // The layouts belong to us, so they stay put after the console is unlocked.
+                const auto& bufferRow = buffer.GetRowByOffset(bufferLine.Origin().Y);
+                const auto& layout = _GetRowLayout(bufferRow);
 
                 // Calculate if two things are true:
                 // 1. this row wrapped
                 // 2. We're painting the last col of the row.
                 // In that case, set lineWrapped=true for the _PaintBufferOutputHelper call.
-                const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().Y).WasWrapForced()) &&
+                const auto lineWrapped = (bufferRow.WasWrapForced()) &&
                                          (bufferLine.RightExclusive() == buffer.GetSize().Width());
 
-                // Prepare the appropriate line transform for the current row and viewport offset.
-                LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.Y, view.Left()));
+                _frame.rows.push_back({ &layout,
+                                        gsl::narrow_cast<size_t>(bufferLine.Left()),
+                                        gsl::narrow_cast<size_t>(bufferLine.RightExclusive()),
+                                        screenPosition,
+                                        lineRendition,
+                                        lineWrapped });
 
-                // Ask the helper to paint through this specific line.
-                _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+                if (fromSnapshot)
+                {
+                    _snapshot.CaptureAttributes(*_pData, layout.attrs);
+                    _snapshot.CapturePatternIds(*_pData, screenPosition.Y, buffer.GetSize().Width());
+                }
             }
         }
     }
 }
 
+// Routine Description:
+// - Paint helper to copy the primary console buffer text onto the screen.
+// - The rows to paint have been gathered at the beginning of the frame, and are queued up, row by row,
+//   to be further processed.
+// - See also: Helper functions that separate out each complexity of text rendering.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
+{
+    // This is to make sure any transforms are reset when this paint is finished.
+    auto resetLineTransform = wil::scope_exit([&]() {
+        LOG_IF_FAILED(pEngine->ResetLineTransform());
+    });
+
+    for (const auto& row : _frame.rows)
+    {
+        // Prepare the appropriate line transform for the current row and viewport offset.
+        LOG_IF_FAILED(pEngine->PrepareLineTransform(row.lineRendition, row.target.Y, _frame.view.Left()));
+
+        // Ask the helper to paint through this specific line.
+        _PaintBufferOutputHelper(pEngine, *row.layout, row.left, row.right, row.target, row.lineWrapped);
+    }
+}
+
 static bool _IsAllSpaces(const std::wstring_view v)
 {
     // first non-space char is not found (is npos)
     return v.find_first_not_of(L" ") == decltype(v)::npos;
 }
 
+std::wstring_view Renderer::RowLayout::Chars(const size_t column) const noexcept
+{
+    const auto& cell = til::at(cells, column);
+    return { text.data() + cell.textOffset, cell.textLength };
+}
+
+const TextAttribute& Renderer::RowLayout::Attr(const size_t column) const noexcept
+{
+    return til::at(attrs, til::at(cells, column).attrIndex);
+}
+
+DbcsAttribute Renderer::RowLayout::DbcsAttr(const size_t column) const noexcept
+{
+    return til::at(cells, column).dbcsAttr;
+}
+
+// Routine Description:
+// - Reports how many columns the glyph of the given cell occupies. See OutputCellView::Columns.
+size_t Renderer::RowLayout::Columns(const size_t column) const noexcept
+{
+    return DbcsAttr(column).IsLeading() ? 2 : 1;
+}
+
+// Routine Description:
+// - Retrieves the layout of a row, building it if the row has changed since we last painted it.
+// - Only as many layouts as fit two viewports are kept. Beyond that, the least recently used
+//   layout makes room (and lends its memory) for the new one.
+// Arguments:
+// - row - The buffer row to retrieve the layout of.
+// Return Value:
+// - The layout of the row. It remains valid until the next call.
+const Renderer::RowLayout& Renderer::_GetRowLayout(const ROW& row)
+{
+    const auto generation = row.GetGeneration();
+    ++_rowLayoutClock;
+
+    if (const auto it = _rowLayouts.find(generation); it != _rowLayouts.end())
+    {
+        it->second.lastUsed = _rowLayoutClock;
+        return it->second;
+    }
+
+    const auto capacity = std::max<size_t>(gsl::narrow_cast<size_t>(_viewport.Height()) * 2, 1);
+    auto layout = _rowLayouts.end();
+    if (_rowLayouts.size() >= capacity)
+    {
+        const auto leastRecentlyUsed = std::min_element(_rowLayouts.begin(), _rowLayouts.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.lastUsed < rhs.second.lastUsed;
+        });
+        auto node = _rowLayouts.extract(leastRecentlyUsed);
+        node.key() = generation;
+        layout = _rowLayouts.insert(std::move(node)).position;
+    }
+    else
+    {
+        layout = _rowLayouts.try_emplace(generation).first;
+    }
+
+    // If building the layout fails, don't leave a half built one behind.
+    auto removeLayout = wil::scope_exit([&]() noexcept { _rowLayouts.erase(layout); });
+    s_BuildRowLayout(row, layout->second);
+    removeLayout.release();
+
+    layout->second.lastUsed = _rowLayoutClock;
+    return layout->second;
+}
+
+// Routine Description:
+// - Walks through the cells of a row and records the glyph, the width and the attributes of each.
+// Arguments:
+// - row - The buffer row to break down into cells.
+// - layout - Receives the cells of the row.
+void Renderer::s_BuildRowLayout(const ROW& row, RowLayout& layout)
+{
+    const auto& charRow = row.GetCharRow();
+    const auto width = row.size();
+
+    layout.text.clear();
+    layout.attrs.clear();
+    layout.cells.clear();
+    layout.cells.reserve(width);
+
+    auto attrIt = row.GetAttrRow().cbegin();
+    for (size_t column = 0; column < width; ++column, ++attrIt)
+    {
+        if (layout.attrs.empty() || layout.attrs.back() != *attrIt)
+        {
+            layout.attrs.emplace_back(*attrIt);
+        }
+
+        const std::wstring_view glyph{ charRow.GlyphAt(column) };
+        layout.cells.push_back({ gsl::narrow<uint32_t>(layout.text.size()),
+                                 gsl::narrow<uint16_t>(glyph.size()),
+                                 gsl::narrow_cast<uint16_t>(layout.attrs.size() - 1),
+                                 charRow.DbcsAttrAt(column) });
+        layout.text.append(glyph);
+    }
+}
+
+// Routine Description:
+// - Paints the given columns of a row, in runs of cells with the same attributes.
+// Arguments:
+// - layout - The layout of the row to paint.
+// - left - The first column of the row to paint.
+// - right - The column past the last one to paint.
+// - target - The position on the screen to paint the first column at.
+// - lineWrapped - Whether the row wrapped onto the next one and we're painting its last column.
 void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
+                                        const RowLayout& layout,
+                                        const size_t left,
+                                        const size_t right,
                                         const COORD target,
                                         const bool lineWrapped)
 {
-    auto globalInvert{ _pData->IsScreenReversed() };
+    auto globalInvert{ _frame.data->IsScreenReversed() };
+
+    // The column we're at. The layout covers the whole row, but we're only painting [left, right).
+    auto column = left;
+    const auto end = std::min(right, layout.cells.size());
 
     // If we have valid data, let's figure out how to draw it.
-    if (it)
+    if (column < end)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
         size_t cols = 0;
 
         // Retrieve the first color.
-        auto color = it->TextAttr();
+        auto color = layout.Attr(column);
         // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
+        auto patternIds = _frame.data->GetPatternId(target);
 
         // And hold the point where we should start drawing.
         auto screenPoint = target;
 
         // This outer loop will continue until we reach the end of the text we are trying to draw.
-        while (it)
+        while (column < end)
         {
             // Hold onto the current run color right here for the length of the outer loop.
             // We'll be changing the persistent one as we run through the inner loops to detect
@@ -763,9 +1027,9 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             screenPoint.X += gsl::narrow<SHORT>(cols);
             cols = 0;
 
-            // Hold onto the start of this run iterator and the target location where we started
+            // Hold onto the start of this run and the target location where we started
             // in case we need to do some special work to paint the line drawing characters.
-            const auto currentRunItStart = it;
+            const auto currentRunColumnStart = column;
             const auto currentRunTargetStart = screenPoint;
 
             // Ensure that our cluster vector is clear.
@@ -785,13 +1049,14 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             do
             {
                 COORD thisPoint{ screenPoint.X + gsl::narrow<SHORT>(cols), screenPoint.Y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
-                if (color != it->TextAttr() || patternIds != thisPointPatterns)
+                const auto thisPointPatterns = _frame.data->GetPatternId(thisPoint);
+                const auto chars = layout.Chars(column);
+                if (color != layout.Attr(column) || patternIds != thisPointPatterns)
                 {
-                    auto newAttr{ it->TextAttr() };
+                    const auto& newAttr{ layout.Attr(column) };
                     // foreground doesn't matter for runs of spaces (!)
                     // if we trick it . . . we call Paint far fewer times for cmatrix
-                    if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || patternIds != thisPointPatterns)
+                    if (!_IsAllSpaces(chars) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || patternIds != thisPointPatterns)
                     {
                         color = newAttr;
                         patternIds = thisPointPatterns;
@@ -805,21 +1070,21 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
                 // If we're on the first cluster to be added and it's marked as "trailing"
                 // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr().IsTrailing())
+                if (_clusterBuffer.empty() && layout.DbcsAttr(column).IsTrailing())
                 {
                     // Move left to the one so the whole character can be struck correctly.
                     --screenPoint.X;
                     // And tell the next function to trim off the left half of it.
                     trimLeft = true;
                     // And add one to the number of columns we expect it to take as we insert it.
-                    columnCount = it->Columns() + 1;
-                    _clusterBuffer.emplace_back(it->Chars(), columnCount);
+                    columnCount = layout.Columns(column) + 1;
+                    _clusterBuffer.emplace_back(chars, columnCount);
                 }
                 // Otherwise if it's not a special case, just insert it as is.
                 else
                 {
-                    columnCount = it->Columns();
-                    _clusterBuffer.emplace_back(it->Chars(), columnCount);
+                    columnCount = layout.Columns(column);
+                    _clusterBuffer.emplace_back(chars, columnCount);
                 }
 
                 if (columnCount > 1)
@@ -828,17 +1093,17 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                 }
 
                 // Advance the cluster and column counts.
-                it += std::max<size_t>(it->Columns(), 1); // prevent infinite loop for no visible columns
+                column += std::max<size_t>(layout.Columns(column), 1); // prevent infinite loop for no visible columns
                 cols += columnCount;
 
-            } while (it);
+            } while (column < end);
 
             // Do the painting.
             THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
 
             // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
             // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+            if (_frame.data->IsGridLineDrawingAllowed())
             {
                 // See GH: 803
                 // If we found a wide character while we looped above, it's possible we skipped over the right half
@@ -846,20 +1111,22 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                 if (containsWideCharacter)
                 {
                     // Start from the original position in this run.
-                    auto lineIt = currentRunItStart;
+                    auto lineColumn = currentRunColumnStart;
                     // Start from the original target in this run.
                     auto lineTarget = currentRunTargetStart;
 
-                    // We need to go through the iterators again to ensure we get the lines associated with each
+                    // We need to go through the columns again to ensure we get the lines associated with each
                     // exact column. The code above will condense two-column characters into one, but it is possible
                     // (like with the IME) that the line drawing characters will vary from the left to right half
                     // of a wider character.
                     // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
+                    // the columns, but I fear it would make the code even more confusing than it already is.
                     // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (auto colsPainted = 0u; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.X)
+                    // A wide glyph in the last column may take us past the end of the row.
+                    // Its right half gets the lines of the last column of the row.
+                    for (auto colsPainted = 0u; colsPainted < cols; ++colsPainted, ++lineColumn, ++lineTarget.X)
                     {
-                        auto lines = lineIt->TextAttr();
+                        const auto& lines = layout.Attr(std::min(lineColumn, layout.cells.size() - 1));
                         _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
                     }
                 }
@@ -948,13 +1215,13 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     // For now, we dash underline patterns and switch to regular underline on hover
     // Since we're only rendering pattern links on *hover*, there's no point in checking
     // the pattern range if we aren't currently hovering.
-    if (_hoveredInterval.has_value())
+    if (_frame.hoveredInterval.has_value())
     {
         const til::point coordTargetTil{ coordTarget };
-        if (_hoveredInterval->start <= coordTargetTil &&
-            coordTargetTil <= _hoveredInterval->stop)
+        if (_frame.hoveredInterval->start <= coordTargetTil &&
+            coordTargetTil <= _frame.hoveredInterval->stop)
         {
-            if (_pData->GetPatternId(coordTarget).size() > 0)
+            if (_frame.data->GetPatternId(coordTarget).size() > 0)
             {
                 lines |= IRenderEngine::GridLines::Underline;
             }
@@ -965,7 +1232,7 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     if (lines != IRenderEngine::GridLines::None)
     {
         // Get the current foreground color to render the lines.
-        const COLORREF rgb = _pData->GetAttributeColors(textAttribute).first;
+        const COLORREF rgb = _frame.data->GetAttributeColors(textAttribute).first;
         // Draw the lines
         LOG_IF_FAILED(pEngine->PaintBufferGridLines(lines, rgb, cchLine, coordTarget));
     }
@@ -1043,10 +1310,9 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
 // - <none>
 void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 {
-    const auto cursorInfo = _GetCursorInfo();
-    if (cursorInfo.has_value())
+    if (_frame.cursor.has_value())
     {
-        LOG_IF_FAILED(pEngine->PaintCursor(cursorInfo.value()));
+        LOG_IF_FAILED(pEngine->PaintCursor(_frame.cursor.value()));
     }
 }
 
@@ -1064,7 +1330,7 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 [[nodiscard]] HRESULT Renderer::_PrepareRenderInfo(_In_ IRenderEngine* const pEngine)
 {
     RenderFrameInfo info;
-    info.cursorInfo = _GetCursorInfo();
+    info.cursorInfo = _frame.cursor;
     return pEngine->PrepareRenderInfo(info);
 }
 
@@ -1082,7 +1348,7 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
     try
     {
         // First get the screen buffer's viewport.
-        Viewport view = _pData->GetViewport();
+        Viewport view = _frame.view;
 
         // Now get the overlay's viewport and adjust it to where it is supposed to be relative to the window.
 
@@ -1113,9 +1379,9 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
                     const COORD target{ viewDirty.Left(), iRow };
                     const auto source = target - overlay.origin;
 
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
+                    const auto& layout = _GetRowLayout(overlay.buffer.GetRowByOffset(source.Y));
 
-                    _PaintBufferOutputHelper(&engine, it, target, false);
+                    _PaintBufferOutputHelper(&engine, layout, source.X, layout.cells.size(), target, false);
                 }
             }
         }
@@ -1135,7 +1401,7 @@ void Renderer::_PaintOverlays(_In_ IRenderEngine* const pEngine)
 {
     try
     {
-        const auto overlays = _pData->GetOverlays();
+        const auto overlays = _frame.data->GetOverlays();
 
         for (const auto& overlay : overlays)
         {
@@ -1159,8 +1425,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
         LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
         // Get selection rectangles
-        const auto rectangles = _GetSelectionRects();
-        for (auto rect : rectangles)
+        for (auto rect : _frame.selection)
         {
             for (auto& dirtyRect : dirtyAreas)
             {
@@ -1193,7 +1458,7 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 {
     // The last color needs to be each engine's responsibility. If it's local to this function,
     //      then on the next engine we might not update the color.
-    return pEngine->UpdateDrawingBrushes(textAttributes, _pData, isSettingDefaultBrushes);
+    return pEngine->UpdateDrawingBrushes(textAttributes, _frame.data, isSettingDefaultBrushes);
 }
 
 // Routine Description:
@@ -1308,6 +1573,92 @@ void Renderer::UpdateLastHoveredInterval(const std::optional<PointTree::interval
     _hoveredInterval = newInterval;
 }
 
+// Method Description:
+// - Lets frames be painted from a snapshot of the render data. The console is then only locked
+//   while the frame is gathered, rather than until the engine is done painting it.
+// - The console must not have any overlays to benefit. Frames with overlays are still painted under the lock.
+// Arguments:
+// - paintFromSnapshot - Whether frames may be painted from a snapshot.
+// Return Value:
+// - <none>
+void Renderer::SetPaintFromSnapshot(const bool paintFromSnapshot) noexcept
+{
+    _paintFromSnapshot = paintFromSnapshot;
+}
+
+// Method Description:
+// - Sets the counters to count frames and paint time into. Set this before painting is enabled.
+// Arguments:
+// - counters - the counters of the terminal we're painting. May be null, in which case nothing is counted.
+// Return Value:
+// - <none>
+void Renderer::SetPerformanceCounters(PerformanceCounters* const counters) noexcept
+{
+    _performanceCounters = counters;
+}
+
+// Method Description:
+// - Retrieves the timing of the frames our render thread painted so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - The frame statistics, or all zeroes if there's no render thread.
+FrameStatistics Renderer::GetFrameStatistics() const noexcept
+{
+    return _pThread ? _pThread->GetFrameStatistics() : FrameStatistics{};
+}
+
+// Method Description:
+// - Keeps the engines from painting, so that their settings can be changed.
+// - When frames are painted from a snapshot, holding the console lock isn't enough for that anymore.
+//   If both are needed, the console has to be locked first.
+// Return Value:
+// - The lock on the engines.
+[[nodiscard]] std::unique_lock<std::mutex> Renderer::LockEngines()
+{
+    return std::unique_lock{ _paintMutex };
+}
+
+// Routine Description:
+// - Runs an invalidation of the engines. While an engine is painting a frame without the console lock,
+//   the invalidation is queued up instead, and run at the beginning of the next frame.
+// - As long as any invalidations are queued up, new ones are queued after them, so that they all run in order.
+// Arguments:
+// - invalidate - The invalidation to run.
+// Return Value:
+// - <none>
+void Renderer::_InvalidateEngines(const std::function<void()>& invalidate)
+{
+    std::scoped_lock invalidationLock{ _invalidationMutex };
+    if (_paintingUnlocked || !_pendingInvalidations.empty())
+    {
+        _pendingInvalidations.emplace_back(invalidate);
+    }
+    else
+    {
+        invalidate();
+    }
+}
+
+// Routine Description:
+// - Runs the invalidations that were queued up while the previous frame was painted.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_FlushPendingInvalidations()
+{
+    std::scoped_lock invalidationLock{ _invalidationMutex };
+    auto clear = wil::scope_exit([&]() noexcept {
+        _pendingInvalidations.clear();
+    });
+
+    for (const auto& invalidate : _pendingInvalidations)
+    {
+        invalidate();
+    }
+}
+
 // Method Description:
 // - Blocks until the engines are able to render without blocking.
 void Renderer::WaitUntilCanRender()
@@ -21,6 +21,7 @@ Author(s):
 #include "../inc/IRenderData.hpp"
 
 #include "thread.hpp"
+#include "RenderSnapshot.hpp"
 
 #include "../../buffer/out/textBuffer.hpp"
 #include "../../buffer/out/CharRow.hpp"
@@ -82,6 +83,11 @@ namespace Microsoft::Console::Render
 
         void UpdateLastHoveredInterval(const std::optional<interval_tree::IntervalTree<til::point, size_t>::interval>& newInterval);
 
+        void SetPaintFromSnapshot(const bool paintFromSnapshot) noexcept;
+        void SetPerformanceCounters(Microsoft::Console::Types::PerformanceCounters* const counters) noexcept;
+        FrameStatistics GetFrameStatistics() const noexcept;
+        [[nodiscard]] std::unique_lock<std::mutex> LockEngines();
+
     private:
         std::deque<IRenderEngine*> _rgpEngines;
 
@@ -90,6 +96,9 @@ namespace Microsoft::Console::Render
         std::unique_ptr<IRenderThread> _pThread;
         bool _destructing = false;
 
+        // The counters of the terminal we're painting, if it keeps any.
+        Microsoft::Console::Types::PerformanceCounters* _performanceCounters = nullptr;
+
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
 
         void _NotifyPaintFrame();
@@ -102,8 +111,64 @@ namespace Microsoft::Console::Render
 
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
 
+        // The contents of a buffer row, broken down into the cells we paint.
+        struct RowLayout
+        {
+            struct Cell
+            {
+                uint32_t textOffset;
+                uint16_t textLength;
+                uint16_t attrIndex;
+                DbcsAttribute dbcsAttr;
+            };
+
+            // The glyphs of all cells, back to back.
+            std::wstring text;
+            // The distinct attributes of consecutive cells.
+            std::vector<TextAttribute> attrs;
+            std::vector<Cell> cells;
+            uint64_t lastUsed = 0;
+
+            std::wstring_view Chars(const size_t column) const noexcept;
+            const TextAttribute& Attr(const size_t column) const noexcept;
+            DbcsAttribute DbcsAttr(const size_t column) const noexcept;
+            size_t Columns(const size_t column) const noexcept;
+        };
+
+        const RowLayout& _GetRowLayout(const ROW& row);
+        static void s_BuildRowLayout(const ROW& row, RowLayout& layout);
+
+        // What the frame that's being painted is drawn from.
+        // It's gathered at the beginning of the frame, while the console is locked.
+        struct Frame
+        {
+            // The dirty part of a row, and where on the screen it goes.
+            struct Row
+            {
+                const RowLayout* layout;
+                size_t left;
+                size_t right;
+                COORD target;
+                LineRendition lineRendition;
+                bool lineWrapped;
+            };
+
+            // Either the console's render data, or the snapshot of it.
+            IRenderFrameData* data = nullptr;
+            Microsoft::Console::Types::Viewport view;
+            std::vector<Row> rows;
+            std::optional<CursorOptions> cursor;
+            std::vector<SMALL_RECT> selection;
+            std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> hoveredInterval;
+        };
+
+        void _GatherFrame(const bool fromSnapshot);
+        void _GatherDirtyRows(_In_ IRenderEngine* const pEngine, const bool fromSnapshot);
+
         void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                      TextBufferCellIterator it,
+                                      const RowLayout& layout,
+                                      const size_t left,
+                                      const size_t right,
                                       const COORD target,
                                       const bool lineWrapped);
 
@@ -129,6 +194,32 @@ namespace Microsoft::Console::Render
         static constexpr float _shrinkThreshold = 0.8f;
         std::vector<Cluster> _clusterBuffer;
 
+        // The layouts of the rows we painted most recently, keyed by the generation of the row
+        // they were built from. As long as a row doesn't change, painting it again (because of
+        // the cursor, the selection, blinking or scrolling) reuses its layout.
+        std::unordered_map<uint64_t, RowLayout> _rowLayouts;
+        uint64_t _rowLayoutClock;
+
+        Frame _frame;
+
+        // Whether frames may be painted from a snapshot of the render data, so that the
+        // console lock can be let go of as soon as the frame has been gathered.
+        bool _paintFromSnapshot = false;
+        RenderSnapshot _snapshot;
+
+        // Held while an engine paints a frame, or while its settings are changed.
+        // Once a frame is painted from a snapshot, the console lock doesn't keep others away from the engines anymore.
+        std::mutex _paintMutex;
+
+        // While an engine paints a frame without holding the console lock, invalidations
+        // are queued up here, and handed to the engines at the beginning of the next frame.
+        std::mutex _invalidationMutex;
+        std::vector<std::function<void()>> _pendingInvalidations;
+        bool _paintingUnlocked = false;
+
+        void _InvalidateEngines(const std::function<void()>& invalidate);
+        void _FlushPendingInvalidations();
+
         std::vector<SMALL_RECT> _GetSelectionRects() const;
         void _ScrollPreviousSelection(const til::point delta);
         std::vector<SMALL_RECT> _previousSelection;
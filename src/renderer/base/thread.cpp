@@ -17,7 +17,17 @@ RenderThread::RenderThread() :
     _fKeepRunning(true),
     _hPaintEnabledEvent(nullptr),
     _fNextFrameRequested(false),
-    _fWaiting(false)
+    _fWaiting(false),
+    _requestTime(0),
+    _lastPaintStart(),
+    _lastPaintEnd(),
+    _averagePaintDuration(),
+    _frames(0),
+    _immediateFrames(0),
+    _lastPaintDuration(0),
+    _lastLatency(0),
+    _maxLatency(0),
+    _immediateFrame(false)
 {
 }
 
@@ -200,25 +210,138 @@ DWORD WINAPI RenderThread::_ThreadProc()
             ResetEvent(_hEvent);
         }
 
+        // extra check before we wait since it's a "long" activity, relatively speaking.
+        if (_fKeepRunning)
+        {
+            _WaitForFrameDeadline();
+        }
+
+        // Everything that was requested up to here is going to be painted now.
+        _fNextFrameRequested.store(false, std::memory_order_release);
+        const auto requestTime = _requestTime.exchange(0, std::memory_order_relaxed);
+
         ResetEvent(_hPaintCompletedEvent);
 
         _pRenderer->WaitUntilCanRender();
+        const auto paintStart = clock::now();
         LOG_IF_FAILED(_pRenderer->PaintFrame());
+        const auto paintEnd = clock::now();
 
         SetEvent(_hPaintCompletedEvent);
 
-        // extra check before we sleep since it's a "long" activity, relatively speaking.
-        if (_fKeepRunning)
+        _RecordFrame(paintStart, paintEnd, requestTime);
+    }
+
+    return S_OK;
+}
+
+// Method Description:
+// - Waits until it's time to paint the frame that has been requested.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void RenderThread::_WaitForFrameDeadline()
+{
+    const auto delay = _GetFrameDelay(clock::now());
+    if (delay > clock::duration::zero())
+    {
+        // Round up, so that we don't wake up just before the deadline.
+        const auto wait = std::chrono::ceil<std::chrono::milliseconds>(delay);
+        Sleep(gsl::narrow_cast<DWORD>(wait.count()));
+    }
+}
+
+// Method Description:
+// - Determines how long to wait before painting the frame that has been requested.
+// - If we've been idle for a while, that's not at all, since the frame likely
+//   shows the echo of user input. Otherwise output is coming in continuously,
+//   and the frame is deferred until a frame interval after the previous frame
+//   started. The interval grows with the time painting takes, so that slow
+//   frames don't starve the output of the console lock.
+// Arguments:
+// - now - The current time.
+// Return Value:
+// - The time left until the frame is due, or zero if it's due already.
+RenderThread::clock::duration RenderThread::_GetFrameDelay(const clock::time_point now) noexcept
+{
+    _immediateFrame = now - _lastPaintEnd >= s_InteractiveIdleTime;
+    if (_immediateFrame)
+    {
+        return clock::duration::zero();
+    }
+
+    const auto interval = std::clamp(2 * _averagePaintDuration, s_MinimumFrameInterval, s_MaximumFrameInterval);
+    const auto deadline = _lastPaintStart + interval;
+    return std::max(deadline - now, clock::duration::zero());
+}
+
+// Method Description:
+// - Updates the paint cost the frame pacing is based on and the frame statistics.
+// Arguments:
+// - paintStart - When we started painting the frame.
+// - paintEnd - When we were done painting the frame.
+// - requestTime - When the frame was first requested, or 0 if we don't know.
+// Return Value:
+// - <none>
+void RenderThread::_RecordFrame(const clock::time_point paintStart, const clock::time_point paintEnd, const clock::rep requestTime) noexcept
+{
+    const auto paintDuration = paintEnd - paintStart;
+
+    _lastPaintStart = paintStart;
+    _lastPaintEnd = paintEnd;
+    // An exponential moving average over roughly the last 8 frames.
+    _averagePaintDuration += (paintDuration - _averagePaintDuration) / 8;
+
+    _frames.fetch_add(1, std::memory_order_relaxed);
+    if (_immediateFrame)
+    {
+        _immediateFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    _lastPaintDuration.store(paintDuration.count(), std::memory_order_relaxed);
+
+    if (requestTime != 0)
+    {
+        const auto latency = paintEnd.time_since_epoch().count() - requestTime;
+        _lastLatency.store(latency, std::memory_order_relaxed);
+        if (latency > _maxLatency.load(std::memory_order_relaxed))
         {
-            Sleep(s_FrameLimitMilliseconds);
+            _maxLatency.store(latency, std::memory_order_relaxed);
         }
     }
+}
 
-    return S_OK;
+// Method Description:
+// - Retrieves the timing of the frames painted so far.
+// - It may be called on any thread. Each value is read on its own, so they
+//   may come from different frames if a frame completes in the meantime.
+// Arguments:
+// - <none>
+// Return Value:
+// - The frame statistics.
+FrameStatistics RenderThread::GetFrameStatistics() const noexcept
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    FrameStatistics statistics{};
+    statistics.frames = _frames.load(std::memory_order_relaxed);
+    statistics.immediateFrames = _immediateFrames.load(std::memory_order_relaxed);
+    statistics.lastPaintDuration = duration_cast<microseconds>(clock::duration{ _lastPaintDuration.load(std::memory_order_relaxed) });
+    statistics.lastLatency = duration_cast<microseconds>(clock::duration{ _lastLatency.load(std::memory_order_relaxed) });
+    statistics.maxLatency = duration_cast<microseconds>(clock::duration{ _maxLatency.load(std::memory_order_relaxed) });
+    return statistics;
 }
 
 void RenderThread::NotifyPaint()
 {
+    // Remember when the next frame was first asked for, to measure how long it takes us to paint it.
+    if (_requestTime.load(std::memory_order_relaxed) == 0)
+    {
+        clock::rep expected = 0;
+        _requestTime.compare_exchange_strong(expected, clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
     if (_fWaiting.load(std::memory_order_acquire))
     {
         SetEvent(_hEvent);
@@ -17,6 +17,8 @@ Author(s):
 #include "../inc/IRenderer.hpp"
 #include "../inc/IRenderThread.hpp"
 
+#include <chrono>
+
 namespace Microsoft::Console::Render
 {
     class RenderThread final : public IRenderThread
@@ -32,12 +34,26 @@ namespace Microsoft::Console::Render
         void EnablePainting() override;
         void DisablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
+        FrameStatistics GetFrameStatistics() const noexcept override;
 
     private:
+        using clock = std::chrono::steady_clock;
+
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
 
-        static DWORD const s_FrameLimitMilliseconds = 8;
+        void _WaitForFrameDeadline();
+        clock::duration _GetFrameDelay(const clock::time_point now) noexcept;
+        void _RecordFrame(const clock::time_point paintStart, const clock::time_point paintEnd, const clock::rep requestTime) noexcept;
+
+        // A frame that's requested after we've been idle for this long is painted right away:
+        // it's most likely the echo of user input. Requests that keep coming in faster
+        // than that are paced, so that a flood of output gets coalesced into fewer frames.
+        static constexpr clock::duration s_InteractiveIdleTime = std::chrono::milliseconds(16);
+        // Paced frames start at least this far apart, and at least twice as far apart as
+        // painting takes, which leaves the console lock to the output at least half the time.
+        static constexpr clock::duration s_MinimumFrameInterval = std::chrono::milliseconds(8);
+        static constexpr clock::duration s_MaximumFrameInterval = std::chrono::milliseconds(50);
 
         HANDLE _hThread;
         HANDLE _hEvent;
@@ -50,5 +66,25 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+
+        // When the next frame was first requested, as a count of clock ticks. 0 if it hasn't been yet.
+        std::atomic<clock::rep> _requestTime;
+
+        clock::time_point _lastPaintStart;
+        clock::time_point _lastPaintEnd;
+        // A moving average of how long painting a frame takes.
+        clock::duration _averagePaintDuration;
+
+        std::atomic<uint64_t> _frames;
+        std::atomic<uint64_t> _immediateFrames;
+        std::atomic<clock::rep> _lastPaintDuration;
+        std::atomic<clock::rep> _lastLatency;
+        std::atomic<clock::rep> _maxLatency;
+        // Whether the frame being painted was painted right away, rather than paced.
+        bool _immediateFrame;
+
+#ifdef UNIT_TESTING
+        friend class RenderThreadTests;
+#endif
     };
 }
@@ -37,28 +37,25 @@ namespace Microsoft::Console::Render
         const Microsoft::Console::Types::Viewport region;
     };
 
-    class IRenderData : public Microsoft::Console::Types::IBaseData
+    // The part of the render data that's needed while the cells of a frame are painted.
+    // This is all the engines get to see, so that a frame can be painted from a copy of it.
+    class IRenderFrameData
     {
     public:
-        ~IRenderData() = 0;
-        IRenderData(const IRenderData&) = default;
-        IRenderData(IRenderData&&) = default;
-        IRenderData& operator=(const IRenderData&) = default;
-        IRenderData& operator=(IRenderData&&) = default;
+        virtual ~IRenderFrameData() = 0;
 
+    protected:
+        IRenderFrameData() = default;
+        IRenderFrameData(const IRenderFrameData&) = default;
+        IRenderFrameData(IRenderFrameData&&) = default;
+        IRenderFrameData& operator=(const IRenderFrameData&) = default;
+        IRenderFrameData& operator=(IRenderFrameData&&) = default;
+
+    public:
         virtual const TextAttribute GetDefaultBrushColors() noexcept = 0;
 
         virtual std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept = 0;
 
-        virtual COORD GetCursorPosition() const noexcept = 0;
-        virtual bool IsCursorVisible() const noexcept = 0;
-        virtual bool IsCursorOn() const noexcept = 0;
-        virtual ULONG GetCursorHeight() const noexcept = 0;
-        virtual CursorType GetCursorStyle() const noexcept = 0;
-        virtual ULONG GetCursorPixelWidth() const noexcept = 0;
-        virtual COLORREF GetCursorColor() const noexcept = 0;
-        virtual bool IsCursorDoubleWidth() const = 0;
-
         virtual bool IsScreenReversed() const noexcept = 0;
 
         virtual const std::vector<RenderOverlay> GetOverlays() const noexcept = 0;
@@ -70,6 +67,28 @@ namespace Microsoft::Console::Render
         virtual const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept = 0;
 
         virtual const std::vector<size_t> GetPatternId(const COORD location) const noexcept = 0;
+    };
+
+    // See docs/virtual-dtors.md for an explanation of why this is weird.
+    inline IRenderFrameData::~IRenderFrameData() {}
+
+    class IRenderData : public Microsoft::Console::Types::IBaseData, public IRenderFrameData
+    {
+    public:
+        ~IRenderData() = 0;
+        IRenderData(const IRenderData&) = default;
+        IRenderData(IRenderData&&) = default;
+        IRenderData& operator=(const IRenderData&) = default;
+        IRenderData& operator=(IRenderData&&) = default;
+
+        virtual COORD GetCursorPosition() const noexcept = 0;
+        virtual bool IsCursorVisible() const noexcept = 0;
+        virtual bool IsCursorOn() const noexcept = 0;
+        virtual ULONG GetCursorHeight() const noexcept = 0;
+        virtual CursorType GetCursorStyle() const noexcept = 0;
+        virtual ULONG GetCursorPixelWidth() const noexcept = 0;
+        virtual COLORREF GetCursorColor() const noexcept = 0;
+        virtual bool IsCursorDoubleWidth() const = 0;
 
     protected:
         IRenderData() = default;
@@ -13,8 +13,22 @@ Author(s):
 --*/
 
 #pragma once
+
+#include <chrono>
+
 namespace Microsoft::Console::Render
 {
+    // Timing of the frames painted so far. The latency of a frame is the time
+    // from the first request for it (e.g. the echo of a keystroke) until it was painted.
+    struct FrameStatistics
+    {
+        uint64_t frames;
+        uint64_t immediateFrames;
+        std::chrono::microseconds lastPaintDuration;
+        std::chrono::microseconds lastLatency;
+        std::chrono::microseconds maxLatency;
+    };
+
     class IRenderThread
     {
     public:
@@ -28,6 +42,7 @@ namespace Microsoft::Console::Render
         virtual void EnablePainting() = 0;
         virtual void DisablePainting() = 0;
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
+        virtual FrameStatistics GetFrameStatistics() const noexcept = 0;
 
     protected:
         IRenderThread() = default;
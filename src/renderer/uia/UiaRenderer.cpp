@@ -368,7 +368,7 @@ CATCH_RETURN();
 // Return Value:
 // - S_FALSE since we do nothing
 [[nodiscard]] HRESULT UiaEngine::UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/,
-                                                      const gsl::not_null<IRenderData*> /*pData*/,
+                                                      const gsl::not_null<IRenderFrameData*> /*pData*/,
                                                       const bool /*isSettingDefaultBrushes*/) noexcept
 {
     return S_FALSE;
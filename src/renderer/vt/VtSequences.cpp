@@ -81,8 +81,7 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_EraseCharacter(const short chars) noexcept
 {
-    static const std::string format = "\x1b[%dX";
-    return _WriteFormattedString(&format, chars);
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}X"), chars);
 }
 
 // Method Description:
@@ -93,8 +92,7 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_CursorForward(const short chars) noexcept
 {
-    static const std::string format = "\x1b[%dC";
-    return _WriteFormattedString(&format, chars);
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}C"), chars);
 }
 
 // Method Description:
@@ -132,9 +130,7 @@ using namespace Microsoft::Console::Render;
     {
         return _Write(fInsertLine ? "\x1b[L" : "\x1b[M");
     }
-    const std::string format = fInsertLine ? "\x1b[%dL" : "\x1b[%dM";
-
-    return _WriteFormattedString(&format, sLines);
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}{}"), sLines, fInsertLine ? 'L' : 'M');
 }
 
 // Method Description:
@@ -171,14 +167,12 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_CursorPosition(const COORD coord) noexcept
 {
-    static const std::string cursorFormat = "\x1b[%d;%dH";
-
     // VT coords start at 1,1
     COORD coordVt = coord;
     coordVt.X++;
     coordVt.Y++;
 
-    return _WriteFormattedString(&cursorFormat, coordVt.Y, coordVt.X);
+    return _WriteFormatted(FMT_COMPILE("\x1b[{};{}H"), coordVt.Y, coordVt.X);
 }
 
 // Method Description:
@@ -203,18 +197,15 @@ using namespace Microsoft::Console::Render;
     return _Write("\x1b[m");
 }
 
-// Method Description:
-// - Formats and writes a sequence to change the current text attributes.
+// Routine Description:
+// - Calculates the SGR parameter for a color from the 16-color table.
 // Arguments:
 // - wAttr: Windows color table index to emit as a VT sequence
-// - fIsForeground: true if we should emit the foreground sequence, false for background
+// - fIsForeground: true for the foreground parameter, false for background
 // Return Value:
-// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT VtEngine::_SetGraphicsRendition16Color(const WORD wAttr,
-                                                             const bool fIsForeground) noexcept
+// - The SGR parameter selecting the color.
+static int SgrParameterFor16Color(const WORD wAttr, const bool fIsForeground) noexcept
 {
-    static const std::string fmt = "\x1b[%dm";
-
     // Always check using the foreground flags, because the bg flags constants
     //  are a higher byte
     // Foreground sequences are in [30,37] U [90,97]
@@ -227,69 +218,82 @@ using namespace Microsoft::Console::Render;
     //      terminals display the bright color when displaying bolded text.
     // By specifying the boldness and brightness separately, we'll make sure the
     //      terminal has an accurate representation of our buffer.
-    const int vtIndex = 30 +
-                        (fIsForeground ? 0 : 10) +
-                        ((WI_IsFlagSet(wAttr, FOREGROUND_INTENSITY)) ? 60 : 0) +
-                        (WI_IsFlagSet(wAttr, FOREGROUND_RED) ? 1 : 0) +
-                        (WI_IsFlagSet(wAttr, FOREGROUND_GREEN) ? 2 : 0) +
-                        (WI_IsFlagSet(wAttr, FOREGROUND_BLUE) ? 4 : 0);
-
-    return _WriteFormattedString(&fmt, vtIndex);
+    return 30 +
+           (fIsForeground ? 0 : 10) +
+           ((WI_IsFlagSet(wAttr, FOREGROUND_INTENSITY)) ? 60 : 0) +
+           (WI_IsFlagSet(wAttr, FOREGROUND_RED) ? 1 : 0) +
+           (WI_IsFlagSet(wAttr, FOREGROUND_GREEN) ? 2 : 0) +
+           (WI_IsFlagSet(wAttr, FOREGROUND_BLUE) ? 4 : 0);
 }
 
 // Method Description:
-// - Formats and writes a sequence to change the current text attributes to an
-//      indexed color from the 256-color table.
+// - Formats and writes a sequence to change the current text attributes.
 // Arguments:
 // - wAttr: Windows color table index to emit as a VT sequence
 // - fIsForeground: true if we should emit the foreground sequence, false for background
 // Return Value:
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT VtEngine::_SetGraphicsRendition256Color(const WORD index,
-                                                              const bool fIsForeground) noexcept
+[[nodiscard]] HRESULT VtEngine::_SetGraphicsRendition16Color(const WORD wAttr,
+                                                             const bool fIsForeground) noexcept
 {
-    const std::string fmt = fIsForeground ?
-                                "\x1b[38;5;%dm" :
-                                "\x1b[48;5;%dm";
-
-    return _WriteFormattedString(&fmt, ::Xterm256ToWindowsIndex(index));
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}m"), SgrParameterFor16Color(wAttr, fIsForeground));
 }
 
 // Method Description:
-// - Formats and writes a sequence to change the current text attributes to an
-//      RGB color.
+// - Formats and writes a single sequence to change the foreground and/or the
+//      background color of the current text attributes. If both change, their
+//      parameters are merged, like in "\x1b[38;2;1;2;3;48;5;4m".
 // Arguments:
-// - color: The color to emit a VT sequence for
-// - fIsForeground: true if we should emit the foreground sequence, false for background
+// - fg: the foreground color to emit, if any
+// - bg: the background color to emit, if any
 // Return Value:
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT VtEngine::_SetGraphicsRenditionRGBColor(const COLORREF color,
-                                                              const bool fIsForeground) noexcept
+[[nodiscard]] HRESULT VtEngine::_SetGraphicsRenditionColors(const std::optional<TextColor> fg,
+                                                            const std::optional<TextColor> bg) noexcept
+try
 {
-    const std::string fmt = fIsForeground ?
-                                "\x1b[38;2;%d;%d;%dm" :
-                                "\x1b[48;2;%d;%d;%dm";
+    fmt::basic_memory_buffer<char, 64> buffer;
+    const auto out = std::back_inserter(buffer);
 
-    DWORD const r = GetRValue(color);
-    DWORD const g = GetGValue(color);
-    DWORD const b = GetBValue(color);
+    const auto appendColor = [&](const TextColor color, const bool fIsForeground) {
+        if (color.IsDefault())
+        {
+            fmt::format_to(out, FMT_COMPILE("{}"), fIsForeground ? 39 : 49);
+        }
+        else if (color.IsIndex16())
+        {
+            fmt::format_to(out, FMT_COMPILE("{}"), SgrParameterFor16Color(color.GetIndex(), fIsForeground));
+        }
+        else if (color.IsIndex256())
+        {
+            fmt::format_to(out, FMT_COMPILE("{};5;{}"), fIsForeground ? 38 : 48, ::Xterm256ToWindowsIndex(color.GetIndex()));
+        }
+        else if (color.IsRgb())
+        {
+            const auto rgb = color.GetRGB();
+            fmt::format_to(out, FMT_COMPILE("{};2;{};{};{}"), fIsForeground ? 38 : 48, GetRValue(rgb), GetGValue(rgb), GetBValue(rgb));
+        }
+    };
 
-    return _WriteFormattedString(&fmt, r, g, b);
-}
-
-// Method Description:
-// - Formats and writes a sequence to change the current text attributes to the
-//      default foreground or background. Does not affect the boldness of text.
-// Arguments:
-// - fIsForeground: true if we should emit the foreground sequence, false for background
-// Return Value:
-// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT VtEngine::_SetGraphicsRenditionDefaultColor(const bool fIsForeground) noexcept
-{
-    const std::string_view fmt = fIsForeground ? ("\x1b[39m") : ("\x1b[49m");
+    buffer.push_back('\x1b');
+    buffer.push_back('[');
+    if (fg)
+    {
+        appendColor(*fg, true);
+    }
+    if (fg && bg)
+    {
+        buffer.push_back(';');
+    }
+    if (bg)
+    {
+        appendColor(*bg, false);
+    }
+    buffer.push_back('m');
 
-    return _Write(fmt);
+    return _Write({ buffer.data(), buffer.size() });
 }
+CATCH_RETURN();
 
 // Method Description:
 // - Formats and writes a sequence to change the terminal's window size.
@@ -300,13 +304,12 @@ using namespace Microsoft::Console::Render;
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT VtEngine::_ResizeWindow(const short sWidth, const short sHeight) noexcept
 {
-    static const std::string resizeFormat = "\x1b[8;%d;%dt";
     if (sWidth < 0 || sHeight < 0)
     {
         return E_INVALIDARG;
     }
 
-    return _WriteFormattedString(&resizeFormat, sHeight, sWidth);
+    return _WriteFormatted(FMT_COMPILE("\x1b[8;{};{}t"), sHeight, sWidth);
 }
 
 // Method Description:
@@ -25,7 +25,7 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
 // Return Value:
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT Xterm256Engine::UpdateDrawingBrushes(const TextAttribute& textAttributes,
-                                                           const gsl::not_null<IRenderData*> pData,
+                                                           const gsl::not_null<IRenderFrameData*> pData,
                                                            const bool /*isSettingDefaultBrushes*/) noexcept
 {
     RETURN_IF_FAILED(VtEngine::_RgbUpdateDrawingBrushes(textAttributes));
@@ -139,7 +139,7 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
 // Return Value:
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 HRESULT Microsoft::Console::Render::Xterm256Engine::_UpdateHyperlinkAttr(const TextAttribute& textAttributes,
-                                                                         const gsl::not_null<IRenderData*> pData) noexcept
+                                                                         const gsl::not_null<IRenderFrameData*> pData) noexcept
 {
     if (textAttributes.GetHyperlinkId() != _lastTextAttributes.GetHyperlinkId())
     {
@@ -29,7 +29,7 @@ namespace Microsoft::Console::Render
         virtual ~Xterm256Engine() override = default;
 
         [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes,
-                                                   const gsl::not_null<IRenderData*> pData,
+                                                   const gsl::not_null<IRenderFrameData*> pData,
                                                    const bool isSettingDefaultBrushes) noexcept override;
 
         [[nodiscard]] HRESULT ManuallyClearScrollback() noexcept override;
@@ -37,7 +37,7 @@ namespace Microsoft::Console::Render
     private:
         [[nodiscard]] HRESULT _UpdateExtendedAttrs(const TextAttribute& textAttributes) noexcept;
         [[nodiscard]] HRESULT _UpdateHyperlinkAttr(const TextAttribute& textAttributes,
-                                                   const gsl::not_null<IRenderData*> pData) noexcept;
+                                                   const gsl::not_null<IRenderFrameData*> pData) noexcept;
 
 #ifdef UNIT_TESTING
         friend class VtRendererTest;
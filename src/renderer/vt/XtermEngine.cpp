@@ -142,7 +142,7 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
 // Return Value:
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT XtermEngine::UpdateDrawingBrushes(const TextAttribute& textAttributes,
-                                                        const gsl::not_null<IRenderData*> /*pData*/,
+                                                        const gsl::not_null<IRenderFrameData*> /*pData*/,
                                                         const bool /*isSettingDefaultBrushes*/) noexcept
 {
     // The base xterm mode only knows about 16 colors
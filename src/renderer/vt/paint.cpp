@@ -210,45 +210,14 @@ using namespace Microsoft::Console::Types;
         lastBg = {};
     }
 
-    if (fg != lastFg)
+    // If both colors changed, they're emitted together in a single sequence.
+    const auto fgChanged = fg != lastFg;
+    const auto bgChanged = bg != lastBg;
+    if (fgChanged || bgChanged)
     {
-        if (fg.IsDefault())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionDefaultColor(true));
-        }
-        else if (fg.IsIndex16())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition16Color(fg.GetIndex(), true));
-        }
-        else if (fg.IsIndex256())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition256Color(fg.GetIndex(), true));
-        }
-        else if (fg.IsRgb())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionRGBColor(fg.GetRGB(), true));
-        }
+        RETURN_IF_FAILED(_SetGraphicsRenditionColors(fgChanged ? std::optional{ fg } : std::nullopt,
+                                                     bgChanged ? std::optional{ bg } : std::nullopt));
         _lastTextAttributes.SetForeground(fg);
-    }
-
-    if (bg != lastBg)
-    {
-        if (bg.IsDefault())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionDefaultColor(false));
-        }
-        else if (bg.IsIndex16())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition16Color(bg.GetIndex(), false));
-        }
-        else if (bg.IsIndex256())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition256Color(bg.GetIndex(), false));
-        }
-        else if (bg.IsRgb())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionRGBColor(bg.GetRGB(), false));
-        }
         _lastTextAttributes.SetBackground(bg);
     }
 
@@ -74,7 +74,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT PaintCursor(const CursorOptions& options) noexcept override;
 
         [[nodiscard]] virtual HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes,
-                                                           const gsl::not_null<IRenderData*> pData,
+                                                           const gsl::not_null<IRenderFrameData*> pData,
                                                            const bool isSettingDefaultBrushes) noexcept = 0;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& pfiFontInfoDesired,
                                          _Out_ FontInfo& pfiFontInfo) noexcept override;
@@ -112,7 +112,6 @@ namespace Microsoft::Console::Render
         wil::unique_hfile _hFile;
         std::string _buffer;
 
-        std::string _formatBuffer;
         std::string _conversionBuffer;
 
         TextAttribute _lastTextAttributes;
@@ -154,7 +153,26 @@ namespace Microsoft::Console::Render
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
-        [[nodiscard]] HRESULT _WriteFormattedString(const std::string* const pFormat, ...) noexcept;
+
+        // Method Description:
+        // - Formats a sequence and writes it. The format string must be compiled
+        //      with FMT_COMPILE and the sequence is built on the stack, so
+        //      formatting involves neither format string parsing nor allocations.
+        // Arguments:
+        // - format: the FMT_COMPILE'd format string of the sequence
+        // - args: the arguments to format the sequence with
+        // Return Value:
+        // - S_OK or suitable HRESULT error from formatting or writing pipe.
+        template<typename S, typename... Args>
+        [[nodiscard]] HRESULT _WriteFormatted(const S& format, Args&&... args) noexcept
+        try
+        {
+            fmt::basic_memory_buffer<char, 64> buffer;
+            fmt::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+            return _Write({ buffer.data(), buffer.size() });
+        }
+        CATCH_RETURN();
+
         [[nodiscard]] HRESULT _Flush() noexcept;
 
         void _OrRect(_Inout_ SMALL_RECT* const pRectExisting, const SMALL_RECT* const pRectToOr) const;
@@ -177,11 +195,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _ChangeTitle(const std::string& title) noexcept;
         [[nodiscard]] HRESULT _SetGraphicsRendition16Color(const WORD wAttr,
                                                            const bool fIsForeground) noexcept;
-        [[nodiscard]] HRESULT _SetGraphicsRendition256Color(const WORD index,
-                                                            const bool fIsForeground) noexcept;
-        [[nodiscard]] HRESULT _SetGraphicsRenditionRGBColor(const COLORREF color,
-                                                            const bool fIsForeground) noexcept;
-        [[nodiscard]] HRESULT _SetGraphicsRenditionDefaultColor(const bool fIsForeground) noexcept;
+        [[nodiscard]] HRESULT _SetGraphicsRenditionColors(const std::optional<TextColor> fg,
+                                                          const std::optional<TextColor> bg) noexcept;
 
         [[nodiscard]] HRESULT _SetGraphicsDefault() noexcept;
 
@@ -306,7 +306,7 @@ bool WddmConEngine::IsInitialized()
 }
 
 [[nodiscard]] HRESULT WddmConEngine::UpdateDrawingBrushes(const TextAttribute& textAttributes,
-                                                          const gsl::not_null<IRenderData*> /*pData*/,
+                                                          const gsl::not_null<IRenderFrameData*> /*pData*/,
                                                           bool const /*isSettingDefaultBrushes*/) noexcept
 {
     _currentLegacyColorAttribute = textAttributes.GetLegacyAttributes();
@@ -6,7 +6,6 @@
 #include "InteractDispatch.hpp"
 #include "DispatchCommon.hpp"
 #include "conGetSet.hpp"
-#include "../../interactivity/inc/EventSynthesis.hpp"
 #include "../../types/inc/Viewport.hpp"
 #include "../../inc/unicode.hpp"
 
@@ -27,13 +26,13 @@ InteractDispatch::InteractDispatch(std::unique_ptr<ConGetSet> pConApi) :
 //      interrupt in the client, but instead write a Ctrl+C to the input buffer
 //      to be read by the client.
 // Arguments:
-// - inputEvents: a collection of IInputEvents
+// - records: a collection of input records
 // Return Value:
 // True if handled successfully. False otherwise.
-bool InteractDispatch::WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
+bool InteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> records)
 {
     size_t written = 0;
-    return _pConApi->PrivateWriteConsoleInputW(inputEvents, written);
+    return _pConApi->PrivateWriteConsoleInputW(records, written);
 }
 
 // Method Description:
@@ -51,8 +50,9 @@ bool InteractDispatch::WriteCtrlKey(const KeyEvent& event)
 }
 
 // Method Description:
-// - Writes a string of input to the host. The string is converted to keystrokes
-//      that will faithfully represent the input by CharToKeyEvents.
+// - Writes a string of input to the host. The host stores the string as it is, and
+//      only converts it into the keystrokes that faithfully represent the input
+//      (see CharToKeyEvents) once a client reads them as input records.
 // Arguments:
 // - string : a string to write to the console.
 // Return Value:
@@ -68,18 +68,7 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
     bool success = _pConApi->GetConsoleOutputCP(codepage);
     if (success)
     {
-        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
-
-        for (const auto& wch : string)
-        {
-            std::deque<std::unique_ptr<KeyEvent>> convertedEvents = Microsoft::Console::Interactivity::CharToKeyEvents(wch, codepage);
-
-            std::move(convertedEvents.begin(),
-                      convertedEvents.end(),
-                      std::back_inserter(keyEvents));
-        }
-
-        success = WriteInput(keyEvents);
+        success = _pConApi->PrivateWriteConsoleInputString(string, codepage);
     }
     return success;
 }
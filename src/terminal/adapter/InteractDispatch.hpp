@@ -25,7 +25,7 @@ namespace Microsoft::Console::VirtualTerminal
     public:
         InteractDispatch(std::unique_ptr<ConGetSet> pConApi);
 
-        bool WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
+        bool WriteInput(const gsl::span<const INPUT_RECORD> records) override;
         bool WriteCtrlKey(const KeyEvent& event) override;
         bool WriteString(const std::wstring_view string) override;
         bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
@@ -178,18 +178,19 @@ bool AdaptDispatch::_CursorMovePosition(const Offset rowOffset, const Offset col
     bool success = true;
 
     // First retrieve some information about the buffer
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    COORD cursorPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    success = (_pConApi->MoveToBottom() && _pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+    success = (_pConApi->MoveToBottom() && _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize));
 
     if (success)
     {
         // Calculate the viewport boundaries as inclusive values.
-        // srWindow is exclusive so we need to subtract 1 from the bottom.
-        const int viewportTop = csbiex.srWindow.Top;
-        const int viewportBottom = csbiex.srWindow.Bottom - 1;
+        // The viewport is exclusive so we need to subtract 1 from the bottom.
+        const int viewportTop = viewport.Top;
+        const int viewportBottom = viewport.Bottom - 1;
 
         // Calculate the absolute margins of the scrolling area.
         const int topMargin = viewportTop + _scrollMargins.Top;
@@ -198,8 +199,8 @@ bool AdaptDispatch::_CursorMovePosition(const Offset rowOffset, const Offset col
 
         // For relative movement, the given offsets will be relative to
         // the current cursor position.
-        int row = csbiex.dwCursorPosition.Y;
-        int col = csbiex.dwCursorPosition.X;
+        int row = cursorPosition.Y;
+        int col = cursorPosition.X;
 
         // But if the row is absolute, it will be relative to the top of the
         // viewport, or the top margin, depending on the origin mode.
@@ -219,7 +220,7 @@ bool AdaptDispatch::_CursorMovePosition(const Offset rowOffset, const Offset col
         // The row is constrained within the viewport's vertical boundaries,
         // while the column is constrained by the buffer width.
         row = std::clamp(row + rowOffset.Value, viewportTop, viewportBottom);
-        col = std::clamp(col + colOffset.Value, 0, csbiex.dwSize.X - 1);
+        col = std::clamp(col + colOffset.Value, 0, bufferSize.X - 1);
 
         // If the operation needs to be clamped inside the margins, or the origin
         // mode is relative (which always requires margin clamping), then the row
@@ -234,11 +235,11 @@ bool AdaptDispatch::_CursorMovePosition(const Offset rowOffset, const Offset col
             // to the bottom margin. See
             // ScreenBufferTests::CursorUpDownOutsideMargins for a test of that
             // behavior.
-            if (csbiex.dwCursorPosition.Y >= topMargin)
+            if (cursorPosition.Y >= topMargin)
             {
                 row = std::max(row, topMargin);
             }
-            if (csbiex.dwCursorPosition.Y <= bottomMargin)
+            if (cursorPosition.Y <= bottomMargin)
             {
                 row = std::min(row, bottomMargin);
             }
@@ -321,11 +322,12 @@ bool AdaptDispatch::CursorPosition(const size_t line, const size_t column)
 bool AdaptDispatch::CursorSaveState()
 {
     // First retrieve some information about the buffer
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    COORD cursorPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool success = (_pConApi->MoveToBottom() && _pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+    bool success = (_pConApi->MoveToBottom() && _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize));
 
     TextAttribute attributes;
     success = success && (_pConApi->PrivateGetTextAttributes(attributes));
@@ -334,8 +336,8 @@ bool AdaptDispatch::CursorSaveState()
     {
         // The cursor is given to us by the API as relative to the whole buffer.
         // But in VT speak, the cursor row should be relative to the current viewport top.
-        COORD coordCursor = csbiex.dwCursorPosition;
-        coordCursor.Y -= csbiex.srWindow.Top;
+        COORD coordCursor = cursorPosition;
+        coordCursor.Y -= viewport.Top;
 
         // VT is also 1 based, not 0 based, so correct by 1.
         auto& savedCursorState = _savedCursorState.at(_usingAltBuffer);
@@ -422,15 +424,15 @@ bool AdaptDispatch::_InsertDeleteHelper(const size_t count, const bool isInsert)
     SHORT distance;
     RETURN_BOOL_IF_FALSE(SUCCEEDED(SizeTToShort(count, &distance)));
 
-    // get current cursor, attributes
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    // get current cursor
+    COORD cursor{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
     RETURN_BOOL_IF_FALSE(_pConApi->MoveToBottom());
-    RETURN_BOOL_IF_FALSE(_pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+    RETURN_BOOL_IF_FALSE(_pConApi->PrivateGetCursorAndViewport(cursor, viewport, bufferSize));
 
-    const auto cursor = csbiex.dwCursorPosition;
     // Rectangle to cut out of the existing buffer. This is inclusive.
     SMALL_RECT srScroll;
     srScroll.Left = cursor.X;
@@ -492,13 +494,13 @@ bool AdaptDispatch::DeleteCharacter(const size_t count)
 // - Internal helper to erase one particular line of the buffer. Either from beginning to the cursor, from the cursor to the end, or the entire line.
 // - Used by both erase line (used just once) and by erase screen (used in a loop) to erase a portion of the buffer.
 // Arguments:
-// - csbiex - Pointer to the console screen buffer that we will be erasing (and getting cursor data from within)
+// - cursorPosition - The current cursor position, which the erase is relative to.
 // - eraseType - Enumeration mode of which kind of erase to perform: beginning to cursor, cursor to end, or entire line.
 // - lineId - The line number (array index value, starts at 0) of the line to operate on within the buffer.
 //           - This is not aware of circular buffer. Line 0 is always the top visible line if you scrolled the whole way up the window.
 // Return Value:
 // - True if handled successfully. False otherwise.
-bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX& csbiex,
+bool AdaptDispatch::_EraseSingleLineHelper(const COORD cursorPosition,
                                            const DispatchTypes::EraseType eraseType,
                                            const size_t lineId) const
 {
@@ -517,7 +519,7 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX& c
         coordStartPosition.X = 0; // from beginning and the whole line start from the left most edge of the buffer.
         break;
     case DispatchTypes::EraseType::ToEnd:
-        coordStartPosition.X = csbiex.dwCursorPosition.X; // from the current cursor position (including it)
+        coordStartPosition.X = cursorPosition.X; // from the current cursor position (including it)
         break;
     }
 
@@ -528,7 +530,7 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX& c
     {
     case DispatchTypes::EraseType::FromBeginning:
         // +1 because if cursor were at the left edge, the length would be 0 and we want to paint at least the 1 character the cursor is on.
-        nLength = csbiex.dwCursorPosition.X + 1;
+        nLength = cursorPosition.X + 1;
         break;
     case DispatchTypes::EraseType::ToEnd:
     case DispatchTypes::EraseType::All:
@@ -552,15 +554,14 @@ bool AdaptDispatch::_EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX& c
 // - True if handled successfully. False otherwise.
 bool AdaptDispatch::EraseCharacters(const size_t numChars)
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
-    bool success = _pConApi->GetConsoleScreenBufferInfoEx(csbiex);
+    COORD startPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
+    bool success = _pConApi->PrivateGetCursorAndViewport(startPosition, viewport, bufferSize);
 
     if (success)
     {
-        const COORD startPosition = csbiex.dwCursorPosition;
-
-        const SHORT remainingSpaces = csbiex.dwSize.X - startPosition.X;
+        const SHORT remainingSpaces = bufferSize.X - startPosition.X;
         const size_t actualRemaining = gsl::narrow_cast<size_t>((remainingSpaces < 0) ? 0 : remainingSpaces);
         // erase at max the number of characters remaining in the line from the current position.
         const auto eraseLength = (numChars <= actualRemaining) ? numChars : actualRemaining;
@@ -613,11 +614,12 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         return eraseAllResult && (!isPty);
     }
 
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    COORD cursorPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool success = (_pConApi->MoveToBottom() && _pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+    bool success = (_pConApi->MoveToBottom() && _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize));
 
     if (success)
     {
@@ -629,13 +631,13 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         // the line is double width).
         if (eraseType == DispatchTypes::EraseType::FromBeginning)
         {
-            const auto endRow = csbiex.dwCursorPosition.Y;
-            _pConApi->PrivateResetLineRenditionRange(csbiex.srWindow.Top, endRow);
+            const auto endRow = cursorPosition.Y;
+            _pConApi->PrivateResetLineRenditionRange(viewport.Top, endRow);
         }
         if (eraseType == DispatchTypes::EraseType::ToEnd)
         {
-            const auto startRow = csbiex.dwCursorPosition.Y + (csbiex.dwCursorPosition.X > 0 ? 1 : 0);
-            _pConApi->PrivateResetLineRenditionRange(startRow, csbiex.srWindow.Bottom);
+            const auto startRow = cursorPosition.Y + (cursorPosition.X > 0 ? 1 : 0);
+            _pConApi->PrivateResetLineRenditionRange(startRow, viewport.Bottom);
         }
 
         // What we need to erase is grouped into 3 types:
@@ -651,9 +653,9 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         if (eraseType == DispatchTypes::EraseType::FromBeginning)
         {
             // For beginning and all, erase all complete lines before (above vertically) from the cursor position.
-            for (SHORT startLine = csbiex.srWindow.Top; startLine < csbiex.dwCursorPosition.Y; startLine++)
+            for (SHORT startLine = viewport.Top; startLine < cursorPosition.Y; startLine++)
             {
-                success = _EraseSingleLineHelper(csbiex, DispatchTypes::EraseType::All, startLine);
+                success = _EraseSingleLineHelper(cursorPosition, DispatchTypes::EraseType::All, startLine);
 
                 if (!success)
                 {
@@ -665,7 +667,7 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         if (success)
         {
             // 2. Cursor Line
-            success = _EraseSingleLineHelper(csbiex, eraseType, csbiex.dwCursorPosition.Y);
+            success = _EraseSingleLineHelper(cursorPosition, eraseType, cursorPosition.Y);
         }
 
         if (success)
@@ -675,9 +677,9 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
             {
                 // For beginning and all, erase all complete lines after (below vertically) the cursor position.
                 // Remember that the viewport bottom value is 1 beyond the viewable area of the viewport.
-                for (SHORT startLine = csbiex.dwCursorPosition.Y + 1; startLine < csbiex.srWindow.Bottom; startLine++)
+                for (SHORT startLine = cursorPosition.Y + 1; startLine < viewport.Bottom; startLine++)
                 {
-                    success = _EraseSingleLineHelper(csbiex, DispatchTypes::EraseType::All, startLine);
+                    success = _EraseSingleLineHelper(cursorPosition, DispatchTypes::EraseType::All, startLine);
 
                     if (!success)
                     {
@@ -701,13 +703,14 @@ bool AdaptDispatch::EraseInLine(const DispatchTypes::EraseType eraseType)
 {
     RETURN_BOOL_IF_FALSE(eraseType <= DispatchTypes::EraseType::All);
 
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
-    bool success = _pConApi->GetConsoleScreenBufferInfoEx(csbiex);
+    COORD cursorPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
+    bool success = _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize);
 
     if (success)
     {
-        success = _EraseSingleLineHelper(csbiex, eraseType, csbiex.dwCursorPosition.Y);
+        success = _EraseSingleLineHelper(cursorPosition, eraseType, cursorPosition.Y);
     }
 
     return success;
@@ -855,19 +858,20 @@ bool AdaptDispatch::_OperatingStatus() const
 // - True if handled successfully. False otherwise.
 bool AdaptDispatch::_CursorPositionReport() const
 {
-    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    COORD cursorPosition{};
+    SMALL_RECT viewport{};
+    COORD bufferSize{};
     // Make sure to reset the viewport (with MoveToBottom )to where it was
     //      before the user scrolled the console output
-    bool success = (_pConApi->MoveToBottom() && _pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+    bool success = (_pConApi->MoveToBottom() && _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize));
 
     if (success)
     {
         // First pull the cursor position relative to the entire buffer out of the console.
-        COORD coordCursorPos = csbiex.dwCursorPosition;
+        COORD coordCursorPos = cursorPosition;
 
         // Now adjust it for its position in respect to the current viewport top.
-        coordCursorPos.Y -= csbiex.srWindow.Top;
+        coordCursorPos.Y -= viewport.Top;
 
         // NOTE: 1,1 is the top-left corner of the viewport in VT-speak, so add 1.
         coordCursorPos.X++;
@@ -899,19 +903,20 @@ bool AdaptDispatch::_CursorPositionReport() const
 bool AdaptDispatch::_WriteResponse(const std::wstring_view reply) const
 {
     bool success = false;
-    std::deque<std::unique_ptr<IInputEvent>> inEvents;
+    std::vector<INPUT_RECORD> inRecords;
     try
     {
         // generate a paired key down and key up event for every
         // character to be sent into the console's input buffer
+        inRecords.reserve(reply.size() * 2);
         for (const auto& wch : reply)
         {
             // This wasn't from a real keyboard, so we're leaving key/scan codes blank.
             KeyEvent keyEvent{ TRUE, 1, 0, 0, wch, 0 };
 
-            inEvents.push_back(std::make_unique<KeyEvent>(keyEvent));
+            inRecords.push_back(keyEvent.ToInputRecord());
             keyEvent.SetKeyDown(false);
-            inEvents.push_back(std::make_unique<KeyEvent>(keyEvent));
+            inRecords.push_back(keyEvent.ToInputRecord());
         }
     }
     catch (...)
@@ -925,7 +930,7 @@ bool AdaptDispatch::_WriteResponse(const std::wstring_view reply) const
     // to make sure that "response" input is spooled directly into the application.
     // We switched this to an append (vs. a prepend) to fix GH#1637, a bug where two CPR
     // could collide with eachother.
-    success = _pConApi->PrivateWriteConsoleInputW(inEvents, eventsWritten);
+    success = _pConApi->PrivateWriteConsoleInputW(inRecords, eventsWritten);
 
     return success;
 }
@@ -945,12 +950,13 @@ bool AdaptDispatch::_ScrollMovement(const ScrollDirection scrollDirection, const
 
     if (success)
     {
-        // get current cursor
-        CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
-        csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+        // get current viewport
+        COORD cursorPosition{};
+        SMALL_RECT viewport{};
+        COORD bufferSize{};
         // Make sure to reset the viewport (with MoveToBottom )to where it was
         //      before the user scrolled the console output
-        success = (_pConApi->MoveToBottom() && _pConApi->GetConsoleScreenBufferInfoEx(csbiex));
+        success = (_pConApi->MoveToBottom() && _pConApi->PrivateGetCursorAndViewport(cursorPosition, viewport, bufferSize));
 
         if (success)
         {
@@ -959,13 +965,13 @@ bool AdaptDispatch::_ScrollMovement(const ScrollDirection scrollDirection, const
             SMALL_RECT srScreen;
             srScreen.Left = 0;
             srScreen.Right = SHORT_MAX;
-            srScreen.Top = csbiex.srWindow.Top;
-            srScreen.Bottom = csbiex.srWindow.Bottom - 1; // srWindow is exclusive, hence the - 1
+            srScreen.Top = viewport.Top;
+            srScreen.Bottom = viewport.Bottom - 1; // viewport is exclusive, hence the - 1
             // Clip to the DECSTBM margin boundaries
             if (_scrollMargins.Top < _scrollMargins.Bottom)
             {
-                srScreen.Top = csbiex.srWindow.Top + _scrollMargins.Top;
-                srScreen.Bottom = csbiex.srWindow.Top + _scrollMargins.Bottom;
+                srScreen.Top = viewport.Top + _scrollMargins.Top;
+                srScreen.Bottom = viewport.Top + _scrollMargins.Bottom;
             }
 
             // Paste coordinate for cut text above
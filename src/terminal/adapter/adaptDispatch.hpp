@@ -157,7 +157,7 @@ namespace Microsoft::Console::VirtualTerminal
         };
 
         bool _CursorMovePosition(const Offset rowOffset, const Offset colOffset, const bool clampInMargins) const;
-        bool _EraseSingleLineHelper(const CONSOLE_SCREEN_BUFFER_INFOEX& csbiex,
+        bool _EraseSingleLineHelper(const COORD cursorPosition,
                                     const DispatchTypes::EraseType eraseType,
                                     const size_t lineId) const;
         bool _EraseScrollback();
@@ -32,6 +32,7 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool GetConsoleScreenBufferInfoEx(CONSOLE_SCREEN_BUFFER_INFOEX& screenBufferInfo) const = 0;
         virtual bool SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX& screenBufferInfo) = 0;
         virtual bool SetConsoleCursorPosition(const COORD position) = 0;
+        virtual bool PrivateGetCursorAndViewport(COORD& cursorPosition, SMALL_RECT& viewport, COORD& bufferSize) const = 0;
 
         virtual bool PrivateIsVtInputEnabled() const = 0;
 
@@ -42,8 +43,10 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool PrivateResetLineRenditionRange(const size_t startRow, const size_t endRow) = 0;
         virtual SHORT PrivateGetLineWidth(const size_t row) const = 0;
 
-        virtual bool PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
+        virtual bool PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                                size_t& eventsWritten) = 0;
+        virtual bool PrivateWriteConsoleInputString(const std::wstring_view string,
+                                                    const unsigned int codepage) = 0;
         virtual bool SetConsoleWindowInfo(const bool absolute,
                                           const SMALL_RECT& window) = 0;
         virtual bool PrivateSetCursorKeysMode(const bool applicationMode) = 0;
@@ -72,6 +72,19 @@ public:
 
         return _getConsoleScreenBufferInfoExResult;
     }
+    bool PrivateGetCursorAndViewport(COORD& cursorPosition, SMALL_RECT& viewport, COORD& bufferSize) const override
+    {
+        Log::Comment(L"PrivateGetCursorAndViewport MOCK returning data...");
+
+        if (_getConsoleScreenBufferInfoExResult)
+        {
+            cursorPosition = _cursorPos;
+            viewport = _viewport;
+            bufferSize = _bufferSize;
+        }
+
+        return _getConsoleScreenBufferInfoExResult;
+    }
     bool SetConsoleScreenBufferInfoEx(const CONSOLE_SCREEN_BUFFER_INFOEX& sbiex) override
     {
         Log::Comment(L"SetConsoleScreenBufferInfoEx MOCK returning data...");
@@ -244,13 +257,15 @@ public:
         return _bufferSize.X;
     }
 
-    bool PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
+    bool PrivateWriteConsoleInputW(const gsl::span<const INPUT_RECORD> records,
                                    size_t& eventsWritten) override
     {
         Log::Comment(L"PrivateWriteConsoleInputW MOCK called...");
 
         if (_privateWriteConsoleInputWResult)
         {
+            auto events = IInputEvent::Create(records);
+
             // move all the input events we were given into local storage so we can test against them
             Log::Comment(NoThrowString().Format(L"Moving %zu input events into local storage...", events.size()));
 
@@ -269,6 +284,13 @@ public:
         return _privateWriteConsoleInputWResult;
     }
 
+    bool PrivateWriteConsoleInputString(const std::wstring_view /*string*/,
+                                        const unsigned int /*codepage*/) override
+    {
+        Log::Comment(L"PrivateWriteConsoleInputString MOCK called...");
+        return false;
+    }
+
     bool PrivateWriteConsoleControlInput(_In_ KeyEvent key) override
     {
         Log::Comment(L"PrivateWriteConsoleControlInput MOCK called...");
@@ -277,12 +277,13 @@ bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view st
         {
             try
             {
-                std::deque<std::unique_ptr<IInputEvent>> inputEvents;
+                std::vector<INPUT_RECORD> inputRecords;
+                inputRecords.reserve(string.size());
                 for (const auto& wch : string)
                 {
-                    inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, wch, 0));
+                    inputRecords.push_back(KeyEvent{ true, 1ui16, 0ui16, 0ui16, wch, 0 }.ToInputRecord());
                 }
-                return _pDispatch->WriteInput(inputEvents);
+                return _pDispatch->WriteInput(inputRecords);
             }
             catch (...)
             {
@@ -679,9 +680,8 @@ bool InputStateMachineEngine::_WriteSingleKey(const wchar_t wch, const short vke
     // At most 8 records - 2 for each of shift,ctrl,alt up and down, and 2 for the actual key up and down.
     std::vector<INPUT_RECORD> input;
     _GenerateWrappedSequence(wch, vkey, modifierState, input);
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(gsl::make_span(input));
 
-    return _pDispatch->WriteInput(inputEvents);
+    return _pDispatch->WriteInput(input);
 }
 
 // Method Description:
@@ -721,8 +721,7 @@ bool InputStateMachineEngine::_WriteMouseEvent(const size_t column, const size_t
 
     // pack and write input record
     // 1 record - the modifiers don't get their own events
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(gsl::make_span(&rgInput, 1));
-    return _pDispatch->WriteInput(inputEvents);
+    return _pDispatch->WriteInput(gsl::make_span(&rgInput, 1));
 }
 
 // Method Description:
@@ -7,11 +7,18 @@
 
 #include "ascii.hpp"
 
+#if defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#endif
+
 using namespace Microsoft::Console::VirtualTerminal;
+using Microsoft::Console::Types::PerformanceCounter;
+using Microsoft::Console::Types::PerformanceCounters;
 
 //Takes ownership of the pEngine.
 StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine) :
     _engine(std::move(engine)),
+    _performanceCounters(nullptr),
     _state(VTStates::Ground),
     _trace(Microsoft::Console::VirtualTerminal::ParserTracing()),
     _isInAnsiMode(true),
@@ -29,6 +36,28 @@ void StateMachine::SetAnsiMode(bool ansiMode) noexcept
     _isInAnsiMode = ansiMode;
 }
 
+// Routine Description:
+// - Sets the counters the parser should count its work into.
+// Arguments:
+// - counters - the counters of the terminal that owns this parser. May be null,
+//              in which case nothing is counted.
+// Return Value:
+// - <none>
+void StateMachine::SetPerformanceCounters(PerformanceCounters* const counters) noexcept
+{
+    _performanceCounters = counters;
+}
+
+// Routine Description:
+// - Adds to one of the performance counters, if we've been given any.
+void StateMachine::_Count(const PerformanceCounter counter, const uint64_t value) noexcept
+{
+    if (_performanceCounters)
+    {
+        _performanceCounters->Add(counter, value);
+    }
+}
+
 const IStateMachineEngine& StateMachine::Engine() const noexcept
 {
     return *_engine;
@@ -374,6 +403,64 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 
 #pragma warning(pop)
 
+// Routine Description:
+// - Finds the next character that is actionable from the ground state (see
+//   _isActionableFromGround), starting at the given offset. On x86/x64 the
+//   printable characters are skipped 16 code units at a time using SSE2.
+// Arguments:
+// - string - The string to scan.
+// - offset - The index to start scanning at.
+// Return Value:
+// - The index of the next actionable character, or string.size() if there is none.
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. We're scanning raw memory on purpose.
+#pragma warning(disable : 26490) // Don't use reinterpret_cast. Required to load the string into SSE registers.
+static size_t _findNextActionableFromGround(const std::wstring_view string, size_t offset) noexcept
+{
+    const auto data = string.data();
+    const auto size = string.size();
+
+#if defined(_M_X64) || defined(_M_IX86)
+    // Actionable characters are either <= US or in the DEL..0x9F range (DEL
+    // and the C1 controls). SSE2 only has signed 16-bit comparisons, so both
+    // range checks use saturating subtraction instead: a <= b iff subs(a, b) == 0.
+    const auto lastC0 = _mm_set1_epi16(AsciiChars::US);
+    const auto del = _mm_set1_epi16(AsciiChars::DEL);
+    const auto delToLastC1 = _mm_set1_epi16(0x9F - AsciiChars::DEL);
+    const auto zero = _mm_setzero_si128();
+
+    const auto actionableMask = [&](const __m128i chars) noexcept {
+        const auto isC0 = _mm_cmpeq_epi16(_mm_subs_epu16(chars, lastC0), zero);
+        const auto isDelOrC1 = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, del), delToLastC1), zero);
+        return static_cast<unsigned long>(_mm_movemask_epi8(_mm_or_si128(isC0, isDelOrC1)));
+    };
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + 8));
+        const auto mask = actionableMask(lo) | (actionableMask(hi) << 16);
+        if (mask != 0)
+        {
+            // The mask has 2 bits per wchar_t, so halve the bit index.
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return offset + index / 2;
+        }
+    }
+#endif
+
+    for (; offset < size; ++offset)
+    {
+        if (_isActionableFromGround(data[offset]))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+#pragma warning(pop)
+
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should immediately respond to a C0 control character.
 // Arguments:
@@ -383,6 +470,7 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 void StateMachine::_ActionExecute(const wchar_t wch)
 {
     _trace.TraceOnExecute(wch);
+    _Count(PerformanceCounter::ExecutedControls);
     const bool success = _engine->ActionExecute(wch);
 
     // Trace the result.
@@ -400,6 +488,7 @@ void StateMachine::_ActionExecute(const wchar_t wch)
 void StateMachine::_ActionExecuteFromEscape(const wchar_t wch)
 {
     _trace.TraceOnExecuteFromEscape(wch);
+    _Count(PerformanceCounter::ExecutedControls);
 
     const bool success = _engine->ActionExecuteFromEscape(wch);
 
@@ -433,6 +522,7 @@ void StateMachine::_ActionPrint(const wchar_t wch)
 void StateMachine::_ActionEscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"EscDispatch");
+    _Count(PerformanceCounter::EscapeSequences);
 
     const bool success = _engine->ActionEscDispatch(_identifier.Finalize(wch));
 
@@ -456,6 +546,7 @@ void StateMachine::_ActionEscDispatch(const wchar_t wch)
 void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Vt52EscDispatch");
+    _Count(PerformanceCounter::Vt52Sequences);
 
     const bool success = _engine->ActionVt52EscDispatch(_identifier.Finalize(wch),
                                                         { _parameters.data(), _parameters.size() });
@@ -480,6 +571,7 @@ void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 void StateMachine::_ActionCsiDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"CsiDispatch");
+    _Count(PerformanceCounter::CsiSequences);
 
     const bool success = _engine->ActionCsiDispatch(_identifier.Finalize(wch),
                                                     { _parameters.data(), _parameters.size() });
@@ -627,6 +719,7 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscDispatch");
+    _Count(PerformanceCounter::OscSequences);
 
     const bool success = _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
 
@@ -650,6 +743,7 @@ void StateMachine::_ActionOscDispatch(const wchar_t wch)
 void StateMachine::_ActionSs3Dispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Ss3Dispatch");
+    _Count(PerformanceCounter::Ss3Sequences);
 
     const bool success = _engine->ActionSs3Dispatch(wch, { _parameters.data(), _parameters.size() });
 
@@ -879,6 +973,7 @@ void StateMachine::_EnterDcsEntry()
 {
     _state = VTStates::DcsEntry;
     _trace.TraceStateChange(L"DcsEntry");
+    _Count(PerformanceCounter::DcsSequences);
     _ActionClear();
 }
 
@@ -1887,6 +1982,17 @@ void StateMachine::ProcessString(const std::wstring_view string)
     size_t start = 0;
     size_t current = start;
 
+    // The counters are only updated once per string, to keep the loops below free of them.
+    size_t printRuns = 0;
+    size_t printRunCharacters = 0;
+    size_t individualCharacters = 0;
+    auto updateCounters = wil::scope_exit([&]() noexcept {
+        _Count(PerformanceCounter::ParsedCharacters, string.size());
+        _Count(PerformanceCounter::PrintRuns, printRuns);
+        _Count(PerformanceCounter::PrintRunCharacters, printRunCharacters);
+        _Count(PerformanceCounter::IndividuallyProcessedCharacters, individualCharacters);
+    });
+
     while (current < string.size())
     {
         // The run will be everything from the start INCLUDING the current one
@@ -1899,6 +2005,7 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // If we're processing characters individually, send it to the state machine.
             ProcessCharacter(string.at(current));
             ++current;
+            ++individualCharacters;
             if (_state == VTStates::Ground) // Then check if we're back at ground. If we are, the next character (pwchCurr)
             { //   is the start of the next run of characters that might be printable.
                 _processingIndividually = false;
@@ -1907,26 +2014,23 @@ void StateMachine::ProcessString(const std::wstring_view string)
         }
         else
         {
-            if (_isActionableFromGround(string.at(current))) // If the current char is the start of an escape sequence, or should be executed in ground state...
+            // Skip over all the printable characters in one go. They all belong to the current run.
+            current = _findNextActionableFromGround(string, current);
+
+            if (current < string.size()) // If we stopped at the start of an escape sequence, or a char that should be executed in ground state...
             {
-                if (!_run.empty())
+                // Only pass through everything before the actionable char.
+                const auto allLeadingUpTo = string.substr(start, current - start);
+                if (!allLeadingUpTo.empty())
                 {
-                    // Because the _run above is composed INCLUDING current, we must
-                    // trim it off here since we just determined it's actionable
-                    // and only pass through everything before it.
-                    const auto allLeadingUpTo = _run.substr(0, _run.size() - 1);
-
                     _engine->ActionPrintString(allLeadingUpTo); // ... print all the chars leading up to it as part of the run...
                     _trace.DispatchPrintRunTrace(allLeadingUpTo);
+                    ++printRuns;
+                    printRunCharacters += allLeadingUpTo.size();
                 }
 
                 _processingIndividually = true; // begin processing future characters individually...
                 start = current;
-                continue;
-            }
-            else
-            {
-                ++current; // Otherwise, add this char to the current run to be printed.
             }
         }
     }
@@ -1942,6 +2046,8 @@ void StateMachine::ProcessString(const std::wstring_view string)
         // print the rest of the characters in the string
         _engine->ActionPrintString(_run);
         _trace.DispatchPrintRunTrace(_run);
+        ++printRuns;
+        printRunCharacters += _run.size();
     }
     else if (_processingIndividually)
     {
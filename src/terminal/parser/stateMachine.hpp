@@ -17,6 +17,7 @@ Abstract:
 #include "IStateMachineEngine.hpp"
 #include "telemetry.hpp"
 #include "tracing.hpp"
+#include "../../types/inc/PerformanceCounters.hpp"
 #include <memory>
 
 namespace Microsoft::Console::VirtualTerminal
@@ -43,6 +44,7 @@ namespace Microsoft::Console::VirtualTerminal
         StateMachine(std::unique_ptr<IStateMachineEngine> engine);
 
         void SetAnsiMode(bool ansiMode) noexcept;
+        void SetPerformanceCounters(Microsoft::Console::Types::PerformanceCounters* const counters) noexcept;
 
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
@@ -55,6 +57,8 @@ namespace Microsoft::Console::VirtualTerminal
         IStateMachineEngine& Engine() noexcept;
 
     private:
+        void _Count(const Microsoft::Console::Types::PerformanceCounter counter, const uint64_t value = 1) noexcept;
+
         void _ActionExecute(const wchar_t wch);
         void _ActionExecuteFromEscape(const wchar_t wch);
         void _ActionPrint(const wchar_t wch);
@@ -146,6 +150,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         std::unique_ptr<IStateMachineEngine> _engine;
 
+        // The counters of the terminal this parser belongs to, if it keeps any.
+        Microsoft::Console::Types::PerformanceCounters* _performanceCounters;
+
         VTStates _state;
 
         bool _isInAnsiMode;
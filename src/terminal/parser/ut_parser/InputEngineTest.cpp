@@ -321,7 +321,7 @@ class Microsoft::Console::VirtualTerminal::TestInteractDispatch final : public I
 public:
     TestInteractDispatch(_In_ std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> pfn,
                          _In_ TestState* testState);
-    virtual bool WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
+    virtual bool WriteInput(const gsl::span<const INPUT_RECORD> records) override;
 
     virtual bool WriteCtrlKey(const KeyEvent& event) override;
     virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
@@ -346,8 +346,9 @@ TestInteractDispatch::TestInteractDispatch(_In_ std::function<void(std::deque<st
 {
 }
 
-bool TestInteractDispatch::WriteInput(_In_ std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
+bool TestInteractDispatch::WriteInput(const gsl::span<const INPUT_RECORD> records)
 {
+    auto inputEvents = IInputEvent::Create(records);
     _pfnWriteInputCallback(inputEvents);
     return true;
 }
@@ -355,9 +356,8 @@ bool TestInteractDispatch::WriteInput(_In_ std::deque<std::unique_ptr<IInputEven
 bool TestInteractDispatch::WriteCtrlKey(const KeyEvent& event)
 {
     VERIFY_IS_TRUE(_testState->_expectSendCtrlC);
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-    inputEvents.push_back(std::make_unique<KeyEvent>(event));
-    return WriteInput(inputEvents);
+    const auto record = event.ToInputRecord();
+    return WriteInput(gsl::make_span(&record, 1));
 }
 
 bool TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipulationType function,
@@ -385,7 +385,8 @@ bool TestInteractDispatch::WriteString(const std::wstring_view string)
                   std::back_inserter(keyEvents));
     }
 
-    return WriteInput(keyEvents);
+    const auto records = IInputEvent::ToInputRecords(keyEvents);
+    return WriteInput(records);
 }
 
 bool TestInteractDispatch::MoveCursor(const size_t row, const size_t col)
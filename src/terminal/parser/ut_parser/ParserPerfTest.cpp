@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include <wextestclass.h>
+#include <chrono>
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "stateMachine.hpp"
+#include "OutputStateMachineEngine.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace Microsoft
+{
+    namespace Console
+    {
+        namespace VirtualTerminal
+        {
+            class ParserPerfTest;
+        }
+    }
+}
+
+namespace
+{
+    // Swallows everything, so that the measurements only cover the parser itself.
+    class NullDispatch final : public TermDispatch
+    {
+    public:
+        void Execute(const wchar_t /*wchControl*/) override
+        {
+        }
+
+        void Print(const wchar_t /*wchPrintable*/) override
+        {
+        }
+
+        void PrintString(const std::wstring_view /*string*/) override
+        {
+        }
+    };
+}
+
+// These aren't pass/fail tests. They feed a few megabytes of typical output
+// through the OutputStateMachineEngine and log the throughput, so that
+// regressions in the parser show up as numbers in the test log.
+class Microsoft::Console::VirtualTerminal::ParserPerfTest final
+{
+    TEST_CLASS(ParserPerfTest);
+
+    TEST_METHOD(PlainTextThroughput);
+    TEST_METHOD(SgrHeavyThroughput);
+    TEST_METHOD(CursorMovementHeavyThroughput);
+
+private:
+    static constexpr size_t s_targetSize = 16 * 1024 * 1024;
+
+    static std::wstring _RepeatUntilTargetSize(const std::wstring_view chunk);
+    static void _MeasureThroughput(const std::wstring_view name, const std::wstring_view payload);
+};
+
+std::wstring ParserPerfTest::_RepeatUntilTargetSize(const std::wstring_view chunk)
+{
+    std::wstring payload;
+    payload.reserve(s_targetSize / sizeof(wchar_t) + chunk.size());
+    while (payload.size() * sizeof(wchar_t) < s_targetSize)
+    {
+        payload.append(chunk);
+    }
+    return payload;
+}
+
+void ParserPerfTest::_MeasureThroughput(const std::wstring_view name, const std::wstring_view payload)
+{
+    StateMachine machine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>()) };
+
+    // Feed the payload in 4K chunks, roughly the size of what a connection
+    // hands to the parser in one go.
+    constexpr size_t chunkSize = 4096;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < payload.size(); offset += chunkSize)
+    {
+        machine.ProcessString(payload.substr(offset, chunkSize));
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto megabytes = payload.size() * sizeof(wchar_t) / (1024.0 * 1024.0);
+    Log::Comment(NoThrowString().Format(L"%.*s: %.2f MB in %.3f ms, %.1f MB/s",
+                                        gsl::narrow_cast<int>(name.size()),
+                                        name.data(),
+                                        megabytes,
+                                        elapsed * 1000.0,
+                                        elapsed > 0 ? megabytes / elapsed : 0.0));
+}
+
+void ParserPerfTest::PlainTextThroughput()
+{
+    const auto payload = _RepeatUntilTargetSize(L"[ 42%] Building CXX object src/CMakeFiles/parser.dir/stateMachine.cpp.obj\r\n");
+    _MeasureThroughput(L"Plain text", payload);
+}
+
+void ParserPerfTest::SgrHeavyThroughput()
+{
+    const auto payload = _RepeatUntilTargetSize(L"\x1b[1;32mok\x1b[m \x1b[38;5;208mwarn\x1b[0m \x1b[38;2;12;34;56;48;5;17mtruecolor\x1b[m\r\n");
+    _MeasureThroughput(L"SGR heavy", payload);
+}
+
+void ParserPerfTest::CursorMovementHeavyThroughput()
+{
+    const auto payload = _RepeatUntilTargetSize(L"\x1b[12;40Hx\x1b[3A\x1b[5Cy\x1b[K\x1b[2;1H\x1b[2Pz\x1b[H");
+    _MeasureThroughput(L"Cursor movement heavy", payload);
+}
@@ -31,11 +31,17 @@ public:
     void ResetTestState()
     {
         printed.clear();
+        executed.clear();
         passedThrough.clear();
         csiParams.clear();
+        escDispatched.clear();
     }
 
-    bool ActionExecute(const wchar_t /* wch */) override { return true; };
+    bool ActionExecute(const wchar_t wch) override
+    {
+        executed += wch;
+        return true;
+    };
     bool ActionExecuteFromEscape(const wchar_t /* wch */) override { return true; };
     bool ActionPrint(const wchar_t /* wch */) override { return true; };
     bool ActionPrintString(const std::wstring_view string) override
@@ -50,7 +56,11 @@ public:
         return true;
     };
 
-    bool ActionEscDispatch(const VTID /* id */) override { return true; };
+    bool ActionEscDispatch(const VTID id) override
+    {
+        escDispatched.push_back(id);
+        return true;
+    };
 
     bool ActionVt52EscDispatch(const VTID /*id*/, const VTParameters /*parameters*/) override { return true; };
 
@@ -107,6 +117,12 @@ public:
 
     // Printed string.
     std::wstring printed;
+
+    // Executed control characters.
+    std::wstring executed;
+
+    // Dispatched escape sequences, including the ones C1 controls stand for.
+    std::vector<VTID> escDispatched;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -128,6 +144,7 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(BulkTextPrintStopsAtControlCharacters);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 };
 
@@ -201,6 +218,37 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::BulkTextPrintStopsAtControlCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The runs are long enough to be scanned in bulk, with the control
+    // characters landing at various offsets within those blocks.
+    const std::wstring a(20, L'a');
+    const std::wstring b(17, L'b');
+    const std::wstring c(3, L'c');
+    const std::wstring d(33, L'd');
+    machine.ProcessString(a + L'\r' + b + L'\x7f' + c + L'\n' + d);
+
+    VERIFY_ARE_EQUAL(a + b + c + d, engine.printed);
+    VERIFY_ARE_EQUAL(L"\r\x7f\n", engine.executed);
+
+    engine.ResetTestState();
+
+    // C1 controls end the run too, and are handled individually. IND and NEL
+    // are dispatched as ESC D and ESC E, after which printing resumes.
+    machine.ProcessString(a + L'\x84' + b + L'\x85' + d);
+
+    VERIFY_ARE_EQUAL(a + b + d, engine.printed);
+    VERIFY_ARE_EQUAL(L"", engine.executed);
+    VERIFY_ARE_EQUAL(2u, engine.escDispatched.size());
+    VERIFY_ARE_EQUAL(static_cast<uint64_t>(VTID("D")), static_cast<uint64_t>(engine.escDispatched.at(0)));
+    VERIFY_ARE_EQUAL(static_cast<uint64_t>(VTID("E")), static_cast<uint64_t>(engine.escDispatched.at(1)));
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
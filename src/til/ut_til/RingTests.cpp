@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RingTests
+{
+    TEST_CLASS(RingTests);
+
+    static void _verifyContents(const std::vector<int>& expected, const til::ring<int>& r)
+    {
+        VERIFY_ARE_EQUAL(expected.size(), r.size());
+
+        auto it = r.begin();
+        for (const auto value : expected)
+        {
+            VERIFY_ARE_EQUAL(value, *it);
+            ++it;
+        }
+        VERIFY_IS_TRUE(it == r.end());
+    }
+
+    TEST_METHOD(Construct)
+    {
+        til::ring<int> r;
+        VERIFY_IS_TRUE(r.empty());
+        VERIFY_ARE_EQUAL(0u, r.size());
+        VERIFY_ARE_EQUAL(0u, r.capacity());
+        VERIFY_IS_TRUE(r.begin() == r.end());
+    }
+
+    TEST_METHOD(PushAndPop)
+    {
+        til::ring<int> r;
+        r.push_back(2);
+        r.push_back(3);
+        r.push_front(1);
+        VERIFY_ARE_EQUAL(3u, r.size());
+        VERIFY_ARE_EQUAL(1, r.front());
+        VERIFY_ARE_EQUAL(3, r.back());
+        _verifyContents({ 1, 2, 3 }, r);
+
+        r.pop_front();
+        _verifyContents({ 2, 3 }, r);
+
+        r.pop_back();
+        _verifyContents({ 2 }, r);
+
+        r.pop_back();
+        VERIFY_IS_TRUE(r.empty());
+    }
+
+    TEST_METHOD(WrapsAroundWithoutGrowing)
+    {
+        til::ring<int> r;
+        r.push_back(0);
+        const auto capacity = r.capacity();
+
+        Log::Comment(L"Cycling through the ring many times over must reuse its buffer.");
+        for (int i = 1; i < gsl::narrow_cast<int>(capacity * 10); ++i)
+        {
+            r.push_back(i);
+            VERIFY_ARE_EQUAL(i - 1, r.front());
+            r.pop_front();
+            VERIFY_ARE_EQUAL(1u, r.size());
+        }
+
+        VERIFY_ARE_EQUAL(capacity, r.capacity());
+    }
+
+    TEST_METHOD(GrowsWhileWrappedAround)
+    {
+        til::ring<int> r;
+        r.push_back(0);
+        const auto capacity = r.capacity();
+
+        Log::Comment(L"Move the head into the middle of the buffer, so that the values wrap around its end.");
+        for (size_t i = 0; i < capacity / 2; ++i)
+        {
+            r.push_back(0);
+            r.pop_front();
+        }
+
+        r.pop_front();
+
+        std::vector<int> expected;
+        for (int i = 0; i < gsl::narrow_cast<int>(capacity * 2); ++i)
+        {
+            r.push_back(i);
+            expected.push_back(i);
+        }
+        r.push_front(-1);
+        expected.insert(expected.begin(), -1);
+
+        VERIFY_IS_GREATER_THAN(r.capacity(), capacity);
+        _verifyContents(expected, r);
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected[i], r[i]);
+        }
+    }
+
+    TEST_METHOD(At)
+    {
+        til::ring<int> r;
+        r.push_back(1);
+        r.push_back(2);
+        VERIFY_ARE_EQUAL(2, r.at(1));
+
+        r.at(0) = 3;
+        VERIFY_ARE_EQUAL(3, r.front());
+
+        auto fn = [&]() {
+            r.at(2);
+        };
+        VERIFY_THROWS(fn(), std::out_of_range);
+    }
+
+    TEST_METHOD(EraseIf)
+    {
+        til::ring<int> r;
+        r.push_back(0);
+        r.pop_front();
+        for (int i = 0; i < 20; ++i)
+        {
+            r.push_back(i);
+        }
+
+        const auto erased = r.erase_if([](const int value) { return value % 3 != 0; });
+        VERIFY_ARE_EQUAL(13u, erased);
+        _verifyContents({ 0, 3, 6, 9, 12, 15, 18 }, r);
+    }
+
+    TEST_METHOD(Swap)
+    {
+        til::ring<int> a;
+        a.push_back(1);
+        til::ring<int> b;
+        b.push_back(2);
+        b.push_back(3);
+
+        a.swap(b);
+        _verifyContents({ 2, 3 }, a);
+        _verifyContents({ 1 }, b);
+    }
+
+    TEST_METHOD(ShrinksOnceEmpty)
+    {
+        til::ring<int> r;
+
+        Log::Comment(L"A small buffer is kept around while the ring is empty.");
+        r.push_back(0);
+        const auto capacity = r.capacity();
+        r.pop_front();
+        VERIFY_IS_TRUE(r.empty());
+        VERIFY_ARE_EQUAL(capacity, r.capacity());
+
+        Log::Comment(L"A buffer that grew large is given back once the last value is removed.");
+        for (int i = 0; i < 5000; ++i)
+        {
+            r.push_back(i);
+        }
+        VERIFY_IS_GREATER_THAN(r.capacity(), capacity);
+
+        r.pop_front();
+        VERIFY_IS_GREATER_THAN(r.capacity(), capacity, L"The buffer must be kept while there are values left.");
+
+        while (r.size() > 1)
+        {
+            r.pop_front();
+        }
+        r.pop_back();
+        VERIFY_IS_TRUE(r.empty());
+        VERIFY_ARE_EQUAL(0u, r.capacity());
+
+        Log::Comment(L"The ring must still be usable afterwards.");
+        r.push_back(1);
+        r.push_front(0);
+        _verifyContents({ 0, 1 }, r);
+
+        Log::Comment(L"Clearing and erasing everything give the buffer back, too.");
+        for (int i = 0; i < 5000; ++i)
+        {
+            r.push_back(i);
+        }
+        r.clear();
+        VERIFY_ARE_EQUAL(0u, r.capacity());
+
+        for (int i = 0; i < 5000; ++i)
+        {
+            r.push_back(i);
+        }
+        VERIFY_ARE_EQUAL(5000u, r.erase_if([](const int) { return true; }));
+        VERIFY_ARE_EQUAL(0u, r.capacity());
+    }
+};
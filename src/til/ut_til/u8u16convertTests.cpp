@@ -17,6 +17,8 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestU8ToU16MatchesPlatform);
+    TEST_METHOD(TestU16ToU8MatchesPlatform);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +193,70 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestU8ToU16MatchesPlatform()
+{
+    // Long enough ASCII runs to take the vectorized path, interrupted by valid
+    // and invalid sequences of every length, including ones at a run's end.
+    const std::string ascii{ "The quick brown fox jumps over the lazy dog. 0123456789" };
+    const std::string sequences[] = {
+        "\xC3\xB6", // LATIN SMALL LETTER O WITH DIAERESIS
+        "\xE2\x82\xAC", // EURO SIGN
+        "\xF0\x9F\x93\xB7", // CAMERA
+        "\xC0\xAF", // overlong encoding
+        "\xED\xA0\x80", // encoded surrogate
+        "\xF4\x90\x80\x80", // beyond U+10FFFF
+        "\xE2\x82", // truncated sequence
+        "\x80\xBF", // continuation bytes without a lead byte
+        "\xFF",
+    };
+
+    std::string u8String{};
+    for (const auto& sequence : sequences)
+    {
+        u8String += ascii.substr(0, u8String.length() % ascii.length());
+        u8String += sequence;
+        u8String += sequence;
+    }
+    u8String += ascii;
+
+    std::wstring u16StringComp(u8String.length(), L'\0');
+    const auto length{ MultiByteToWideChar(CP_UTF8, 0, u8String.data(), gsl::narrow<int>(u8String.length()), u16StringComp.data(), gsl::narrow<int>(u16StringComp.length())) };
+    u16StringComp.resize(gsl::narrow<size_t>(length));
+
+    std::wstring u16Out{};
+    const HRESULT hRes{ til::u8u16(u8String, u16Out) };
+    VERIFY_ARE_EQUAL(S_OK, hRes);
+    VERIFY_ARE_EQUAL(u16StringComp, u16Out);
+}
+
+void Utf8Utf16ConvertTests::TestU16ToU8MatchesPlatform()
+{
+    const std::wstring ascii{ L"The quick brown fox jumps over the lazy dog. 0123456789" };
+    const std::wstring sequences[] = {
+        L"\x00F6", // LATIN SMALL LETTER O WITH DIAERESIS
+        L"\x20AC", // EURO SIGN
+        L"\xD83D\xDCF7", // CAMERA (surrogate pair)
+        L"\xD83D", // unpaired high surrogate
+        L"\xDCF7", // unpaired low surrogate
+        L"\xFFFF",
+    };
+
+    std::wstring u16String{};
+    for (const auto& sequence : sequences)
+    {
+        u16String += ascii.substr(0, u16String.length() % ascii.length());
+        u16String += sequence;
+        u16String += sequence;
+    }
+    u16String += ascii;
+
+    std::string u8StringComp(u16String.length() * 3, '\0');
+    const auto length{ WideCharToMultiByte(CP_UTF8, 0, u16String.data(), gsl::narrow<int>(u16String.length()), u8StringComp.data(), gsl::narrow<int>(u8StringComp.length()), nullptr, nullptr) };
+    u8StringComp.resize(gsl::narrow<size_t>(length));
+
+    std::string u8Out{};
+    const HRESULT hRes{ til::u16u8(u16String, u8Out) };
+    VERIFY_ARE_EQUAL(S_OK, hRes);
+    VERIFY_ARE_EQUAL(u8StringComp, u8Out);
+}
@@ -3,6 +3,7 @@
 // NOTE The functions u8u16 and u16u8 contain own algorithms. Tests have shown that they perform
 // worse than the platform API functions.
 // Thus, these functions are *unrelated* to the til::u8u16 and til::u16u8 implementation.
+// The natural language tests measure til::u8u16 and til::u16u8 alongside, for comparison.
 
 #include <iostream>
 #include <memory>
@@ -13,6 +14,11 @@
 
 #include "U8U16Test.hpp"
 
+#include <gsl/gsl>
+#include <wil/result_macros.h>
+#include <base/numerics/safe_math.h>
+#include <til/u8u16convert.h>
+
 typedef NTSTATUS(WINAPI* t_RtlUTF8ToUnicodeN)(PWSTR, ULONG, PULONG, PCCH, ULONG);
 typedef NTSTATUS(WINAPI* t_RtlUnicodeToUTF8N)(PCHAR, ULONG, PULONG, PCWSTR, ULONG);
 NTSTATUS(WINAPI* p_RtlUTF8ToUnicodeN)
@@ -354,6 +360,12 @@ void CompNaturalLang_WholeString(const std::string& fileName)
     duration = GetDuration();
     std::cout << " u8u16_ptr           length " << u16Str.length() << " elapsed " << duration << std::endl;
 
+    GetDuration();
+    std::wstring tilU16Str{};
+    hRes = til::u8u16(u8Str, tilU16Str);
+    duration = GetDuration();
+    std::cout << " til::u8u16          length " << tilU16Str.length() << " elapsed " << duration << std::endl;
+
     GetDuration();
     std::unique_ptr<char[]> u8Buffer{ std::make_unique<char[]>(u16Str.length() * 3) };
     length = WideCharToMultiByte(65001, 0, u16Str.data(), static_cast<int>(u16Str.length()), u8Buffer.get(), static_cast<int>(u16Str.length()) * 3, nullptr, nullptr);
@@ -366,6 +378,12 @@ void CompNaturalLang_WholeString(const std::string& fileName)
     hRes = u16u8_ptr(u16Str, u8StrOut);
     duration = GetDuration();
     std::cout << " u16u8_ptr           length " << u8StrOut.length() << " elapsed " << duration << std::endl;
+
+    GetDuration();
+    std::string tilU8StrOut{};
+    hRes = til::u16u8(u16Str, tilU8StrOut);
+    duration = GetDuration();
+    std::cout << " til::u16u8          length " << tilU8StrOut.length() << " elapsed " << duration << std::endl;
 }
 
 void CompNaturalLang_Chunks(const std::string& fileName)
@@ -391,10 +409,14 @@ void CompNaturalLang_Chunks(const std::string& fileName)
     int lenTotalWC2MB{};
     size_t lenTotalU8U16{};
     size_t lenTotalU16U8{};
+    size_t lenTotalTilU8U16{};
+    size_t lenTotalTilU16U8{};
     double durTotalMB2WC{};
     double durTotalWC2MB{};
     double durTotalU8U16{};
     double durTotalU16U8{};
+    double durTotalTilU8U16{};
+    double durTotalTilU16U8{};
 
     GetDuration();
     std::unique_ptr<wchar_t[]> u16Buffer{ std::make_unique<wchar_t[]>(chunkSize) };
@@ -412,6 +434,14 @@ void CompNaturalLang_Chunks(const std::string& fileName)
     std::string u8StrOut{};
     durTotalU16U8 += GetDuration();
 
+    GetDuration();
+    std::wstring tilU16StrOut{};
+    durTotalTilU8U16 += GetDuration();
+
+    GetDuration();
+    std::string tilU8StrOut{};
+    durTotalTilU16U8 += GetDuration();
+
     for (size_t idx = 0u; idx < u16Str.length(); idx += chunkSize)
     {
         std::wstring u16Chunk{ u16Str.substr(idx, chunkSize) };
@@ -434,12 +464,24 @@ void CompNaturalLang_Chunks(const std::string& fileName)
         hRes = u16u8_ptr(u16Chunk, u8StrOut);
         durTotalU16U8 += GetDuration();
         lenTotalU16U8 += u8StrOut.length();
+
+        GetDuration();
+        hRes = til::u8u16(u8Chunk, tilU16StrOut);
+        durTotalTilU8U16 += GetDuration();
+        lenTotalTilU8U16 += tilU16StrOut.length();
+
+        GetDuration();
+        hRes = til::u16u8(u16Chunk, tilU8StrOut);
+        durTotalTilU16U8 += GetDuration();
+        lenTotalTilU16U8 += tilU8StrOut.length();
     }
 
     std::cout << " MultiByteToWideChar length " << lenTotalMB2WC << " elapsed " << durTotalMB2WC << std::endl;
     std::cout << " u8u16_ptr           length " << lenTotalU8U16 << " elapsed " << durTotalU8U16 << std::endl;
     std::cout << " WideCharToMultiByte length " << lenTotalWC2MB << " elapsed " << durTotalWC2MB << std::endl;
     std::cout << " u16u8_ptr           length " << lenTotalU16U8 << " elapsed " << durTotalU16U8 << std::endl;
+    std::cout << " til::u8u16          length " << lenTotalTilU8U16 << " elapsed " << durTotalTilU8U16 << std::endl;
+    std::cout << " til::u16u8          length " << lenTotalTilU16U8 << " elapsed " << durTotalTilU16U8 << std::endl;
 }
 
 int main()
@@ -0,0 +1,6 @@
+:: TEST TOOL vtbench
+@echo off &setlocal
+cd /d "%~dp0"
+..\..\..\x64\Release\vtbench.exe --synthetic ..\..\host\ft_host\chafa.txt %*
+echo(
+pause
@@ -0,0 +1,396 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL vtbench
+// Replays recorded VT output through the Terminal's output pipeline without a renderer
+// and reports the throughput and the allocations of each stage:
+//   decode    til::u8u16, in the chunk sizes a connection delivers
+//   parse     StateMachine and OutputStateMachineEngine, dispatching to a no-op ITermDispatch
+//   terminal  Terminal::Write, i.e. parsing plus TerminalDispatch and the TextBuffer
+// The cost of TerminalDispatch and the TextBuffer alone is the difference between the last two.
+//
+// Usage: vtbench [--json] [--synthetic] [--iterations N] [file...]
+//   file          a recorded VT byte stream, e.g. ft_host\chafa.txt or the output of a vttests script
+//   --synthetic   also replay the generated corpora: a build log, full-screen repaints in the
+//                 style of htop and emoji-heavy text. This is the default if no files are given.
+//   --iterations  how often each stage is replayed. The fastest run is reported. Defaults to 5.
+//   --json        print the results as JSON instead of a table
+
+#include "pch.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+using Microsoft::Terminal::Core::Terminal;
+
+// Every allocation in the process is counted, so that the allocations
+// of a stage are the difference of the counter before and after it ran.
+static std::atomic<size_t> g_allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    // ConptyConnection reads its pipe in chunks of this size.
+    constexpr size_t ChunkSize = 4096;
+
+    constexpr COORD ViewportSize{ 120, 30 };
+    constexpr SHORT ScrollbackLines = 9001;
+
+    constexpr size_t SyntheticSize = 4 * 1024 * 1024;
+    constexpr size_t DefaultIterations = 5;
+
+    struct Corpus
+    {
+        std::string name;
+        std::string bytes;
+    };
+
+    struct StageResult
+    {
+        const char* name;
+        double seconds;
+        size_t allocations;
+    };
+
+    // Ignores everything the parser dispatches, so that the parse stage only measures the parser.
+    class NullDispatch final : public TermDispatch
+    {
+    public:
+        void Execute(const wchar_t) override {}
+        void Print(const wchar_t) override {}
+        void PrintString(const std::wstring_view) override {}
+    };
+
+    struct DecodeState
+    {
+        til::u8state state;
+        std::wstring buffer;
+    };
+
+    struct TerminalState
+    {
+        DummyRenderTarget renderTarget;
+        Terminal terminal;
+    };
+
+    std::string GenerateBuildLog(const size_t size)
+    {
+        std::string out;
+        for (size_t line = 0; out.size() < size; ++line)
+        {
+            out += "[" + std::to_string(line % 101) + "%] Building CXX object src/module" + std::to_string(line % 37) + "/file" + std::to_string(line) + ".cpp.obj\r\n";
+            if (line % 7 == 0)
+            {
+                out += "\x1b[1;33mwarning C4100:\x1b[m 'argument': unreferenced formal parameter\r\n";
+            }
+        }
+        return out;
+    }
+
+    std::string GenerateFullScreenRepaints(const size_t size)
+    {
+        std::string out;
+        char line[256];
+        for (size_t frame = 0; out.size() < size; ++frame)
+        {
+            out += "\x1b[?25l\x1b[H\x1b[30;46m  PID USER      PRI  NI  VIRT   RES S CPU% MEM%   TIME+  Command\x1b[K\x1b[m";
+            for (size_t row = 2; row <= static_cast<size_t>(ViewportSize.Y); ++row)
+            {
+                const auto load = (frame * 7 + row * 13) % 1000;
+                sprintf_s(line,
+                          "\x1b[%zu;1H%5zu \x1b[32m%-9s\x1b[m %3zu %3d \x1b[36m%5zuM\x1b[m %5zuM S \x1b[1;31m%2zu.%zu\x1b[m %4.1f %3zu:%02zu.%02zu %s\x1b[K",
+                          row,
+                          1000 + row * 17,
+                          row % 3 ? "user" : "root",
+                          20 + row % 5,
+                          0,
+                          100 + (row * 31 + frame) % 900,
+                          10 + (row * 17 + frame) % 90,
+                          load / 10,
+                          load % 10,
+                          (row % 50) / 10.0,
+                          frame / 6000,
+                          frame / 100 % 60,
+                          frame % 100,
+                          row % 2 ? "/usr/bin/python3 server.py" : "bash");
+                out += line;
+            }
+            out += "\x1b[?25h";
+        }
+        return out;
+    }
+
+    std::string GenerateEmojiText(const size_t size)
+    {
+        // ASCII, CJK, emoji (surrogate pairs in UTF-16), emoji with modifiers and ZWJ sequences.
+        static constexpr std::string_view words[]{
+            "hello ",
+            u8"\u3053\u3093\u306B\u3061\u306F ",
+            u8"\U0001F600 ",
+            u8"\U0001F44D\U0001F3FD ",
+            u8"\U0001F468\u200D\U0001F469\u200D\U0001F467 ",
+            "world ",
+            u8"\u4E16\u754C ",
+            u8"\U0001F680\U0001F525 ",
+        };
+
+        std::string out;
+        for (size_t word = 0; out.size() < size; ++word)
+        {
+            out += words[word * 5 % std::size(words)];
+            if (word % 13 == 12)
+            {
+                out += "\r\n";
+            }
+        }
+        return out;
+    }
+
+    std::optional<Corpus> ReadCorpus(const std::wstring_view path)
+    {
+        std::ifstream file{ std::wstring{ path }, std::ios::binary };
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return Corpus{ til::u16u8(path), contents.str() };
+    }
+
+    std::vector<std::wstring> Decode(const std::string_view bytes)
+    {
+        std::vector<std::wstring> chunks;
+        til::u8state state;
+        for (size_t offset = 0; offset < bytes.size(); offset += ChunkSize)
+        {
+            std::wstring chunk;
+            THROW_IF_FAILED(til::u8u16(bytes.substr(offset, ChunkSize), chunk, state));
+            chunks.emplace_back(std::move(chunk));
+        }
+        return chunks;
+    }
+
+    // Runs replay on a fresh state from setup for the given number of iterations.
+    // Only the replay is measured, and the fastest iteration is reported.
+    template<typename Setup, typename Replay>
+    StageResult Measure(const char* name, const size_t iterations, Setup&& setup, Replay&& replay)
+    {
+        StageResult result{ name, std::numeric_limits<double>::max(), 0 };
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto state = setup();
+
+            const auto allocations = g_allocations.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            replay(*state);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (elapsed.count() < result.seconds)
+            {
+                result.seconds = elapsed.count();
+                result.allocations = g_allocations.load(std::memory_order_relaxed) - allocations;
+            }
+        }
+        return result;
+    }
+
+    std::vector<StageResult> Run(const Corpus& corpus, const size_t iterations)
+    {
+        const std::string_view bytes{ corpus.bytes };
+        const auto chunks = Decode(bytes);
+
+        std::vector<StageResult> results;
+
+        results.emplace_back(Measure(
+            "decode",
+            iterations,
+            []() { return std::make_unique<DecodeState>(); },
+            [&](DecodeState& decode) {
+                for (size_t offset = 0; offset < bytes.size(); offset += ChunkSize)
+                {
+                    THROW_IF_FAILED(til::u8u16(bytes.substr(offset, ChunkSize), decode.buffer, decode.state));
+                }
+            }));
+
+        results.emplace_back(Measure(
+            "parse",
+            iterations,
+            []() { return std::make_unique<StateMachine>(std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>())); },
+            [&](StateMachine& stateMachine) {
+                for (const auto& chunk : chunks)
+                {
+                    stateMachine.ProcessString(chunk);
+                }
+            }));
+
+        results.emplace_back(Measure(
+            "terminal",
+            iterations,
+            []() {
+                auto state = std::make_unique<TerminalState>();
+                state->terminal.Create(ViewportSize, ScrollbackLines, state->renderTarget);
+                return state;
+            },
+            [&](TerminalState& state) {
+                for (const auto& chunk : chunks)
+                {
+                    state.terminal.Write(chunk);
+                }
+            }));
+
+        return results;
+    }
+
+    double MegabytesPerSecond(const Corpus& corpus, const StageResult& stage) noexcept
+    {
+        return corpus.bytes.size() / 1e6 / stage.seconds;
+    }
+
+    double AllocationsPerMegabyte(const Corpus& corpus, const StageResult& stage) noexcept
+    {
+        return stage.allocations / (corpus.bytes.size() / 1e6);
+    }
+
+    std::string JsonEscape(const std::string_view text)
+    {
+        std::string out;
+        for (const auto ch : text)
+        {
+            if (ch == '"' || ch == '\\')
+            {
+                out += '\\';
+            }
+            out += ch;
+        }
+        return out;
+    }
+
+    void PrintTable(const std::vector<Corpus>& corpora, const std::vector<std::vector<StageResult>>& results)
+    {
+        printf("%-32s %12s %-10s %10s %10s %12s\n", "corpus", "bytes", "stage", "ms", "MB/s", "allocs/MB");
+        for (size_t i = 0; i < corpora.size(); ++i)
+        {
+            for (const auto& stage : results.at(i))
+            {
+                printf("%-32s %12zu %-10s %10.2f %10.2f %12.2f\n",
+                       corpora.at(i).name.c_str(),
+                       corpora.at(i).bytes.size(),
+                       stage.name,
+                       stage.seconds * 1000,
+                       MegabytesPerSecond(corpora.at(i), stage),
+                       AllocationsPerMegabyte(corpora.at(i), stage));
+            }
+        }
+    }
+
+    void PrintJson(const std::vector<Corpus>& corpora, const std::vector<std::vector<StageResult>>& results)
+    {
+        printf("[\n");
+        for (size_t i = 0; i < corpora.size(); ++i)
+        {
+            printf("  { \"corpus\": \"%s\", \"bytes\": %zu, \"stages\": [\n", JsonEscape(corpora.at(i).name).c_str(), corpora.at(i).bytes.size());
+            const auto& stages = results.at(i);
+            for (size_t j = 0; j < stages.size(); ++j)
+            {
+                const auto& stage = stages.at(j);
+                printf("    { \"stage\": \"%s\", \"seconds\": %.6f, \"allocations\": %zu, \"megabytesPerSecond\": %.3f, \"allocationsPerMegabyte\": %.3f }%s\n",
+                       stage.name,
+                       stage.seconds,
+                       stage.allocations,
+                       MegabytesPerSecond(corpora.at(i), stage),
+                       AllocationsPerMegabyte(corpora.at(i), stage),
+                       j + 1 < stages.size() ? "," : "");
+            }
+            printf("  ] }%s\n", i + 1 < corpora.size() ? "," : "");
+        }
+        printf("]\n");
+    }
+}
+
+int __cdecl wmain(int argc, wchar_t* argv[])
+try
+{
+    auto json = false;
+    auto synthetic = false;
+    auto iterations = DefaultIterations;
+    std::vector<Corpus> corpora;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        if (arg == L"--json")
+        {
+            json = true;
+        }
+        else if (arg == L"--synthetic")
+        {
+            synthetic = true;
+        }
+        else if (arg == L"--iterations" && i + 1 < argc)
+        {
+            iterations = std::max<size_t>(1, wcstoul(argv[++i], nullptr, 10));
+        }
+        else if (auto corpus = ReadCorpus(arg))
+        {
+            corpora.emplace_back(std::move(*corpus));
+        }
+        else
+        {
+            std::wcerr << L"Can't read " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (synthetic || corpora.empty())
+    {
+        corpora.push_back({ "synthetic:buildlog", GenerateBuildLog(SyntheticSize) });
+        corpora.push_back({ "synthetic:fullscreen", GenerateFullScreenRepaints(SyntheticSize) });
+        corpora.push_back({ "synthetic:emoji", GenerateEmojiText(SyntheticSize) });
+    }
+
+    std::vector<std::vector<StageResult>> results;
+    for (const auto& corpus : corpora)
+    {
+        results.emplace_back(Run(corpus, iterations));
+    }
+
+    if (json)
+    {
+        PrintJson(corpora, results);
+    }
+    else
+    {
+        PrintTable(corpora, results);
+    }
+
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -0,0 +1,27 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- pch.h
+
+Abstract:
+- Contains external headers to include in the precompile phase of the build.
+--*/
+
+#pragma once
+
+#define BLOCK_TIL
+#include "LibraryIncludes.h"
+#ifdef GetCurrentTime
+#undef GetCurrentTime
+#endif
+
+#include <wil/cppwinrt.h>
+#include <unknwn.h>
+#include <hstring.h>
+
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Microsoft.Terminal.Core.h>
+
+#include "til.h"
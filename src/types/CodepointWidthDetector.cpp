@@ -321,6 +321,122 @@ namespace
         UnicodeRange{ 0xf0000, 0xffffd, CodepointWidth::Ambiguous },
         UnicodeRange{ 0x100000, 0x10fffd, CodepointWidth::Ambiguous },
     };
+
+    // The range table above is flattened into a two-stage lookup table at compile time.
+    // The upper bits of a codepoint select a block of s_blockSize widths in the second stage
+    // and the lower bits index into it. Blocks whose codepoints all share the same width
+    // point at one of the uniform blocks at the start of the second stage (one per width),
+    // so only blocks that mix widths need storage of their own.
+    static constexpr unsigned int s_blockShift = 8;
+    static constexpr unsigned int s_blockSize = 1u << s_blockShift;
+    static constexpr unsigned int s_blockCount = (0x10FFFF >> s_blockShift) + 1;
+    static constexpr size_t s_uniformBlockCount = 3;
+
+    static_assert(static_cast<size_t>(CodepointWidth::Narrow) < s_uniformBlockCount &&
+                      static_cast<size_t>(CodepointWidth::Wide) < s_uniformBlockCount &&
+                      static_cast<size_t>(CodepointWidth::Ambiguous) < s_uniformBlockCount,
+                  "uniform blocks are indexed by CodepointWidth");
+
+    // Routine Description:
+    // - Determines whether all codepoints of a block share the same width.
+    // Arguments:
+    // - range - index into s_wideAndAmbiguousTable. It's advanced past all ranges that end before
+    //           the block, so that walking the blocks in order only walks the range table once.
+    // - first - the first codepoint of the block
+    // Return Value:
+    // - the width shared by the block, or CodepointWidth::Invalid if it contains several widths
+    static constexpr CodepointWidth _uniformBlockWidth(size_t& range, const unsigned int first) noexcept
+    {
+        const auto last = first + s_blockSize - 1;
+        while (range < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[range].upperBound < first)
+        {
+            ++range;
+        }
+
+        if (range == s_wideAndAmbiguousTable.size() || s_wideAndAmbiguousTable[range].lowerBound > last)
+        {
+            return CodepointWidth::Narrow;
+        }
+
+        if (s_wideAndAmbiguousTable[range].lowerBound <= first && s_wideAndAmbiguousTable[range].upperBound >= last)
+        {
+            return s_wideAndAmbiguousTable[range].width;
+        }
+
+        return CodepointWidth::Invalid;
+    }
+
+    static constexpr size_t _countMixedBlocks() noexcept
+    {
+        size_t range = 0;
+        size_t count = 0;
+        for (unsigned int block = 0; block < s_blockCount; ++block)
+        {
+            if (_uniformBlockWidth(range, block << s_blockShift) == CodepointWidth::Invalid)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    static constexpr size_t s_mixedBlockCount = _countMixedBlocks();
+
+    static_assert(s_uniformBlockCount + s_mixedBlockCount <= UINT8_MAX + 1,
+                  "the first stage stores block indices as uint8_t");
+
+    struct CodepointWidthTable final
+    {
+        std::array<uint8_t, s_blockCount> blocks;
+        std::array<CodepointWidth, (s_uniformBlockCount + s_mixedBlockCount) * s_blockSize> widths;
+    };
+
+    static constexpr CodepointWidthTable _buildCodepointWidthTable() noexcept
+    {
+        CodepointWidthTable table{};
+
+        for (size_t block = 0; block < s_uniformBlockCount; ++block)
+        {
+            for (size_t i = 0; i < s_blockSize; ++i)
+            {
+                table.widths[block * s_blockSize + i] = static_cast<CodepointWidth>(block);
+            }
+        }
+
+        size_t range = 0;
+        size_t nextBlock = s_uniformBlockCount;
+        for (unsigned int block = 0; block < s_blockCount; ++block)
+        {
+            const auto first = block << s_blockShift;
+            const auto width = _uniformBlockWidth(range, first);
+            if (width != CodepointWidth::Invalid)
+            {
+                table.blocks[block] = static_cast<uint8_t>(width);
+                continue;
+            }
+
+            table.blocks[block] = static_cast<uint8_t>(nextBlock);
+
+            auto cursor = range;
+            for (unsigned int i = 0; i < s_blockSize; ++i)
+            {
+                const auto codepoint = first + i;
+                while (cursor < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[cursor].upperBound < codepoint)
+                {
+                    ++cursor;
+                }
+
+                const auto inRange = cursor < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[cursor].lowerBound <= codepoint;
+                table.widths[nextBlock * s_blockSize + i] = inRange ? s_wideAndAmbiguousTable[cursor].width : CodepointWidth::Narrow;
+            }
+
+            ++nextBlock;
+        }
+
+        return table;
+    }
+
+    static constexpr CodepointWidthTable s_codepointWidths = _buildCodepointWidthTable();
 }
 
 // Routine Description:
@@ -403,6 +519,38 @@ bool CodepointWidthDetector::IsWide(const std::wstring_view glyph) const
     return GetWidth(glyph) == CodepointWidth::Wide;
 }
 
+// Routine Description:
+// - Measures how many columns a run of text occupies, counting each UTF-16 code unit
+//   the same way IsWide(wchar_t) does: 2 columns if it's wide and 1 column otherwise.
+//   Ambiguous characters are only wide if the fallback method says so.
+// Arguments:
+// - text - the run of text to measure
+// Return Value:
+// - the number of columns the text occupies
+size_t CodepointWidthDetector::MeasureRun(const std::wstring_view text) const noexcept
+{
+    size_t columns = 0;
+    for (const auto wch : text)
+    {
+        if (GetQuickCharWidth(wch) == CodepointWidth::Narrow)
+        {
+            columns += 1;
+            continue;
+        }
+
+        const auto width = _lookupCodepointWidth(wch);
+        if (width == CodepointWidth::Wide || (width == CodepointWidth::Ambiguous && _pfnFallbackMethod && IsWide(wch)))
+        {
+            columns += 2;
+        }
+        else
+        {
+            columns += 1;
+        }
+    }
+    return columns;
+}
+
 // Routine Description:
 // - returns the width type of codepoint by searching the map generated from the unicode spec
 // Arguments:
@@ -416,17 +564,24 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view
         return CodepointWidth::Invalid;
     }
 
-    const auto codepoint = _extractCodepoint(glyph);
-    const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
+    return _lookupCodepointWidth(_extractCodepoint(glyph));
+}
 
-    // For characters that are not _in_ the table, lower_bound will return the nearest item that is.
-    // We must check its bounds to make sure that our hit was a true hit.
-    if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
+// Routine Description:
+// - returns the width type of codepoint using the two-stage table generated from the unicode spec
+// Arguments:
+// - codepoint - the codepoint to look up
+// Return Value:
+// - the width type of the codepoint
+CodepointWidth CodepointWidthDetector::_lookupCodepointWidth(const unsigned int codepoint) noexcept
+{
+    if (codepoint > 0x10FFFF)
     {
-        return it->width;
+        return CodepointWidth::Narrow;
     }
 
-    return CodepointWidth::Narrow;
+    const size_t block = til::at(s_codepointWidths.blocks, codepoint >> s_blockShift);
+    return til::at(s_codepointWidths.widths, (block << s_blockShift) | (codepoint & (s_blockSize - 1)));
 }
 
 // Routine Description:
@@ -471,19 +626,19 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidthWithCache(const std::wst
 // - Checks the fallback function but caches the results until the font changes
 //   because the lookup function is usually very expensive and will return the same results
 //   for the same inputs.
+//   The cache is keyed by codepoint (like the width table) so that a hit doesn't allocate.
 // Arguments:
 // - glyph - the utf16 encoded codepoint to check width of
 // - true if codepoint is wide or false if it is narrow
 bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyph) const
 {
-    const std::wstring findMe{ glyph };
+    const auto codepoint = _extractCodepoint(glyph);
 
-    // TODO: Cache needs to be emptied when font changes.
-    const auto it = _fallbackCache.find(findMe);
+    const auto it = _fallbackCache.find(codepoint);
     if (it == _fallbackCache.end())
     {
         auto result = _pfnFallbackMethod(glyph);
-        _fallbackCache.insert_or_assign(findMe, result);
+        _fallbackCache.insert_or_assign(codepoint, result);
         return result;
     }
     else
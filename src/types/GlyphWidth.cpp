@@ -25,6 +25,14 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return widthDetector.IsWide(wch);
 }
 
+// Function Description:
+// - determines the number of columns the given run of characters occupies,
+//      at the cost of a single call. See CodepointWidthDetector::MeasureRun
+size_t MeasureGlyphRun(const std::wstring_view text) noexcept
+{
+    return widthDetector.MeasureRun(text);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
@@ -15,6 +15,7 @@ Author(s):
 #pragma once
 
 #include "IBaseData.h"
+#include "../buffer/out/SearchIndex.hpp"
 
 struct ITextRangeProvider;
 
@@ -40,6 +41,7 @@ namespace Microsoft::Console::Types
         virtual const COORD GetSelectionAnchor() const noexcept = 0;
         virtual const COORD GetSelectionEnd() const noexcept = 0;
         virtual void ColorSelection(const COORD coordSelectionStart, const COORD coordSelectionEnd, const TextAttribute attr) = 0;
+        virtual SearchIndex& GetSearchIndex() noexcept = 0;
     };
 
     // See docs/virtual-dtors.md for an explanation of why this is weird.
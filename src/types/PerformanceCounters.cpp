@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/PerformanceCounters.hpp"
+
+using namespace Microsoft::Console::Types;
+
+namespace
+{
+    constexpr size_t s_counterCount = static_cast<size_t>(PerformanceCounter::Count);
+
+    constexpr std::array<std::wstring_view, s_counterCount> s_counterNames{
+        L"ParsedCharacters",
+        L"PrintRuns",
+        L"PrintRunCharacters",
+        L"IndividuallyProcessedCharacters",
+        L"ExecutedControls",
+        L"EscapeSequences",
+        L"CsiSequences",
+        L"OscSequences",
+        L"DcsSequences",
+        L"Ss3Sequences",
+        L"Vt52Sequences",
+        L"RowsCirculated",
+        L"RowsScrolled",
+        L"FramesPainted",
+        L"EnginePaints",
+        L"EnginePaintMicroseconds",
+        L"LockContentions",
+        L"LockWaitMicroseconds",
+    };
+}
+
+// Routine Description:
+// - Returns the value of a counter in the snapshot.
+uint64_t PerformanceCounters::Snapshot::operator[](const PerformanceCounter counter) const noexcept
+{
+    return til::at(values, static_cast<size_t>(counter));
+}
+
+// Routine Description:
+// - Returns the amount each counter grew by since an earlier snapshot.
+PerformanceCounters::Snapshot PerformanceCounters::Snapshot::operator-(const Snapshot& other) const noexcept
+{
+    Snapshot difference;
+    difference.time = time;
+    for (size_t i = 0; i < s_counterCount; ++i)
+    {
+        til::at(difference.values, i) = til::at(values, i) - til::at(other.values, i);
+    }
+    for (size_t i = 0; i < MaxEngines; ++i)
+    {
+        til::at(difference.enginePaints, i) = til::at(enginePaints, i) - til::at(other.enginePaints, i);
+        til::at(difference.enginePaintMicroseconds, i) = til::at(enginePaintMicroseconds, i) - til::at(other.enginePaintMicroseconds, i);
+    }
+    return difference;
+}
+
+PerformanceCounters::PerformanceCounters() noexcept :
+    _values{},
+    _enginePaints{},
+    _enginePaintMicroseconds{}
+{
+}
+
+// Routine Description:
+// - Adds to a counter.
+// - The lock counters are added to by any thread that takes the lock,
+//   which is why this is an interlocked add. It isn't contended though,
+//   since the parser, the renderer and the lock are counted by different threads.
+// Arguments:
+// - counter - the counter to add to
+// - value - the amount to add
+// Return Value:
+// - <none>
+void PerformanceCounters::Add(const PerformanceCounter counter, const uint64_t value) noexcept
+{
+    til::at(_values, static_cast<size_t>(counter)).fetch_add(value, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Counts a frame painted by a render engine, both for that engine and in the totals.
+// Arguments:
+// - engine - the index of the engine in the renderer
+// - time - how long it took the engine to paint the frame
+// Return Value:
+// - <none>
+void PerformanceCounters::AddEnginePaint(const size_t engine, const std::chrono::microseconds time) noexcept
+{
+    const auto microseconds = gsl::narrow_cast<uint64_t>(time.count());
+    Add(PerformanceCounter::EnginePaints);
+    Add(PerformanceCounter::EnginePaintMicroseconds, microseconds);
+    if (engine < MaxEngines)
+    {
+        til::at(_enginePaints, engine).fetch_add(1, std::memory_order_relaxed);
+        til::at(_enginePaintMicroseconds, engine).fetch_add(microseconds, std::memory_order_relaxed);
+    }
+}
+
+// Routine Description:
+// - Reads all counters.
+// Arguments:
+// - <none>
+// Return Value:
+// - The values of all counters at this point in time.
+PerformanceCounters::Snapshot PerformanceCounters::Capture() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < s_counterCount; ++i)
+    {
+        til::at(snapshot.values, i) = til::at(_values, i).load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < MaxEngines; ++i)
+    {
+        til::at(snapshot.enginePaints, i) = til::at(_enginePaints, i).load(std::memory_order_relaxed);
+        til::at(snapshot.enginePaintMicroseconds, i) = til::at(_enginePaintMicroseconds, i).load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+// Routine Description:
+// - Returns the name of a counter.
+std::wstring_view PerformanceCounters::GetName(const PerformanceCounter counter) noexcept
+{
+    return til::at(s_counterNames, static_cast<size_t>(counter));
+}
+
+// Routine Description:
+// - Formats a snapshot as one "name: value" line per counter, followed by
+//   the paint counters of every engine that painted anything.
+// Arguments:
+// - snapshot - the snapshot to format
+// - previous - if given, an earlier snapshot. Each line is then followed
+//              by the growth of the counter since then, and its rate per second.
+// Return Value:
+// - The formatted counters.
+std::wstring PerformanceCounters::Format(const Snapshot& snapshot, const Snapshot* const previous)
+{
+    std::wstring out;
+    const auto seconds = previous ? std::chrono::duration<double>(snapshot.time - previous->time).count() : 0.0;
+
+    const auto formatLine = [&](const std::wstring_view name, const uint64_t value, const std::optional<uint64_t> previousValue) {
+        fmt::format_to(std::back_inserter(out), L"{}: {}", name, value);
+        if (previousValue)
+        {
+            const auto delta = value - *previousValue;
+            fmt::format_to(std::back_inserter(out), L" (+{}, {:.1f}/s)", delta, seconds > 0 ? delta / seconds : 0.0);
+        }
+        out.push_back(L'\n');
+    };
+
+    for (size_t i = 0; i < s_counterCount; ++i)
+    {
+        const auto counter = static_cast<PerformanceCounter>(i);
+        formatLine(GetName(counter), snapshot[counter], previous ? std::optional{ (*previous)[counter] } : std::nullopt);
+    }
+
+    for (size_t i = 0; i < MaxEngines; ++i)
+    {
+        const auto paints = til::at(snapshot.enginePaints, i);
+        if (paints == 0)
+        {
+            continue;
+        }
+
+        formatLine(fmt::format(L"{}[{}]", GetName(PerformanceCounter::EnginePaints), i),
+                   paints,
+                   previous ? std::optional{ til::at(previous->enginePaints, i) } : std::nullopt);
+        formatLine(fmt::format(L"{}[{}]", GetName(PerformanceCounter::EnginePaintMicroseconds), i),
+                   til::at(snapshot.enginePaintMicroseconds, i),
+                   previous ? std::optional{ til::at(previous->enginePaintMicroseconds, i) } : std::nullopt);
+    }
+
+    return out;
+}
@@ -0,0 +1,85 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- PerformanceCounters.hpp
+
+Abstract:
+- Always-on counters for the hot paths of the parser, the text buffer, the renderer and the terminal lock.
+- Each terminal owns a block of counters and hands it to the parts it's made of, so that
+  the counters of one pane aren't mixed up with those of the others. Paint time is also
+  kept per render engine. The difference of two snapshots tells where time went between
+  them, for instance whether a slow pane is bound by parsing, by its lock or by painting.
+--*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace Microsoft::Console::Types
+{
+    enum class PerformanceCounter : size_t
+    {
+        ParsedCharacters,
+        PrintRuns,
+        PrintRunCharacters,
+        IndividuallyProcessedCharacters,
+        ExecutedControls,
+        EscapeSequences,
+        CsiSequences,
+        OscSequences,
+        DcsSequences,
+        Ss3Sequences,
+        Vt52Sequences,
+        RowsCirculated,
+        RowsScrolled,
+        FramesPainted,
+        EnginePaints,
+        EnginePaintMicroseconds,
+        LockContentions,
+        LockWaitMicroseconds,
+        Count
+    };
+
+    class PerformanceCounters final
+    {
+    public:
+        // The number of render engines whose paints are counted separately.
+        // Further engines are only counted in the totals.
+        static constexpr size_t MaxEngines = 4;
+
+        struct Snapshot
+        {
+            std::chrono::steady_clock::time_point time{};
+            std::array<uint64_t, static_cast<size_t>(PerformanceCounter::Count)> values{};
+            std::array<uint64_t, MaxEngines> enginePaints{};
+            std::array<uint64_t, MaxEngines> enginePaintMicroseconds{};
+
+            uint64_t operator[](const PerformanceCounter counter) const noexcept;
+            Snapshot operator-(const Snapshot& other) const noexcept;
+        };
+
+        PerformanceCounters() noexcept;
+
+        PerformanceCounters(const PerformanceCounters&) = delete;
+        PerformanceCounters(PerformanceCounters&&) = delete;
+        PerformanceCounters& operator=(const PerformanceCounters&) = delete;
+        PerformanceCounters& operator=(PerformanceCounters&&) = delete;
+
+        void Add(const PerformanceCounter counter, const uint64_t value = 1) noexcept;
+        void AddEnginePaint(const size_t engine, const std::chrono::microseconds time) noexcept;
+        Snapshot Capture() const noexcept;
+
+        static std::wstring_view GetName(const PerformanceCounter counter) noexcept;
+        static std::wstring Format(const Snapshot& snapshot, const Snapshot* const previous = nullptr);
+
+    private:
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(PerformanceCounter::Count)> _values;
+        std::array<std::atomic<uint64_t>, MaxEngines> _enginePaints;
+        std::array<std::atomic<uint64_t>, MaxEngines> _enginePaintMicroseconds;
+    };
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/PerformanceCounters.hpp"
+
+#include <thread>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Types;
+
+class PerformanceCountersTests
+{
+    TEST_CLASS(PerformanceCountersTests);
+
+    TEST_METHOD(TestCounts)
+    {
+        PerformanceCounters counters;
+        const auto before = counters.Capture();
+        counters.Add(PerformanceCounter::CsiSequences);
+        counters.Add(PerformanceCounter::CsiSequences, 41);
+        counters.Add(PerformanceCounter::ParsedCharacters, 1000);
+        const auto after = counters.Capture();
+
+        const auto difference = after - before;
+        VERIFY_ARE_EQUAL(42u, difference[PerformanceCounter::CsiSequences]);
+        VERIFY_ARE_EQUAL(1000u, difference[PerformanceCounter::ParsedCharacters]);
+        VERIFY_ARE_EQUAL(0u, difference[PerformanceCounter::OscSequences]);
+    }
+
+    TEST_METHOD(TestCountsOfOtherThreads)
+    {
+        PerformanceCounters counters;
+
+        std::thread first{ [&]() { counters.Add(PerformanceCounter::LockContentions, 10); } };
+        std::thread second{ [&]() { counters.Add(PerformanceCounter::LockContentions, 20); } };
+        first.join();
+        second.join();
+
+        VERIFY_ARE_EQUAL(30u, counters.Capture()[PerformanceCounter::LockContentions]);
+    }
+
+    TEST_METHOD(TestCountersAreSeparate)
+    {
+        // Each terminal counts into its own block.
+        PerformanceCounters first;
+        PerformanceCounters second;
+        first.Add(PerformanceCounter::RowsScrolled, 10);
+
+        VERIFY_ARE_EQUAL(10u, first.Capture()[PerformanceCounter::RowsScrolled]);
+        VERIFY_ARE_EQUAL(0u, second.Capture()[PerformanceCounter::RowsScrolled]);
+    }
+
+    TEST_METHOD(TestEnginePaints)
+    {
+        PerformanceCounters counters;
+        counters.AddEnginePaint(0, std::chrono::microseconds{ 100 });
+        counters.AddEnginePaint(0, std::chrono::microseconds{ 50 });
+        counters.AddEnginePaint(1, std::chrono::microseconds{ 7 });
+        // Engines beyond the last one that's kept separately still count in the totals.
+        counters.AddEnginePaint(PerformanceCounters::MaxEngines, std::chrono::microseconds{ 3 });
+
+        const auto snapshot = counters.Capture();
+        VERIFY_ARE_EQUAL(4u, snapshot[PerformanceCounter::EnginePaints]);
+        VERIFY_ARE_EQUAL(160u, snapshot[PerformanceCounter::EnginePaintMicroseconds]);
+        VERIFY_ARE_EQUAL(2u, snapshot.enginePaints.at(0));
+        VERIFY_ARE_EQUAL(150u, snapshot.enginePaintMicroseconds.at(0));
+        VERIFY_ARE_EQUAL(1u, snapshot.enginePaints.at(1));
+        VERIFY_ARE_EQUAL(7u, snapshot.enginePaintMicroseconds.at(1));
+        VERIFY_ARE_EQUAL(0u, snapshot.enginePaints.at(2));
+
+        const auto text = PerformanceCounters::Format(snapshot);
+        Log::Comment(text.c_str());
+        VERIFY_ARE_NOT_EQUAL(std::wstring::npos, text.find(L"EnginePaintMicroseconds[0]: 150\n"));
+        VERIFY_ARE_NOT_EQUAL(std::wstring::npos, text.find(L"EnginePaints[1]: 1\n"));
+        VERIFY_ARE_EQUAL(std::wstring::npos, text.find(L"EnginePaints[2]"));
+    }
+
+    TEST_METHOD(TestFormat)
+    {
+        PerformanceCounters counters;
+        const auto before = counters.Capture();
+        counters.Add(PerformanceCounter::FramesPainted, 3);
+        const auto after = counters.Capture();
+
+        const auto text = PerformanceCounters::Format(after, &before);
+        Log::Comment(text.c_str());
+        VERIFY_ARE_NOT_EQUAL(std::wstring::npos, text.find(L"FramesPainted: "));
+        VERIFY_ARE_NOT_EQUAL(std::wstring::npos, text.find(L"(+3, "));
+        VERIFY_ARE_EQUAL(static_cast<size_t>(PerformanceCounter::Count), static_cast<size_t>(std::count(text.begin(), text.end(), L'\n')));
+    }
+};